@@ -0,0 +1,1287 @@
+#ifndef ART_MAP_HPP
+# define ART_MAP_HPP
+
+# include <memory>
+# include <string>
+# include <cstring>
+# include <limits>
+# include <new>
+# include <stdexcept>
+# include "utils.hpp"
+# include "iterator.hpp"
+# ifdef __SSE2__
+#  include <emmintrin.h>
+# endif
+
+namespace ft
+{
+	///----------------///
+	/// ART KEY TRAITS ///
+	///----------------///
+
+	//Binary-comparable form of a key : comparing two encoded keys byte by byte (as unsigned char, a key going
+	//before the longer keys it is a prefix of) orders them like the keys themselves.
+	struct art_key
+	{
+		const unsigned char * data;
+		std::size_t size;
+		unsigned char buffer[sizeof(unsigned long long)]; //storage of the keys which are not binary-comparable as they are
+
+		art_key() : data(buffer), size(0) {}
+
+		private:
+			//A copy would point to the buffer of the original
+			art_key(const art_key&);
+			art_key& operator=(const art_key&);
+	};
+
+	//Encodes a Key into an art_key. The default implementation handles integral types : big-endian bytes,
+	//with the sign bit flipped for signed types so that negative values go first. Specialize it for any other key type.
+	template <class Key>
+	struct art_key_traits
+	{
+		static void encode(const Key& k, art_key& out)
+		{
+			unsigned long long u = static_cast<unsigned long long>(k);
+			if (std::numeric_limits<Key>::is_signed)
+				u ^= 1ULL << (8 * sizeof(Key) - 1);
+			for (std::size_t i = 0; i < sizeof(Key); i++)
+				out.buffer[i] = static_cast<unsigned char>(u >> (8 * (sizeof(Key) - 1 - i)));
+			out.data = out.buffer;
+			out.size = sizeof(Key);
+		}
+	};
+
+	//Strings are compared byte by byte already : the key is used in place
+	template <>
+	struct art_key_traits<std::string>
+	{
+		static void encode(const std::string& k, art_key& out)
+		{
+			out.data = reinterpret_cast<const unsigned char *>(k.data());
+			out.size = k.size();
+		}
+	};
+
+	///-----------///
+	/// ART NODES ///
+	///-----------///
+
+	enum art_node_type { ART_LEAF, ART_NODE4, ART_NODE16, ART_NODE48, ART_NODE256 };
+
+	struct art_node
+	{
+		unsigned char type;
+	};
+
+	//Links of the list of leaves, in key order
+	struct art_list_node
+	{
+		art_list_node * prev;
+		art_list_node * next;
+	};
+
+	template <class Value>
+	struct art_leaf : public art_node, public art_list_node
+	{
+		typedef Value value_type;
+
+		Value value;
+
+		art_leaf(const Value& v) : value(v)
+		{
+			type = ART_LEAF;
+		}
+	};
+
+	//Header of the inner nodes. The prefix is the compressed path of bytes shared by every key below the node.
+	//Only its first art_max_prefix bytes are stored : longer prefixes are read from a leaf when they are needed.
+	//terminal is the leaf whose key ends at this node, when a key is a prefix of others (strings).
+	static const std::size_t art_max_prefix = 10;
+
+	struct art_inner : public art_node
+	{
+		unsigned short count;
+		unsigned char prefix[art_max_prefix];
+		std::size_t prefix_len;
+		art_node * terminal;
+	};
+
+	//Up to 4 and 16 children, with their bytes sorted
+	struct art_node4 : public art_inner
+	{
+		unsigned char keys[4];
+		art_node * children[4];
+	};
+
+	struct art_node16 : public art_inner
+	{
+		unsigned char keys[16];
+		art_node * children[16];
+	};
+
+	//Up to 48 children, index[byte] is the position of the child of this byte in children plus one, 0 if there is none
+	struct art_node48 : public art_inner
+	{
+		unsigned char index[256];
+		art_node * children[48];
+	};
+
+	struct art_node256 : public art_inner
+	{
+		art_node * children[256];
+	};
+
+	///------------------///
+	/// ART MAP ITERATOR ///
+	///------------------///
+
+	//Bidirectional iterator on the leaves of an art_map, which are linked in key order
+	template <class Leaf, bool is_const>
+	class art_map_iterator
+	{
+		public:
+			typedef typename Leaf::value_type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef ft::bidirectional_iterator_tag iterator_category;
+			typedef typename choose<is_const, const value_type &, value_type &>::type reference;
+			typedef typename choose<is_const, const value_type *, value_type *>::type pointer;
+
+			art_map_iterator(art_list_node * p = 0) : _ptr(p) {}
+
+			reference operator*() const
+			{
+				return static_cast<Leaf *>(_ptr)->value;
+			}
+
+			pointer operator->() const
+			{
+				return &(static_cast<Leaf *>(_ptr)->value);
+			}
+
+			art_map_iterator& operator++()
+			{
+				_ptr = _ptr->next;
+				return *this;
+			}
+
+			art_map_iterator operator++(int)
+			{
+				art_map_iterator cpy(*this);
+				_ptr = _ptr->next;
+				return cpy;
+			}
+
+			art_map_iterator& operator--()
+			{
+				_ptr = _ptr->prev;
+				return *this;
+			}
+
+			art_map_iterator operator--(int)
+			{
+				art_map_iterator cpy(*this);
+				_ptr = _ptr->prev;
+				return cpy;
+			}
+
+			//Convert to constant iterator
+			operator art_map_iterator<Leaf, true> () const
+			{
+				return art_map_iterator<Leaf, true>(_ptr);
+			}
+
+			art_list_node * base() const
+			{
+				return _ptr;
+			}
+
+		private:
+			art_list_node * _ptr;
+	};
+
+	template <class Leaf, bool B_L, bool B_R>
+	bool operator==(const art_map_iterator<Leaf, B_L> & lhs, const art_map_iterator<Leaf, B_R> & rhs)
+	{
+		return lhs.base() == rhs.base();
+	}
+
+	template <class Leaf, bool B_L, bool B_R>
+	bool operator!=(const art_map_iterator<Leaf, B_L> & lhs, const art_map_iterator<Leaf, B_R> & rhs)
+	{
+		return lhs.base() != rhs.base();
+	}
+
+	///---------///
+	/// ART MAP ///
+	///---------///
+
+	//Ordered map on an adaptive radix tree : the keys are encoded as bytes (see art_key_traits) and each inner node
+	//branches on one byte, so a lookup costs one node per distinct key byte instead of log2(n) comparisons.
+	//Inner nodes grow from 4 to 16, 48 and 256 children as needed, and chains of single-child nodes are compressed
+	//into prefixes. The keys are ordered by their encoding, which is the natural order for integers and strings.
+	template < class Key, class T, class Alloc = std::allocator<ft::pair<const Key, T> > >
+	class art_map
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef Key key_type;
+			typedef T mapped_type;
+			typedef ft::pair<const key_type, mapped_type> value_type;
+			typedef art_key_traits<Key> key_traits;
+			typedef Alloc allocator_type;
+			typedef std::size_t size_type;
+			typedef std::ptrdiff_t difference_type;
+
+		private:
+			typedef art_node node;
+			typedef art_inner inner;
+			typedef art_node4 node4;
+			typedef art_node16 node16;
+			typedef art_node48 node48;
+			typedef art_node256 node256;
+			typedef art_list_node list_node;
+			typedef art_leaf<value_type> leaf;
+
+		public:
+			typedef art_map_iterator<leaf, false> iterator;
+			typedef art_map_iterator<leaf, true> const_iterator;
+			typedef ft::reverse_iterator<iterator> reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			//Empty constructor
+			explicit art_map (const allocator_type& alloc = allocator_type()) : _root(NULL), _size(0), _alloc(alloc)
+			{
+				_head.prev = &_head;
+				_head.next = &_head;
+			}
+
+			//Range constructor
+			template <class InputIterator>
+			art_map (InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+				: _root(NULL), _size(0), _alloc(alloc)
+			{
+				_head.prev = &_head;
+				_head.next = &_head;
+				insert(first, last);
+			}
+
+			//Copy constructor
+			art_map (const art_map& x) : _root(NULL), _size(0), _alloc(x._alloc)
+			{
+				_head.prev = &_head;
+				_head.next = &_head;
+				insert(x.begin(), x.end());
+			}
+
+			~art_map()
+			{
+				clear();
+			}
+
+			art_map& operator= (const art_map& x)
+			{
+				if (&x == this)
+					return (*this);
+				clear();
+				insert(x.begin(), x.end());
+				return *this;
+			}
+
+			/// ITERATORS ///
+
+			iterator begin()
+			{
+				return iterator(_head.next);
+			}
+
+			const_iterator begin() const
+			{
+				return const_iterator(_head.next);
+			}
+
+			iterator end()
+			{
+				return iterator(&_head);
+			}
+
+			const_iterator end() const
+			{
+				return const_iterator(const_cast<list_node *>(&_head));
+			}
+
+			reverse_iterator rbegin()
+			{
+				return reverse_iterator(end());
+			}
+
+			const_reverse_iterator rbegin() const
+			{
+				return const_reverse_iterator(end());
+			}
+
+			reverse_iterator rend()
+			{
+				return reverse_iterator(begin());
+			}
+
+			const_reverse_iterator rend() const
+			{
+				return const_reverse_iterator(begin());
+			}
+
+			/// CAPACITY ///
+
+			bool empty() const
+			{
+				return _size == 0;
+			}
+
+			size_type size() const
+			{
+				return _size;
+			}
+
+			size_type max_size() const
+			{
+				typename Alloc::template rebind<leaf>::other a(_alloc);
+				return a.max_size();
+			}
+
+			/// ELEMENT ACCESS ///
+
+			mapped_type& operator[] (const key_type& k)
+			{
+				return (*((insert(ft::make_pair(k, mapped_type()))).first)).second;
+			}
+
+			mapped_type& at (const key_type& k)
+			{
+				iterator it_found = find(k);
+				if (it_found == end())
+					throw std::out_of_range("art_map::at");
+				return it_found->second;
+			}
+
+			const mapped_type& at (const key_type& k) const
+			{
+				const_iterator it_found = find(k);
+				if (it_found == end())
+					throw std::out_of_range("art_map::at");
+				return it_found->second;
+			}
+
+			/// MODIFIERS ///
+
+			pair<iterator,bool> insert (const value_type& val)
+			{
+				bool inserted;
+				leaf * l = insert_leaf(val, inserted);
+				return ft::make_pair<iterator, bool>(iterator(l), inserted);
+			}
+
+			//The position hint is not used
+			iterator insert (iterator position, const value_type& val)
+			{
+				(void)position;
+				return insert(val).first;
+			}
+
+			template <class InputIterator>
+			void insert (InputIterator first, InputIterator last, typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+			{
+				while (first != last)
+					insert(*(first++));
+			}
+
+			void erase (iterator position)
+			{
+				erase(position->first);
+			}
+
+			size_type erase (const key_type& k)
+			{
+				art_key key;
+				key_traits::encode(k, key);
+				return erase_key(key) ? 1 : 0;
+			}
+
+			void erase (iterator first, iterator last)
+			{
+				while (first != last)
+					erase(first++);
+			}
+
+			void swap (art_map& x)
+			{
+				std::swap(_root, x._root);
+				std::swap(_size, x._size);
+				std::swap(_alloc, x._alloc);
+				std::swap(_head, x._head);
+				relink_head();
+				x.relink_head();
+			}
+
+			void clear()
+			{
+				destroy(_root);
+				_root = NULL;
+				_size = 0;
+				_head.prev = &_head;
+				_head.next = &_head;
+			}
+
+			/// LOOKUP ///
+
+			iterator find (const key_type& k)
+			{
+				leaf * l = find_leaf(k);
+				return l ? iterator(l) : end();
+			}
+
+			const_iterator find (const key_type& k) const
+			{
+				leaf * l = find_leaf(k);
+				return l ? const_iterator(l) : end();
+			}
+
+			size_type count (const key_type& k) const
+			{
+				return find_leaf(k) ? 1 : 0;
+			}
+
+			//Returns an iterator to the first element whose key is not less than k
+			iterator lower_bound (const key_type& k)
+			{
+				leaf * l = lower_bound_leaf(k);
+				return l ? iterator(l) : end();
+			}
+
+			const_iterator lower_bound (const key_type& k) const
+			{
+				leaf * l = lower_bound_leaf(k);
+				return l ? const_iterator(l) : end();
+			}
+
+			//Returns an iterator to the first element whose key is greater than k
+			iterator upper_bound (const key_type& k)
+			{
+				return iterator(upper_bound_node(k));
+			}
+
+			const_iterator upper_bound (const key_type& k) const
+			{
+				return const_iterator(upper_bound_node(k));
+			}
+
+			pair<const_iterator,const_iterator> equal_range (const key_type& k) const
+			{
+				return ft::make_pair(lower_bound(k), upper_bound(k));
+			}
+
+			pair<iterator,iterator> equal_range (const key_type& k)
+			{
+				return ft::make_pair(lower_bound(k), upper_bound(k));
+			}
+
+			allocator_type get_allocator() const
+			{
+				return _alloc;
+			}
+
+		private:
+			node * _root;
+			list_node _head; //sentinel of the list of leaves : _head.next is the first leaf, _head.prev the last one
+			size_type _size;
+			allocator_type _alloc;
+
+			/// KEYS ///
+
+			static void encode(const leaf * l, art_key& out)
+			{
+				key_traits::encode(l->value.first, out);
+			}
+
+			//Negative if the key of l goes before key, positive if it goes after, 0 if they are equal
+			static int compare_key(const leaf * l, const art_key& key)
+			{
+				art_key lk;
+				encode(l, lk);
+				std::size_t len = lk.size < key.size ? lk.size : key.size;
+				int c = std::memcmp(lk.data, key.data, len);
+				if (c != 0)
+					return c;
+				return (lk.size > key.size) - (lk.size < key.size);
+			}
+
+			static leaf * terminal(inner * n)
+			{
+				return static_cast<leaf *>(n->terminal);
+			}
+
+			/// LEAVES ///
+
+			//Allocates a leaf holding a copy of val, not linked yet. If the copy throws, the leaf is freed.
+			leaf * new_leaf(const value_type& val)
+			{
+				typename Alloc::template rebind<leaf>::other a(_alloc);
+				leaf * l = a.allocate(1);
+				try
+				{
+					::new (static_cast<void *>(l)) leaf(val); //built in place : copying a leaf would read its unset links
+				}
+				catch (...)
+				{
+					a.deallocate(l, 1);
+					throw;
+				}
+				l->prev = NULL;
+				l->next = NULL;
+				_size++;
+				return l;
+			}
+
+			void delete_leaf(leaf * l)
+			{
+				typename Alloc::template rebind<leaf>::other a(_alloc);
+				l->prev->next = l->next;
+				l->next->prev = l->prev;
+				a.destroy(l);
+				a.deallocate(l, 1);
+				_size--;
+			}
+
+			//Links l in the list of leaves, right before next
+			static void link_before(list_node * next, leaf * l)
+			{
+				l->next = next;
+				l->prev = next->prev;
+				next->prev->next = l;
+				next->prev = l;
+			}
+
+			void relink_head()
+			{
+				if (_size == 0)
+				{
+					_head.prev = &_head;
+					_head.next = &_head;
+					return;
+				}
+				_head.next->prev = &_head;
+				_head.prev->next = &_head;
+			}
+
+			static leaf * min_leaf(node * n)
+			{
+				while (n->type != ART_LEAF)
+				{
+					inner * in = static_cast<inner *>(n);
+					if (terminal(in) != NULL)
+						return terminal(in);
+					n = child_after(in, -1);
+				}
+				return static_cast<leaf *>(n);
+			}
+
+			static leaf * max_leaf(node * n)
+			{
+				while (n->type != ART_LEAF)
+				{
+					inner * in = static_cast<inner *>(n);
+					node * last = child_before(in, 256);
+					if (last == NULL)
+						return terminal(in);
+					n = last;
+				}
+				return static_cast<leaf *>(n);
+			}
+
+			/// INNER NODES ///
+
+			template <class N>
+			N * new_inner(unsigned char type)
+			{
+				typename Alloc::template rebind<N>::other a(_alloc);
+				N * n = a.allocate(1);
+				std::memset(static_cast<void *>(n), 0, sizeof(N));
+				n->type = type;
+				return n;
+			}
+
+			template <class N>
+			void delete_inner(N * n)
+			{
+				typename Alloc::template rebind<N>::other a(_alloc);
+				a.deallocate(n, 1);
+			}
+
+			void delete_inner(inner * n)
+			{
+				switch (n->type)
+				{
+					case ART_NODE4: delete_inner(static_cast<node4 *>(n)); break;
+					case ART_NODE16: delete_inner(static_cast<node16 *>(n)); break;
+					case ART_NODE48: delete_inner(static_cast<node48 *>(n)); break;
+					default: delete_inner(static_cast<node256 *>(n)); break;
+				}
+			}
+
+			//Destroy the leaves and nodes of the subtree of n
+			void destroy(node * n)
+			{
+				if (n == NULL)
+					return;
+				if (n->type == ART_LEAF)
+				{
+					delete_leaf(static_cast<leaf *>(n));
+					return;
+				}
+				inner * in = static_cast<inner *>(n);
+				destroy(in->terminal);
+				switch (in->type)
+				{
+					case ART_NODE4: destroy_children(static_cast<node4 *>(in)->children, in->count); break;
+					case ART_NODE16: destroy_children(static_cast<node16 *>(in)->children, in->count); break;
+					case ART_NODE48: destroy_children(static_cast<node48 *>(in)->children, 48); break;
+					default: destroy_children(static_cast<node256 *>(in)->children, 256); break;
+				}
+				delete_inner(in);
+			}
+
+			void destroy_children(node ** children, unsigned count)
+			{
+				for (unsigned i = 0; i < count; i++)
+					destroy(children[i]);
+			}
+
+			static void copy_header(inner * dst, const inner * src)
+			{
+				dst->count = src->count;
+				std::memcpy(dst->prefix, src->prefix, art_max_prefix);
+				dst->prefix_len = src->prefix_len;
+				dst->terminal = src->terminal;
+			}
+
+			//Slot of the child of n for byte b, NULL if there is none
+			static node ** find_child(inner * n, unsigned char b)
+			{
+				switch (n->type)
+				{
+					case ART_NODE4:
+					{
+						node4 * p = static_cast<node4 *>(n);
+						for (unsigned i = 0; i < p->count; i++)
+							if (p->keys[i] == b)
+								return &p->children[i];
+						return NULL;
+					}
+					case ART_NODE16:
+					{
+						node16 * p = static_cast<node16 *>(n);
+# ifdef __SSE2__
+						//compare b with the 16 keys at once
+						__m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)), _mm_loadu_si128(reinterpret_cast<const __m128i *>(p->keys)));
+						unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << p->count) - 1);
+						if (mask != 0)
+							return &p->children[__builtin_ctz(mask)];
+# else
+						for (unsigned i = 0; i < p->count; i++)
+							if (p->keys[i] == b)
+								return &p->children[i];
+# endif
+						return NULL;
+					}
+					case ART_NODE48:
+					{
+						node48 * p = static_cast<node48 *>(n);
+						if (p->index[b] == 0)
+							return NULL;
+						return &p->children[p->index[b] - 1];
+					}
+					default:
+					{
+						node256 * p = static_cast<node256 *>(n);
+						if (p->children[b] == NULL)
+							return NULL;
+						return &p->children[b];
+					}
+				}
+			}
+
+			template <class N>
+			static node * sorted_child_after(N * p, int b)
+			{
+				for (unsigned i = 0; i < p->count; i++)
+					if (p->keys[i] > b)
+						return p->children[i];
+				return NULL;
+			}
+
+			template <class N>
+			static node * sorted_child_before(N * p, int b)
+			{
+				for (unsigned i = p->count; i > 0; i--)
+					if (p->keys[i - 1] < b)
+						return p->children[i - 1];
+				return NULL;
+			}
+
+			//Child of n with the smallest byte greater than b (-1 for the first child), NULL if there is none
+			static node * child_after(inner * n, int b)
+			{
+				switch (n->type)
+				{
+					case ART_NODE4: return sorted_child_after(static_cast<node4 *>(n), b);
+					case ART_NODE16: return sorted_child_after(static_cast<node16 *>(n), b);
+					case ART_NODE48:
+					{
+						node48 * p = static_cast<node48 *>(n);
+						for (int k = b + 1; k < 256; k++)
+							if (p->index[k] != 0)
+								return p->children[p->index[k] - 1];
+						return NULL;
+					}
+					default:
+					{
+						node256 * p = static_cast<node256 *>(n);
+						for (int k = b + 1; k < 256; k++)
+							if (p->children[k] != NULL)
+								return p->children[k];
+						return NULL;
+					}
+				}
+			}
+
+			//Child of n with the greatest byte less than b (256 for the last child), NULL if there is none
+			static node * child_before(inner * n, int b)
+			{
+				switch (n->type)
+				{
+					case ART_NODE4: return sorted_child_before(static_cast<node4 *>(n), b);
+					case ART_NODE16: return sorted_child_before(static_cast<node16 *>(n), b);
+					case ART_NODE48:
+					{
+						node48 * p = static_cast<node48 *>(n);
+						for (int k = b - 1; k >= 0; k--)
+							if (p->index[k] != 0)
+								return p->children[p->index[k] - 1];
+						return NULL;
+					}
+					default:
+					{
+						node256 * p = static_cast<node256 *>(n);
+						for (int k = b - 1; k >= 0; k--)
+							if (p->children[k] != NULL)
+								return p->children[k];
+						return NULL;
+					}
+				}
+			}
+
+			template <class N>
+			static void sorted_insert(N * p, unsigned char b, node * child)
+			{
+				unsigned i = p->count;
+				while (i > 0 && p->keys[i - 1] > b)
+				{
+					p->keys[i] = p->keys[i - 1];
+					p->children[i] = p->children[i - 1];
+					i--;
+				}
+				p->keys[i] = b;
+				p->children[i] = child;
+				p->count++;
+			}
+
+			template <class N>
+			static void sorted_erase(N * p, unsigned char b)
+			{
+				unsigned i = 0;
+				while (p->keys[i] != b)
+					i++;
+				for (; i + 1 < p->count; i++)
+				{
+					p->keys[i] = p->keys[i + 1];
+					p->children[i] = p->children[i + 1];
+				}
+				p->count--;
+			}
+
+			//Adds child under byte b to the node n stored in *ref, which is replaced by a bigger node when it is full
+			void add_child(node ** ref, inner * n, unsigned char b, node * child)
+			{
+				switch (n->type)
+				{
+					case ART_NODE4:
+					{
+						node4 * p = static_cast<node4 *>(n);
+						if (p->count < 4)
+							return sorted_insert(p, b, child);
+						node16 * bigger = new_inner<node16>(ART_NODE16);
+						copy_header(bigger, p);
+						std::memcpy(bigger->keys, p->keys, sizeof(p->keys));
+						std::memcpy(bigger->children, p->children, sizeof(p->children));
+						delete_inner(p);
+						*ref = bigger;
+						return sorted_insert(bigger, b, child);
+					}
+					case ART_NODE16:
+					{
+						node16 * p = static_cast<node16 *>(n);
+						if (p->count < 16)
+							return sorted_insert(p, b, child);
+						node48 * bigger = new_inner<node48>(ART_NODE48);
+						copy_header(bigger, p);
+						for (unsigned i = 0; i < 16; i++)
+						{
+							bigger->index[p->keys[i]] = static_cast<unsigned char>(i + 1);
+							bigger->children[i] = p->children[i];
+						}
+						delete_inner(p);
+						*ref = bigger;
+						return add_child(ref, bigger, b, child);
+					}
+					case ART_NODE48:
+					{
+						node48 * p = static_cast<node48 *>(n);
+						if (p->count < 48)
+						{
+							unsigned slot = 0;
+							while (p->children[slot] != NULL)
+								slot++;
+							p->children[slot] = child;
+							p->index[b] = static_cast<unsigned char>(slot + 1);
+							p->count++;
+							return;
+						}
+						node256 * bigger = new_inner<node256>(ART_NODE256);
+						copy_header(bigger, p);
+						for (int k = 0; k < 256; k++)
+							if (p->index[k] != 0)
+								bigger->children[k] = p->children[p->index[k] - 1];
+						delete_inner(p);
+						*ref = bigger;
+						return add_child(ref, bigger, b, child);
+					}
+					default:
+					{
+						node256 * p = static_cast<node256 *>(n);
+						p->children[b] = child;
+						p->count++;
+					}
+				}
+			}
+
+			//Removes the child of byte b from the node n stored in *ref, then shrinks or collapses n if needed
+			void remove_child(node ** ref, inner * n, unsigned char b)
+			{
+				switch (n->type)
+				{
+					case ART_NODE4: sorted_erase(static_cast<node4 *>(n), b); break;
+					case ART_NODE16: sorted_erase(static_cast<node16 *>(n), b); break;
+					case ART_NODE48:
+					{
+						node48 * p = static_cast<node48 *>(n);
+						p->children[p->index[b] - 1] = NULL;
+						p->index[b] = 0;
+						p->count--;
+						break;
+					}
+					default:
+					{
+						node256 * p = static_cast<node256 *>(n);
+						p->children[b] = NULL;
+						p->count--;
+					}
+				}
+				shrink(ref, n);
+			}
+
+			//Replaces n by a smaller node when it has few children left (with some margin below the growth thresholds),
+			//by its terminal leaf when it has no child, or merges it with its only child
+			void shrink(node ** ref, inner * n)
+			{
+				switch (n->type)
+				{
+					case ART_NODE4:
+					{
+						node4 * p = static_cast<node4 *>(n);
+						if (p->count == 0)
+						{
+							*ref = terminal(p);
+							delete_inner(p);
+						}
+						else if (p->count == 1 && terminal(p) == NULL)
+							collapse(ref, p);
+						return;
+					}
+					case ART_NODE16:
+					{
+						node16 * p = static_cast<node16 *>(n);
+						if (p->count > 3)
+							return;
+						node4 * smaller = new_inner<node4>(ART_NODE4);
+						copy_header(smaller, p);
+						std::memcpy(smaller->keys, p->keys, p->count);
+						std::memcpy(smaller->children, p->children, p->count * sizeof(node *));
+						delete_inner(p);
+						*ref = smaller;
+						return;
+					}
+					case ART_NODE48:
+					{
+						node48 * p = static_cast<node48 *>(n);
+						if (p->count > 12)
+							return;
+						node16 * smaller = new_inner<node16>(ART_NODE16);
+						copy_header(smaller, p);
+						smaller->count = 0;
+						for (int k = 0; k < 256; k++)
+							if (p->index[k] != 0)
+								sorted_insert(smaller, static_cast<unsigned char>(k), p->children[p->index[k] - 1]);
+						delete_inner(p);
+						*ref = smaller;
+						return;
+					}
+					default:
+					{
+						node256 * p = static_cast<node256 *>(n);
+						if (p->count > 36)
+							return;
+						node48 * smaller = new_inner<node48>(ART_NODE48);
+						copy_header(smaller, p);
+						smaller->count = 0;
+						for (int k = 0; k < 256; k++)
+							if (p->children[k] != NULL)
+								add_child(ref, smaller, static_cast<unsigned char>(k), p->children[k]);
+						delete_inner(p);
+						*ref = smaller;
+					}
+				}
+			}
+
+			//Replaces a node with a single child and no terminal leaf by its child, prepending its prefix and byte to the child's prefix
+			void collapse(node ** ref, node4 * n)
+			{
+				node * child = n->children[0];
+				if (child->type != ART_LEAF)
+				{
+					inner * c = static_cast<inner *>(child);
+					unsigned char merged[art_max_prefix];
+					std::size_t len = 0;
+					for (std::size_t i = 0; i < n->prefix_len && len < art_max_prefix; i++)
+						merged[len++] = n->prefix[i];
+					if (len < art_max_prefix)
+						merged[len++] = n->keys[0];
+					for (std::size_t i = 0; i < c->prefix_len && len < art_max_prefix; i++)
+						merged[len++] = c->prefix[i];
+					std::memcpy(c->prefix, merged, len);
+					c->prefix_len += n->prefix_len + 1;
+				}
+				*ref = child;
+				delete_inner(n);
+			}
+
+			//Number of bytes of the prefix of n matching key from depth. Prefixes longer than the stored bytes are read from a leaf.
+			static std::size_t prefix_mismatch(inner * n, const art_key& key, std::size_t depth)
+			{
+				std::size_t max = n->prefix_len < key.size - depth ? n->prefix_len : key.size - depth;
+				std::size_t stored = max < art_max_prefix ? max : art_max_prefix;
+				std::size_t i = 0;
+				for (; i < stored; i++)
+					if (n->prefix[i] != key.data[depth + i])
+						return i;
+				if (i < max)
+				{
+					art_key lk;
+					encode(min_leaf(n), lk);
+					for (; i < max; i++)
+						if (lk.data[depth + i] != key.data[depth + i])
+							return i;
+				}
+				return max;
+			}
+
+			/// OPERATIONS ///
+
+			//Adds the leaf l for key to node n, depth being the length of their common prefix
+			void attach(node4 * n, leaf * l, const art_key& key, std::size_t depth)
+			{
+				if (depth == key.size)
+					n->terminal = l;
+				else
+					sorted_insert(n, key.data[depth], l);
+			}
+
+			//Returns the leaf of the key of val, creating it if there is none
+			leaf * insert_leaf(const value_type& val, bool& inserted)
+			{
+				art_key key;
+				key_traits::encode(val.first, key);
+				node ** ref = &_root;
+				std::size_t depth = 0;
+
+				inserted = true;
+				if (_root == NULL)
+				{
+					leaf * l = new_leaf(val);
+					_root = l;
+					link_before(&_head, l);
+					return l;
+				}
+				while (true)
+				{
+					node * n = *ref;
+					if (n->type == ART_LEAF)
+					{
+						//Replace the leaf by a node branching between it and the new leaf after their common bytes
+						leaf * old = static_cast<leaf *>(n);
+						art_key lk;
+						encode(old, lk);
+						std::size_t p = depth;
+						std::size_t limit = lk.size < key.size ? lk.size : key.size;
+						while (p < limit && lk.data[p] == key.data[p])
+							p++;
+						if (p == lk.size && p == key.size)
+						{
+							inserted = false;
+							return old;
+						}
+						leaf * l = new_leaf(val);
+						node4 * split = new_inner<node4>(ART_NODE4);
+						split->prefix_len = p - depth;
+						std::memcpy(split->prefix, key.data + depth, split->prefix_len < art_max_prefix ? split->prefix_len : art_max_prefix);
+						attach(split, old, lk, p);
+						attach(split, l, key, p);
+						*ref = split;
+						link_before(compare_key(old, key) > 0 ? old : old->next, l);
+						return l;
+					}
+					inner * in = static_cast<inner *>(n);
+					if (in->prefix_len != 0)
+					{
+						std::size_t m = prefix_mismatch(in, key, depth);
+						if (m < in->prefix_len)
+						{
+							//Split the prefix : a new node keeps its first m bytes and branches between n and the new leaf
+							unsigned char old_byte;
+							leaf * l = new_leaf(val);
+							node4 * split = new_inner<node4>(ART_NODE4);
+							split->prefix_len = m;
+							std::memcpy(split->prefix, in->prefix, m < art_max_prefix ? m : art_max_prefix);
+							std::size_t rest = in->prefix_len - m - 1;
+							if (in->prefix_len <= art_max_prefix)
+							{
+								old_byte = in->prefix[m];
+								std::memmove(in->prefix, in->prefix + m + 1, rest);
+							}
+							else
+							{
+								art_key lk;
+								encode(min_leaf(in), lk);
+								old_byte = lk.data[depth + m];
+								std::memcpy(in->prefix, lk.data + depth + m + 1, rest < art_max_prefix ? rest : art_max_prefix);
+							}
+							in->prefix_len = rest;
+							sorted_insert(split, old_byte, in);
+							attach(split, l, key, depth + m);
+							*ref = split;
+							if (depth + m == key.size || key.data[depth + m] < old_byte)
+								link_before(min_leaf(in), l);
+							else
+								link_before(max_leaf(in)->next, l);
+							return l;
+						}
+						depth += in->prefix_len;
+					}
+					if (depth == key.size)
+					{
+						if (terminal(in) != NULL)
+						{
+							inserted = false;
+							return terminal(in);
+						}
+						leaf * l = new_leaf(val);
+						link_before(min_leaf(in), l);
+						in->terminal = l;
+						return l;
+					}
+					unsigned char b = key.data[depth];
+					node ** child = find_child(in, b);
+					if (child == NULL)
+					{
+						leaf * l = new_leaf(val);
+						node * next = child_after(in, b);
+						if (next != NULL)
+							link_before(min_leaf(next), l);
+						else
+						{
+							node * prev = child_before(in, b);
+							link_before(prev != NULL ? max_leaf(prev)->next : terminal(in)->next, l);
+						}
+						add_child(ref, in, b, l);
+						return l;
+					}
+					ref = child;
+					depth++;
+				}
+			}
+
+			//The prefixes are skipped without reading the bytes which are not stored : the leaf reached is compared with the whole key
+			leaf * find_leaf(const key_type& k) const
+			{
+				art_key key;
+				key_traits::encode(k, key);
+				node * n = _root;
+				std::size_t depth = 0;
+				while (n != NULL)
+				{
+					if (n->type == ART_LEAF)
+						return compare_key(static_cast<leaf *>(n), key) == 0 ? static_cast<leaf *>(n) : NULL;
+					inner * in = static_cast<inner *>(n);
+					if (in->prefix_len != 0)
+					{
+						if (key.size - depth < in->prefix_len)
+							return NULL;
+						if (std::memcmp(in->prefix, key.data + depth, in->prefix_len < art_max_prefix ? in->prefix_len : art_max_prefix) != 0)
+							return NULL;
+						depth += in->prefix_len;
+					}
+					if (depth == key.size)
+					{
+						n = terminal(in);
+						continue;
+					}
+					node ** child = find_child(in, key.data[depth]);
+					if (child == NULL)
+						return NULL;
+					n = *child;
+					depth++;
+				}
+				return NULL;
+			}
+
+			bool erase_key(const art_key& key)
+			{
+				node ** ref = &_root;
+				std::size_t depth = 0;
+				while (*ref != NULL)
+				{
+					node * n = *ref;
+					if (n->type == ART_LEAF)
+					{
+						//only reached when the tree is a single leaf
+						if (compare_key(static_cast<leaf *>(n), key) != 0)
+							return false;
+						*ref = NULL;
+						delete_leaf(static_cast<leaf *>(n));
+						return true;
+					}
+					inner * in = static_cast<inner *>(n);
+					depth += in->prefix_len;
+					if (depth > key.size)
+						return false;
+					if (depth == key.size)
+					{
+						leaf * t = terminal(in);
+						if (t == NULL || compare_key(t, key) != 0)
+							return false;
+						in->terminal = NULL;
+						delete_leaf(t);
+						shrink(ref, in);
+						return true;
+					}
+					unsigned char b = key.data[depth];
+					node ** child = find_child(in, b);
+					if (child == NULL)
+						return false;
+					if ((*child)->type == ART_LEAF)
+					{
+						leaf * l = static_cast<leaf *>(*child);
+						if (compare_key(l, key) != 0)
+							return false;
+						remove_child(ref, in, b);
+						delete_leaf(l);
+						return true;
+					}
+					ref = child;
+					depth++;
+				}
+				return false;
+			}
+
+			//First leaf of the subtree of n whose key is not less than key, NULL if they are all less
+			static leaf * seek(node * n, const art_key& key, std::size_t depth)
+			{
+				if (n->type == ART_LEAF)
+					return compare_key(static_cast<leaf *>(n), key) >= 0 ? static_cast<leaf *>(n) : NULL;
+				inner * in = static_cast<inner *>(n);
+				if (in->prefix_len != 0)
+				{
+					art_key lk;
+					const unsigned char * prefix = in->prefix;
+					if (in->prefix_len > art_max_prefix)
+					{
+						encode(min_leaf(in), lk);
+						prefix = lk.data + depth;
+					}
+					std::size_t len = in->prefix_len < key.size - depth ? in->prefix_len : key.size - depth;
+					for (std::size_t i = 0; i < len; i++)
+						if (prefix[i] != key.data[depth + i])
+							return prefix[i] > key.data[depth + i] ? min_leaf(in) : NULL;
+					//when the key ends inside the prefix, all the keys of the subtree are greater
+					if (len < in->prefix_len)
+						return min_leaf(in);
+					depth += in->prefix_len;
+				}
+				if (depth == key.size)
+					return min_leaf(in);
+				unsigned char b = key.data[depth];
+				node ** child = find_child(in, b);
+				if (child != NULL)
+				{
+					leaf * l = seek(*child, key, depth + 1);
+					if (l != NULL)
+						return l;
+				}
+				node * next = child_after(in, b);
+				return next != NULL ? min_leaf(next) : NULL;
+			}
+
+			leaf * lower_bound_leaf(const key_type& k) const
+			{
+				if (_root == NULL)
+					return NULL;
+				art_key key;
+				key_traits::encode(k, key);
+				return seek(_root, key, 0);
+			}
+
+			list_node * upper_bound_node(const key_type& k) const
+			{
+				leaf * l = lower_bound_leaf(k);
+				if (l == NULL)
+					return const_cast<list_node *>(&_head);
+				art_key key;
+				key_traits::encode(k, key);
+				return compare_key(l, key) == 0 ? l->next : l;
+			}
+	};
+
+	template < class Key, class T, class Alloc >
+	void swap (art_map<Key, T, Alloc>& x, art_map<Key, T, Alloc>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
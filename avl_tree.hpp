@@ -18,61 +18,134 @@
 
 namespace ft
 {
-	template <class T>
-	class TreeNode 
+	//Storage for the data that an augmentation policy attaches to every node (see AVLTree).
+	//The void specialization is empty so that nodes of non-augmented trees do not grow.
+	template <class Data>
+	struct tree_node_augment
+	{
+		Data aug;
+	};
+
+	template <>
+	struct tree_node_augment<void> {};
+
+	//Links of a tree node. The past-the-end sentinel of a tree is made of links only, without any value.
+	template <class Node>
+	struct tree_node_links
+	{
+		Node * left;
+		Node * right;
+		Node * parent;
+
+		tree_node_links() : left(NULL), right(NULL), parent(NULL) {}
+	};
+
+	template <class T, class Aug = void>
+	class TreeNode : public tree_node_augment<Aug>, public tree_node_links<TreeNode<T, Aug> >
 	{
 		public:
 			typedef T value_type;
+			typedef tree_node_links<TreeNode> links_type;
 			
 			T value;
 			int height;
-			TreeNode * left;
-			TreeNode * right;
-			TreeNode * parent;
 
-			TreeNode() : value(), height(0), left(NULL), right(NULL), parent(NULL)  {}
+			TreeNode() : value(), height(0) {}
+
+			TreeNode(const T& v) : value(v), height(0) {}
+
+# if FT_MOVE_SEMANTICS
+			//Constructs the value from args
+			template <class... Args>
+			explicit TreeNode(Args&&... args) : value(std::forward<Args>(args)...), height(0) {}
+# endif
+	};
+
+	//Default augmentation policy of AVLTree : the nodes carry no additional data.
+	//Policies inherit from it and only redefine what they use.
+	struct no_augmentation
+	{
+		typedef void data_type;
+		typedef char cache_type;
+
+		//Called once on a new node, before it is linked into the tree
+		template <class Node>
+		static void init(Node *) {}
+
+		template <class Node>
+		static void update(Node *) {}
+
+		//Key cache : a policy may keep in each node a summary of its key (cache_type) which orders like the key itself.
+		//value_cache and key_cache compute the summary of a searched value or key once per search, then
+		//compare_cached(summary, node) returns the order of the searched key relative to the node,
+		//or 0 when the summaries are equal and the full comparison is needed.
+		template <class V>
+		static cache_type value_cache(const V&) { return 0; }
+
+		template <class K>
+		static cache_type key_cache(const K&) { return 0; }
 
-			TreeNode(T v) : value(v), height(0), left(NULL), right(NULL), parent(NULL) {}
+		template <class Node>
+		static int compare_cached(cache_type, const Node *) { return 0; }
 	};
 
 	//AVL Tree is a balanced binary search tree. 
 	//For each node, the height difference between left and right subtrees (balance factor) cannot be more than one
 	//It ensures that lookup, insertion, and deletion all take O(log n)
 	//T : type of the value contained by each node (ex: the type pair)
-	template <class T, class Compare = std::less<T>, class Alloc = std::allocator<TreeNode<T> > >
+	//Augment : policy storing Augment::data_type in each node. Augment::init(node) sets it up on a new node,
+	//Augment::update(node) recomputes it from the node's value and its children, and is called whenever the subtree
+	//of a node changes (insertion, deletion and rotations). It can also provide a key cache (see no_augmentation).
+	template <class T, class Compare = std::less<T>, class Alloc = std::allocator<TreeNode<T> >, class Augment = no_augmentation>
 	class AVLTree 
 	{
 		public:
-			typedef TreeNode<T> node_type;
-			typedef Alloc allocator_type;
+			typedef TreeNode<T, typename Augment::data_type> node_type;
+			typedef typename Alloc::template rebind<node_type>::other allocator_type;
 			typedef std::size_t size_type;
 			typedef Compare value_compare; //comparison on the first element (key) of the pair only. True if first key inferior.
+			typedef typename Augment::cache_type cache_type;
+
+			typedef typename node_type::links_type links_type;
 
 			node_type* root;
-			//a dummy node used when end() is called in map. Its left child is root so that the -- iterator operator can find the last node
-			node_type* dummy_past_end; 
+			//the past-the-end sentinel used by the map iterators. Its left child is the last node so that the -- iterator operator can find it.
+			//It is allocated before the first node is linked, so an empty tree does not allocate anything, and it is swapped
+			//with the nodes so that the iterators of the elements still reach the end of their new tree.
+			links_type * dummy_past_end; 
 			
-			AVLTree(const allocator_type& alloc = allocator_type()) : _alloc(alloc), _comp(value_compare())
+			AVLTree(const allocator_type& alloc = allocator_type()) : root(NULL), dummy_past_end(NULL), _alloc(alloc), _comp(value_compare()), _block(NULL), _block_size(0), _block_live(0) {}
+
+			AVLTree(const value_compare &comp, const allocator_type& alloc = allocator_type()) : root(NULL), dummy_past_end(NULL), _alloc(alloc), _comp(comp), _block(NULL), _block_size(0), _block_live(0) {}
+
+			~AVLTree()
 			{
-				root = NULL;
-				dummy_past_end = _alloc.allocate(1);
-				_alloc.construct(dummy_past_end, T());
-				dummy_past_end->left = root;
+				clear(root);
+				if (dummy_past_end != NULL)
+				{
+					links_allocator_type alloc(_alloc);
+					alloc.destroy(dummy_past_end);
+					alloc.deallocate(dummy_past_end, 1);
+				}
 			}
 
-			AVLTree(const value_compare &comp, const allocator_type& alloc = allocator_type()) : _alloc(alloc), _comp(comp)
+			//Allocates the past-the-end sentinel if the tree has none yet. Called before a node is linked, so that a failed
+			//allocation leaves the tree unchanged.
+			void reserve_past_end()
 			{
-				root = NULL;
-				dummy_past_end = _alloc.allocate(1);
-				_alloc.construct(dummy_past_end, T());
-				dummy_past_end->left = root;
+				if (dummy_past_end != NULL)
+					return;
+				links_allocator_type alloc(_alloc);
+				links_type * sentinel = alloc.allocate(1);
+				alloc.construct(sentinel, links_type());
+				dummy_past_end = sentinel;
 			}
 
-			~AVLTree()
+			//Links the past-the-end sentinel to the last node
+			void update_past_end()
 			{
-				clear(root);
-				_alloc.destroy(dummy_past_end);
-				_alloc.deallocate(dummy_past_end, 1);
+				if (dummy_past_end != NULL)
+					dummy_past_end->left = max_value_node(root);
 			}
 
 			bool tree_is_empty() const
@@ -97,6 +170,7 @@ namespace ft
 				int lheight = height(r->left);
 				int rheight = height(r->right);
 				r->height = std::max(lheight, rheight) + 1;
+				Augment::update(r);
 			}
 
 			//update the height of all the direct predecessors of r
@@ -104,7 +178,7 @@ namespace ft
 			{
 				while (r->parent)
 				{
-					update_height(r->parent->height);
+					update_height(r->parent);
 					r = r->parent;
 				}
 			}
@@ -161,24 +235,75 @@ namespace ft
 				return y;
 			}
 
-			//Allocate and construct a node with the given value, then insert it into the tree
-			void create_and_insert(T value, bool * inserted, node_type ** inserted_or_found)
+			//Allocate and construct an unlinked node with the given value
+			node_type * create_node(const T& value)
 			{
 				node_type* new_node = _alloc.allocate(1);
-				_alloc.construct(new_node, value);
-				root = this->insert(root, new_node, inserted, inserted_or_found);
-				if (dummy_past_end->left == NULL || _comp(dummy_past_end->left->value, value))
+				try
+				{
+					_alloc.construct(new_node, value);
+				}
+				catch (...)
+				{
+					_alloc.deallocate(new_node, 1);
+					throw;
+				}
+				Augment::init(new_node);
+				return new_node;
+			}
+
+# if FT_MOVE_SEMANTICS
+			//Allocate an unlinked node and construct its value from args
+			template <class... Args>
+			node_type * emplace_node(Args&&... args)
+			{
+				node_type* new_node = _alloc.allocate(1);
+				try
+				{
+					std::allocator_traits<allocator_type>::construct(_alloc, new_node, std::forward<Args>(args)...);
+				}
+				catch (...)
+				{
+					_alloc.deallocate(new_node, 1);
+					throw;
+				}
+				Augment::init(new_node);
+				return new_node;
+			}
+# endif
+
+			//Allocate and construct a node with the given value, then insert it into the tree
+			void create_and_insert(const T& value, bool * inserted, node_type ** inserted_or_found)
+			{
+				insert_node(create_node(value), inserted, inserted_or_found);
+			}
+
+			//Insert the unlinked new_node into the tree, or destroy it if its key is already present
+			void insert_node(node_type * new_node, bool * inserted, node_type ** inserted_or_found)
+			{
+				try
+				{
+					reserve_past_end();
+				}
+				catch (...)
+				{
+					destroy_node(new_node);
+					throw;
+				}
+				root = this->insert(root, new_node, Augment::value_cache(new_node->value), inserted, inserted_or_found);
+				//A new maximum is always linked below the previous one, so no comparison is needed to detect it
+				if (*inserted && (dummy_past_end->left == NULL || dummy_past_end->left->right != NULL))
 					dummy_past_end->left = max_value_node(root); //update dummy past-the-end
 				if (*inserted == false)
 				{
-					_alloc.destroy(new_node);
-					_alloc.deallocate(new_node, 1);
+					destroy_node(new_node);
 				}
 			}
 
 			//Insert new_node into the AVL tree starting at root r
 			//Return the new root
-			node_type * insert(node_type * r, node_type * new_node, bool * inserted, node_type ** inserted_or_found) 
+			//cache : key cache of new_node, computed once for the whole descent
+			node_type * insert(node_type * r, node_type * new_node, const cache_type& cache, bool * inserted, node_type ** inserted_or_found) 
 			{
 				/// Usual binary search tree insertion steps ///
 				
@@ -186,22 +311,24 @@ namespace ft
 				if (r == NULL) 
 				{
 					r = new_node;
+					update_height(r);
 					*inserted = true; //indicates the caller that the node was successfully inserted
 					*inserted_or_found = r; //pointer to the node that was inserted
 					return r;
 				}
+				int c = compare(new_node->value, cache, r);
 				//If key to insert is inferior to current node key, go left
-				if (_comp(new_node->value, r->value)) 
+				if (c < 0) 
 				{
-					r->left = insert(r->left, new_node, inserted, inserted_or_found);
+					r->left = insert(r->left, new_node, cache, inserted, inserted_or_found);
 					if (r->left != NULL)
 						r->left->parent = r;
 					update_height(r);
 				}
 				//If key to insert is superior to current node key, go right
-				else if (_comp(r->value, new_node->value)) 
+				else if (c > 0) 
 				{
-					r->right = insert(r->right, new_node, inserted, inserted_or_found);
+					r->right = insert(r->right, new_node, cache, inserted, inserted_or_found);
 					if (r->right != NULL)
 						r->right->parent = r;
 					update_height(r);
@@ -215,30 +342,73 @@ namespace ft
 				}
 
 				/// The following steps are specific to AVL trees, we must rebalance if necessary ///
-				/// There are only 4 possible imbalance cases ///
 
 				//The first node to get to these steps is the one right after the recursive function first returned,
 				//so we are assured to be as far in the tree as possible (right above the insertion spot).
 				//We will then gradually climb the tree towards the root.
+				return rebalance_after_insertion(r);
+			}
+
+			//Links the unlinked new_node as the left (left is true) or right child of parent, which has no child on that side,
+			//or as the root if parent is NULL, then rebalances the tree from parent up to the root.
+			//The position must come from a search for the key of new_node : no key is compared here.
+			//The past-the-end sentinel must have been allocated (see reserve_past_end).
+			void link_node(node_type * parent, bool left, node_type * new_node)
+			{
+				new_node->parent = parent;
+				update_height(new_node);
+				if (parent == NULL)
+					root = new_node;
+				else if (left)
+					parent->left = new_node;
+				else
+					parent->right = new_node;
+
+				//Climb towards the root, replacing each subtree by its rebalanced version
+				for (node_type * r = parent; r != NULL; )
+				{
+					node_type * up = r->parent;
+					update_height(r);
+					node_type * subtree = rebalance_after_insertion(r);
+					if (up == NULL)
+						root = subtree;
+					else if (up->left == r)
+						up->left = subtree;
+					else
+						up->right = subtree;
+					r = up;
+				}
+
+				//A new maximum is always linked below the previous one, so no comparison is needed to detect it
+				if (dummy_past_end->left == NULL || dummy_past_end->left->right != NULL)
+					dummy_past_end->left = max_value_node(root); //update dummy past-the-end
+			}
+
+			//Restores the balance of r, whose height is up to date, after an insertion in one of its subtrees.
+			//Returns the new root of the subtree.
+			node_type * rebalance_after_insertion(node_type * r)
+			{
+				/// There are only 4 possible imbalance cases ///
+				//The side of the insertion in the heavy child is given by its balance factor, no key comparison is needed.
 				
 				int bf = get_balance_factor(r);
 				//Left Left Case  
-				if (bf > 1 && _comp(new_node->value, r->left->value))
+				if (bf > 1 && get_balance_factor(r->left) > 0)
 					return right_rotate(r);
 
 				//Right Right Case  
-				if (bf < -1 && _comp(r->right->value, new_node->value))
+				if (bf < -1 && get_balance_factor(r->right) < 0)
 					return left_rotate(r);
 
 				//Left Right Case  
-				if (bf > 1 && _comp(r->left->value, new_node->value)) 
+				if (bf > 1) 
 				{
 					r->left = left_rotate(r->left);
 					return right_rotate(r);
 				}
 
 				//Right Left Case  
-				if (bf < -1 && _comp(new_node->value, r->right->value)) 
+				if (bf < -1) 
 				{
 					r->right = right_rotate(r->right);
 					return left_rotate(r);
@@ -246,7 +416,6 @@ namespace ft
 
 				/* return the (unchanged) node pointer */
 				return r;
-
 			}
 
 			node_type * min_value_node(node_type * node) const
@@ -273,7 +442,41 @@ namespace ft
 
 			//Delete the node of key k from the tree starting at root r.
 			//Return the new root
-			node_type * delete_node(node_type * r, T k) 
+			node_type * delete_node(node_type * r, const T& k) 
+			{
+				node_type * parent = r != NULL ? r->parent : NULL;
+				node_type * new_root = delete_node(r, k, Augment::value_cache(k));
+				//a child replacing the deleted root would keep a pointer to it
+				if (new_root != NULL)
+					new_root->parent = parent;
+				return new_root;
+			}
+
+			//Unlink the node of value k from the tree starting at root r, without destroying it, and store it in *unlinked
+			//(NULL if k was not found). The node owns its memory : a node of the block of compact() is replaced by a copy.
+			//Return the new root
+			node_type * unlink_node(node_type * r, const T& k, node_type ** unlinked)
+			{
+				*unlinked = NULL;
+				node_type * parent = r != NULL ? r->parent : NULL;
+				node_type * new_root = delete_node(r, k, Augment::value_cache(k), unlinked);
+				if (new_root != NULL)
+					new_root->parent = parent;
+				if (*unlinked != NULL && in_block(*unlinked))
+				{
+# if FT_MOVE_SEMANTICS
+					node_type * copy = emplace_node(std::move((*unlinked)->value));
+# else
+					node_type * copy = create_node((*unlinked)->value);
+# endif
+					destroy_node(*unlinked);
+					*unlinked = copy;
+				}
+				return new_root;
+			}
+
+			//unlinked : if not NULL, the node of value k is stored there instead of being destroyed
+			node_type * delete_node(node_type * r, const T& k, const cache_type& cache, node_type ** unlinked = NULL) 
 			{
 				/// Usual binary search tree deletion steps ///
 				
@@ -282,20 +485,21 @@ namespace ft
 				{
 					return NULL;
 				}
+				int c = compare(k, cache, r);
 				//If the key to be deleted is smaller than the current node's key, 
 				//then it must be in the left subtree 
-				else if (_comp(k, r->value)) 
+				if (c < 0) 
 				{
-					r->left = delete_node(r->left, k);
+					r->left = delete_node(r->left, k, cache, unlinked);
 					if (r->left != NULL)
 						r->left->parent = r;
 					update_height(r);
 				}
 				//If the key to be deleted is greater than the current node's key, 
 				//then it must be in the right subtree 
-				else if (_comp(r->value, k)) 
+				else if (c > 0) 
 				{
-					r->right = delete_node(r->right, k);
+					r->right = delete_node(r->right, k, cache, unlinked);
 					if (r->right != NULL)
 						r->right->parent = r;
 					update_height(r);
@@ -307,15 +511,13 @@ namespace ft
 					if (r->left == NULL) 
 					{
 						node_type * temp = r->right;
-						_alloc.destroy(r);
-						_alloc.deallocate(r, 1);
+						remove_node(r, unlinked);
 						return temp; //return the child to link it with the deleted node's parent
 					}
 					else if (r->right == NULL) 
 					{
 						node_type * temp = r->left;
-						_alloc.destroy(r);
-						_alloc.deallocate(r, 1);
+						remove_node(r, unlinked);
 						return temp; //return the child to link it with the deleted node's parent
 					} 
 					else 
@@ -324,7 +526,7 @@ namespace ft
 						node_type * temp = min_value_node(r->right);
 
 						//unlink the inorder successor from the tree so that it can replace the deleted node
-						r->right = replace_node(r->right, temp->value);
+						r->right = replace_node(r->right, temp->value, Augment::value_cache(temp->value));
 						
 						//Replace the deleted node by the inorder successor
 						temp->parent = r->parent;
@@ -342,8 +544,7 @@ namespace ft
 								r->parent->right = temp;
 						}
 						//Delete the node to be deleted
-						_alloc.destroy(r);
-						_alloc.deallocate(r, 1);
+						remove_node(r, unlinked);
 						r = temp;
 						update_height(r);
 					}
@@ -375,27 +576,28 @@ namespace ft
 			}
 			
 			//Sames as delete_node, except the node with value k is not destroyed but simply unlinked from the rest of the tree
-			node_type * replace_node(node_type * r, T k)
+			node_type * replace_node(node_type * r, const T& k, const cache_type& cache)
 			{
 				//Base case : no node with key k was found
 				if (r == NULL) 
 				{
 					return NULL;
 				}
+				int c = compare(k, cache, r);
 				//If the key to be replaced is smaller than the current node's key, 
 				//then it must be in the left subtree 
-				else if (_comp(k, r->value)) 
+				if (c < 0) 
 				{
-					r->left = replace_node(r->left, k);
+					r->left = replace_node(r->left, k, cache);
 					if (r->left != NULL)
 						r->left->parent = r;
 					update_height(r);
 				}
 				//If the key to be replaced is greater than the current node's key, 
 				//then it must be in the right subtree 
-				else if (_comp(r->value, k)) 
+				else if (c > 0) 
 				{
-					r->right = replace_node(r->right, k);
+					r->right = replace_node(r->right, k, cache);
 					if (r->right != NULL)
 						r->right->parent = r;
 					update_height(r);
@@ -442,26 +644,18 @@ namespace ft
 			}
 
 			//Search for the node with value v, return the node if found, NULL otherwise
-			node_type * iterative_search(T v) const
+			node_type * iterative_search(const T& v) const
 			{
-				if (root == NULL) 
+				cache_type cache = Augment::value_cache(v);
+				node_type * temp = root;
+				while (temp != NULL) 
 				{
-					return root;
-				} 
-				else 
-				{
-					node_type * temp = root;
-					while (temp != NULL) 
-					{
-						if (_comp(v, temp->value)) 
-							temp = temp->left;
-						else if (_comp(temp->value, v)) 
-							temp = temp->right;
-						else 
-							return temp;
-					}
-				return NULL;
+					int c = compare(v, cache, temp);
+					if (c == 0)
+						return temp;
+					temp = (c < 0) ? temp->left : temp->right; //compiled to a conditional move rather than a branch
 				}
+				return NULL;
 			}
 
 			//Destroy and deallocate the entire tree starting from root r
@@ -471,8 +665,7 @@ namespace ft
 					return;
 				clear(r->left);
 				clear(r->right);
-				_alloc.destroy(r);
-				_alloc.deallocate(r, 1);
+				destroy_node(r);
 			}
 
 			//Calculates the number of nodes in the tree starting from root r
@@ -497,11 +690,126 @@ namespace ft
 				std::swap(dummy_past_end, t.dummy_past_end);
 				std::swap(_alloc, t._alloc);
 				std::swap(_comp, t._comp);
+				std::swap(_block, t._block);
+				std::swap(_block_size, t._block_size);
+				std::swap(_block_live, t._block_live);
+			}
+
+			//Moves the nodes into a single block allocated for them, in key order, and links them as a perfectly
+			//balanced tree. The values are copied then the old nodes destroyed. Erased nodes of the block are destroyed
+			//in place, and the block is freed with its last node.
+			void compact()
+			{
+				size_type n = size(root);
+				if (n == 0)
+					return;
+				node_type * block = _alloc.allocate(n);
+				size_type built = 0;
+				try
+				{
+					construct_in_order(root, block, built);
+				}
+				catch (...)
+				{
+					while (built > 0)
+						_alloc.destroy(block + --built);
+					_alloc.deallocate(block, n);
+					throw;
+				}
+				clear(root);
+				_block = block;
+				_block_size = n;
+				_block_live = n;
+				root = link_balanced(block, n, NULL);
+				dummy_past_end->left = block + n - 1;
 			}
 
 		private:
+			typedef typename allocator_type::template rebind<links_type>::other links_allocator_type;
+
 			allocator_type _alloc;
 			value_compare _comp;
+			node_type * _block; //nodes allocated together by compact()
+			size_type _block_size;
+			size_type _block_live; //nodes of the block not destroyed yet
+
+			//Whether node belongs to the block of compact()
+			bool in_block(const node_type * node) const
+			{
+				std::less<const node_type *> before;
+				return _block != NULL && !before(node, _block) && before(node, _block + _block_size);
+			}
+
+			//Destroy a node and release its memory, which may belong to the block of compact()
+			void destroy_node(node_type * node)
+			{
+				_alloc.destroy(node);
+				if (in_block(node))
+				{
+					if (--_block_live == 0)
+					{
+						_alloc.deallocate(_block, _block_size);
+						_block = NULL;
+					}
+				}
+				else
+					_alloc.deallocate(node, 1);
+			}
+
+			//Destroy the node removed from the tree by delete_node, or hand it to the caller through unlinked
+			void remove_node(node_type * node, node_type ** unlinked)
+			{
+				if (unlinked == NULL)
+				{
+					destroy_node(node);
+					return;
+				}
+				node->left = NULL;
+				node->right = NULL;
+				node->parent = NULL;
+				*unlinked = node;
+			}
+
+			//Copy the values of the subtree r, in order, into the nodes of block from index i
+			void construct_in_order(node_type * r, node_type * block, size_type& i)
+			{
+				if (r == NULL)
+					return;
+				construct_in_order(r->left, block, i);
+				_alloc.construct(block + i, r->value);
+				Augment::init(block + i);
+				i++;
+				construct_in_order(r->right, block, i);
+			}
+
+			//Link the n consecutive nodes as a perfectly balanced tree below parent, and return its root
+			node_type * link_balanced(node_type * nodes, size_type n, node_type * parent)
+			{
+				if (n == 0)
+					return NULL;
+				size_type middle = n / 2;
+				node_type * node = nodes + middle;
+				node->parent = parent;
+				node->left = link_balanced(nodes, middle, node);
+				node->right = link_balanced(nodes + middle + 1, n - middle - 1, node);
+				update_height(node);
+				return node;
+			}
+
+			//Three-way comparison of a and b with _comp (see ft::three_way) : a single comparison per tree level
+			int compare(const T& a, const T& b) const
+			{
+				return three_way<T, value_compare>::compare(_comp, a, b);
+			}
+
+			//Same, against the value of node b : the key caches are compared first, the values only on a tie
+			int compare(const T& a, const cache_type& cache, const node_type * b) const
+			{
+				int c = Augment::compare_cached(cache, b);
+				if (c != 0)
+					return c;
+				return compare(a, b->value);
+			}
 
 	};
 
@@ -0,0 +1,265 @@
+#ifndef BUFFERED_MAP_HPP
+# define BUFFERED_MAP_HPP
+
+# include <memory>
+# include <functional>
+# include <algorithm>
+# include "map.hpp"
+# include "vector.hpp"
+# include "parallel.hpp"
+
+namespace ft
+{
+	//Write-optimized map : assignments and erasures are appended to a buffer (an erasure being a tombstone) without
+	//searching the tree, and are applied to an ft::map in sorted batches once the buffer holds flush_threshold operations.
+	//Lookups search the buffer from the newest operation, then the map : a larger threshold makes ingestion cheaper
+	//and lookups costlier. Operations which read the whole content (size, for_each, merged) flush the buffer first.
+	template < class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::TreeNode<pair<const Key,T> > > >
+	class buffered_map
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef Key key_type;
+			typedef T mapped_type;
+			typedef ft::pair<const key_type, mapped_type> value_type;
+			typedef Compare key_compare;
+			typedef Alloc allocator_type;
+			typedef std::size_t size_type;
+			typedef ft::map<Key, T, Compare, Alloc> map_type;
+
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			explicit buffered_map (size_type flush_threshold = 1024, const key_compare& comp = key_compare())
+				: _comp(comp), _map(comp), _size(0), _threshold(flush_threshold != 0 ? flush_threshold : 1) {}
+
+			/// MODIFIERS ///
+
+			//Sets the mapped value of k, inserting it if needed
+			void assign (const key_type& k, const mapped_type& obj)
+			{
+				operation op = {k, _values.size()};
+				_values.push_back(obj);
+				append(op);
+			}
+
+			//Removes the element of key k, if any
+			void erase (const key_type& k)
+			{
+				operation op = {k, tombstone};
+				append(op);
+			}
+
+			//Applies the buffered operations to the map
+			void flush()
+			{
+				if (_ops.empty())
+					return;
+				std::stable_sort(_ops.begin(), _ops.end(), operation_order(_comp));
+
+				//the last operation on a key is the one which counts
+				std::size_t last = 0;
+				for (std::size_t i = 0; i < _ops.size(); i++)
+				{
+					if (last != 0 && !_comp(_ops[last - 1].key, _ops[i].key))
+						_ops[last - 1] = _ops[i];
+					else
+						_ops[last++] = _ops[i];
+				}
+
+				//a batch large enough to visit most of the tree is merged with it, and the tree rebuilt
+				std::size_t depth = 1;
+				while ((static_cast<std::size_t>(1) << depth) <= _size)
+					depth++;
+				if (last * depth >= _size)
+					merge(last);
+				else
+					apply(last);
+				_ops.clear();
+				_values.clear();
+			}
+
+			void clear()
+			{
+				_ops.clear();
+				_values.clear();
+				_map.clear();
+				_size = 0;
+			}
+
+			void swap (buffered_map& x)
+			{
+				std::swap(_comp, x._comp);
+				_map.swap(x._map);
+				_ops.swap(x._ops);
+				_values.swap(x._values);
+				std::swap(_size, x._size);
+				std::swap(_threshold, x._threshold);
+			}
+
+			/// LOOKUP ///
+
+			//Returns a pointer to the mapped value of k, or NULL if k is not present.
+			//It remains valid until the next modification of the map.
+			const mapped_type * find (const key_type& k) const
+			{
+				for (std::size_t i = _ops.size(); i-- > 0; )
+				{
+					if (!_comp(k, _ops[i].key) && !_comp(_ops[i].key, k))
+						return _ops[i].value != tombstone ? &_values[_ops[i].value] : NULL;
+				}
+				typename map_type::const_iterator it = _map.find(k);
+				return it != _map.end() ? &it->second : NULL;
+			}
+
+			size_type count (const key_type& k) const
+			{
+				return find(k) != NULL ? 1 : 0;
+			}
+
+			/// WHOLE CONTENT ///
+
+			size_type size()
+			{
+				flush();
+				return _size;
+			}
+
+			bool empty()
+			{
+				return size() == 0;
+			}
+
+			//Applies f to every element in key order and returns f (see map::for_each)
+			template <class Function>
+			Function for_each (Function f)
+			{
+				flush();
+				return _map.for_each(f);
+			}
+
+			//The map holding all the elements
+			const map_type& merged()
+			{
+				flush();
+				return _map;
+			}
+
+			/// BUFFER ///
+
+			//Number of operations waiting in the buffer
+			size_type buffered() const
+			{
+				return _ops.size();
+			}
+
+			size_type flush_threshold() const
+			{
+				return _threshold;
+			}
+
+			void set_flush_threshold (size_type n)
+			{
+				_threshold = n != 0 ? n : 1;
+				if (_ops.size() >= _threshold)
+					flush();
+			}
+
+			key_compare key_comp() const
+			{
+				return _comp;
+			}
+
+		private:
+			static const std::size_t tombstone = static_cast<std::size_t>(-1);
+
+			struct operation
+			{
+				key_type key;
+				std::size_t value; //index in _values, or tombstone for an erasure
+			};
+
+			struct operation_order
+			{
+				key_compare comp;
+
+				operation_order(const key_compare& c) : comp(c) {}
+
+				bool operator()(const operation& x, const operation& y) const
+				{
+					return comp(x.key, y.key);
+				}
+			};
+
+			key_compare _comp;
+			map_type _map;
+			ft::vector<operation> _ops; //in the order they were made
+			ft::vector<mapped_type> _values;
+			size_type _size; //of _map, whose size() counts the nodes
+			size_type _threshold;
+
+			void append(const operation& op)
+			{
+				_ops.push_back(op);
+				if (_ops.size() >= _threshold)
+					flush();
+			}
+
+			//Applies the n sorted operations one by one
+			void apply(std::size_t n)
+			{
+				for (std::size_t i = 0; i < n; i++)
+				{
+					if (_ops[i].value == tombstone)
+						_size -= _map.erase(_ops[i].key);
+					else
+					{
+						ft::pair<typename map_type::iterator, bool> found = _map.insert(value_type(_ops[i].key, _values[_ops[i].value]));
+						if (found.second)
+							_size++;
+						else
+							found.first->second = _values[_ops[i].value];
+					}
+				}
+			}
+
+			//Merges the n sorted operations with the elements of the map into a sorted run, and rebuilds the tree from it
+			void merge(std::size_t n)
+			{
+				typedef ft::pair<key_type, mapped_type> element; //with an assignable key
+				ft::vector<element> run;
+				run.reserve(_size + n);
+				typename map_type::iterator it = _map.begin();
+				std::size_t i = 0;
+				while (it != _map.end() || i < n)
+				{
+					if (i == n || (it != _map.end() && _comp(it->first, _ops[i].key)))
+					{
+						run.push_back(element(it->first, it->second));
+						++it;
+						continue;
+					}
+					if (it != _map.end() && !_comp(_ops[i].key, it->first))
+						++it; //replaced or erased by the operation
+					if (_ops[i].value != tombstone)
+						run.push_back(element(_ops[i].key, _values[_ops[i].value]));
+					i++;
+				}
+				map_builder<map_type> builder(_map);
+				builder.build(run.empty() ? static_cast<element *>(NULL) : &run[0], run.size(), 1);
+				_size = run.size();
+			}
+	};
+
+	template < class Key, class T, class Compare, class Alloc >
+	void swap (buffered_map<Key, T, Compare, Alloc>& x, buffered_map<Key, T, Compare, Alloc>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
@@ -0,0 +1,447 @@
+#ifndef FROZEN_MAP_HPP
+# define FROZEN_MAP_HPP
+
+# include <memory>
+# include <string>
+# include <cstring>
+# include <stdexcept>
+# include <algorithm>
+# include <stdint.h>
+# include "utils.hpp"
+# include "vector.hpp"
+# include "map.hpp"
+
+namespace ft
+{
+	///-------------///
+	/// FROZEN HASH ///
+	///-------------///
+
+	//Finalizer of the splitmix64 generator: spreads every input bit over the whole 64 bits word
+	inline uint64_t hash_mix(uint64_t h)
+	{
+		h ^= h >> 30;
+		h *= 0xbf58476d1ce4e5b9ULL;
+		h ^= h >> 27;
+		h *= 0x94d049bb133111ebULL;
+		h ^= h >> 31;
+		return h;
+	}
+
+	//Seeded hash used by frozen_map. The default implementation handles integral and enum keys.
+	//Specialize it for any other key type.
+	template <class Key>
+	struct frozen_hash
+	{
+		uint64_t operator()(const Key& k, uint64_t seed) const
+		{
+			return hash_mix(static_cast<uint64_t>(k) ^ seed);
+		}
+	};
+
+	template <>
+	struct frozen_hash<std::string>
+	{
+		uint64_t operator()(const std::string& k, uint64_t seed) const
+		{
+			const char * p = k.data();
+			std::size_t len = k.size();
+			uint64_t h = seed ^ (len * 0x9e3779b97f4a7c15ULL);
+			uint64_t w;
+
+			//8 bytes at a time, then the tail padded with zeroes
+			for (; len >= 8; len -= 8, p += 8)
+			{
+				std::memcpy(&w, p, 8);
+				h = hash_mix(h ^ w);
+			}
+			w = 0;
+			std::memcpy(&w, p, len);
+			return hash_mix(h ^ w);
+		}
+	};
+
+	///--------------///
+	/// FROZEN CODEC ///
+	///--------------///
+
+	//Serialization of keys and values for frozen_map::serialize and frozen_map::load.
+	//The default implementation copies the raw bytes, so it is only valid for trivially copyable types.
+	template <class T>
+	struct frozen_codec
+	{
+		static void write(std::string& out, const T& v)
+		{
+			out.append(reinterpret_cast<const char *>(&v), sizeof(T));
+		}
+
+		static bool read(const char *& p, const char * end, T& v)
+		{
+			if (static_cast<std::size_t>(end - p) < sizeof(T))
+				return false;
+			std::memcpy(&v, p, sizeof(T));
+			p += sizeof(T);
+			return true;
+		}
+	};
+
+	//Strings are stored as their length followed by their bytes
+	template <>
+	struct frozen_codec<std::string>
+	{
+		static void write(std::string& out, const std::string& v)
+		{
+			frozen_codec<uint64_t>::write(out, static_cast<uint64_t>(v.size()));
+			out.append(v);
+		}
+
+		static bool read(const char *& p, const char * end, std::string& v)
+		{
+			uint64_t len;
+			if (!frozen_codec<uint64_t>::read(p, end, len) || static_cast<uint64_t>(end - p) < len)
+				return false;
+			v.assign(p, static_cast<std::size_t>(len));
+			p += len;
+			return true;
+		}
+	};
+
+	///------------///
+	/// FROZEN MAP ///
+	///------------///
+
+	//Immutable key -> value table indexed by a minimal perfect hash function (hash, displace and compress).
+	//Keys are hashed into buckets of ~4 keys, and each bucket stores a "pilot" chosen at build time so that
+	//all the keys of the table land in distinct slots of an array of exactly size() entries.
+	//A lookup is therefore always two hashes and a single probe followed by one key comparison.
+	template < class Key, class T, class Hash = ft::frozen_hash<Key> >
+	class frozen_map
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef Key key_type;
+			typedef T mapped_type;
+			typedef ft::pair<const key_type, mapped_type> value_type;
+			typedef Hash hasher;
+			typedef typename ft::vector<value_type>::const_iterator const_iterator;
+			typedef const_iterator iterator;
+			typedef std::size_t size_type;
+
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			//Empty constructor
+			explicit frozen_map(const hasher& hash = hasher()) : _hash(hash), _seed(0), _nb_buckets(0) {}
+
+			//Range constructor
+			//Builds the table from the range [first,last), which must not contain the same key twice.
+			template <class InputIterator>
+			frozen_map(InputIterator first, InputIterator last, const hasher& hash = hasher(),
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+				: _hash(hash), _seed(0), _nb_buckets(0)
+			{
+				build(first, last);
+			}
+
+			//Builds the table from all the elements of a map
+			template <class Compare, class Alloc, class Augment>
+			explicit frozen_map(const ft::map<Key, T, Compare, Alloc, Augment>& m, const hasher& hash = hasher())
+				: _hash(hash), _seed(0), _nb_buckets(0)
+			{
+				build(m.begin(), m.end());
+			}
+
+			/// CAPACITY ///
+
+			size_type size() const
+			{
+				return _entries.size();
+			}
+
+			bool empty() const
+			{
+				return _entries.empty();
+			}
+
+			//Number of bytes used by the table (entries and pilots), without what the entries own on the heap
+			size_type memory_usage() const
+			{
+				return sizeof(*this) + _entries.capacity() * sizeof(value_type) + _pilots.capacity() * sizeof(uint32_t);
+			}
+
+			/// ITERATORS ///
+
+			//The elements are visited in slot order, not in key order
+			const_iterator begin() const
+			{
+				return _entries.begin();
+			}
+
+			const_iterator end() const
+			{
+				return _entries.end();
+			}
+
+			/// LOOKUP ///
+
+			//Returns an iterator to the element of key k, or end() if k is not in the table
+			const_iterator find(const key_type& k) const
+			{
+				if (_entries.empty())
+					return end();
+				uint64_t h = _hash(k, _seed);
+				const value_type& candidate = _entries[slot(h, _pilots[bucket(h)])];
+				if (candidate.first == k)
+					return const_iterator(&candidate);
+				return end();
+			}
+
+			size_type count(const key_type& k) const
+			{
+				return find(k) == end() ? 0 : 1;
+			}
+
+			//Returns a reference to the mapped value of key k, throws an out_of_range exception if k is not in the table
+			const mapped_type& at(const key_type& k) const
+			{
+				const_iterator it = find(k);
+				if (it == end())
+					throw std::out_of_range("frozen_map::at");
+				return it->second;
+			}
+
+			/// SERIALIZATION ///
+
+			//Appends the table to out. The format uses the native endianness and the frozen_codec of Key and T.
+			void serialize(std::string& out) const
+			{
+				out.append(_magic, sizeof(_magic));
+				frozen_codec<uint64_t>::write(out, _seed);
+				frozen_codec<uint64_t>::write(out, static_cast<uint64_t>(_entries.size()));
+				frozen_codec<uint64_t>::write(out, static_cast<uint64_t>(_nb_buckets));
+				for (size_type i = 0; i < _pilots.size(); i++)
+					frozen_codec<uint32_t>::write(out, _pilots[i]);
+				for (size_type i = 0; i < _entries.size(); i++)
+				{
+					frozen_codec<Key>::write(out, _entries[i].first);
+					frozen_codec<T>::write(out, _entries[i].second);
+				}
+			}
+
+			//Replaces the content of the table by the one serialized in [data, data + len), without rebuilding the hash function.
+			//Throws an invalid_argument exception if the data is not a serialized table.
+			void load(const char * data, std::size_t len)
+			{
+				const char * p = data;
+				const char * end = data + len;
+				uint64_t seed, n, nb_buckets;
+
+				if (len < sizeof(_magic) || std::memcmp(p, _magic, sizeof(_magic)) != 0)
+					throw std::invalid_argument("frozen_map::load");
+				p += sizeof(_magic);
+				if (!frozen_codec<uint64_t>::read(p, end, seed) || !frozen_codec<uint64_t>::read(p, end, n)
+					|| !frozen_codec<uint64_t>::read(p, end, nb_buckets) || (n != 0 && nb_buckets == 0)
+					|| nb_buckets > static_cast<uint64_t>(end - p) / sizeof(uint32_t))
+					throw std::invalid_argument("frozen_map::load");
+
+				ft::vector<uint32_t> pilots(static_cast<size_type>(nb_buckets));
+				for (size_type i = 0; i < pilots.size(); i++)
+					frozen_codec<uint32_t>::read(p, end, pilots[i]);
+
+				ft::vector<value_type> entries;
+				entries.reserve(static_cast<size_type>(std::min<uint64_t>(n, static_cast<uint64_t>(end - p))));
+				for (uint64_t i = 0; i < n; i++)
+				{
+					Key k;
+					T v;
+					if (!frozen_codec<Key>::read(p, end, k) || !frozen_codec<T>::read(p, end, v))
+						throw std::invalid_argument("frozen_map::load");
+					entries.push_back(value_type(k, v));
+				}
+
+				_seed = seed;
+				_nb_buckets = static_cast<size_type>(nb_buckets);
+				_pilots.swap(pilots);
+				_entries.swap(entries);
+			}
+
+			void swap(frozen_map& x)
+			{
+				std::swap(_hash, x._hash);
+				std::swap(_seed, x._seed);
+				std::swap(_nb_buckets, x._nb_buckets);
+				_pilots.swap(x._pilots);
+				_entries.swap(x._entries);
+			}
+
+		private:
+			static const char _magic[8];
+			static const unsigned int _max_attempts = 32; //number of hash seeds tried before giving up
+			static const uint32_t _max_pilot = 1u << 20; //number of pilots tried per bucket before changing the seed
+
+			hasher _hash;
+			uint64_t _seed;
+			size_type _nb_buckets;
+			ft::vector<uint32_t> _pilots; //one pilot per bucket
+			ft::vector<value_type> _entries; //one entry per slot
+
+			size_type bucket(uint64_t h) const
+			{
+				return static_cast<size_type>((h >> 32) % _nb_buckets);
+			}
+
+			size_type slot(uint64_t h, uint32_t pilot) const
+			{
+				return static_cast<size_type>(hash_mix(h ^ (pilot * 0x9e3779b97f4a7c15ULL)) % _entries.size());
+			}
+
+			static size_type slot_for_size(uint64_t h, uint32_t pilot, size_type n)
+			{
+				return static_cast<size_type>(hash_mix(h ^ (pilot * 0x9e3779b97f4a7c15ULL)) % n);
+			}
+
+			//Orders bucket indices by decreasing bucket size, so that the hardest buckets are placed first
+			struct bucket_size_greater
+			{
+				const ft::vector<size_type> * start;
+				bool operator()(size_type a, size_type b) const
+				{
+					return (*start)[a + 1] - (*start)[a] > (*start)[b + 1] - (*start)[b];
+				}
+			};
+
+			//Computes the seed and the pilots for the range, then lays out the entries in slot order
+			template <class InputIterator>
+			void build(InputIterator first, InputIterator last)
+			{
+				ft::vector<value_type> items;
+				for (; first != last; ++first)
+					items.push_back(value_type(first->first, first->second));
+
+				size_type n = items.size();
+				if (n == 0)
+					return;
+				size_type nb_buckets = n / 4 + 1;
+				ft::vector<uint64_t> hashes(n);
+				ft::vector<size_type> bucket_start(nb_buckets + 1);
+				ft::vector<size_type> by_bucket(n);
+				ft::vector<size_type> bucket_order(nb_buckets);
+				ft::vector<uint32_t> pilots(nb_buckets);
+				ft::vector<size_type> slot_owner(n);
+				ft::vector<char> taken(n);
+				ft::vector<size_type> positions;
+
+				_nb_buckets = nb_buckets;
+				for (unsigned int attempt = 0; attempt < _max_attempts; attempt++)
+				{
+					uint64_t seed = hash_mix(attempt + 0x9e3779b97f4a7c15ULL);
+
+					//Group the keys by bucket (counting sort)
+					for (size_type i = 0; i <= nb_buckets; i++)
+						bucket_start[i] = 0;
+					for (size_type i = 0; i < n; i++)
+					{
+						hashes[i] = _hash(items[i].first, seed);
+						bucket_start[bucket(hashes[i]) + 1]++;
+					}
+					for (size_type b = 0; b < nb_buckets; b++)
+						bucket_start[b + 1] += bucket_start[b];
+					for (size_type b = 0; b < nb_buckets; b++)
+						bucket_order[b] = bucket_start[b];
+					for (size_type i = 0; i < n; i++)
+						by_bucket[bucket_order[bucket(hashes[i])]++] = i;
+					for (size_type b = 0; b < nb_buckets; b++)
+						bucket_order[b] = b;
+					bucket_size_greater cmp;
+					cmp.start = &bucket_start;
+					std::sort(&bucket_order[0], &bucket_order[0] + nb_buckets, cmp);
+
+					for (size_type i = 0; i < n; i++)
+						taken[i] = 0;
+					if (place_buckets(n, hashes, bucket_start, by_bucket, bucket_order, items, pilots, slot_owner, taken, positions))
+					{
+						_seed = seed;
+						_pilots.swap(pilots);
+						_entries.reserve(n);
+						for (size_type s = 0; s < n; s++)
+							_entries.push_back(items[slot_owner[s]]);
+						return;
+					}
+				}
+				_nb_buckets = 0;
+				throw std::runtime_error("frozen_map: no perfect hash function found");
+			}
+
+			//Finds a pilot for every bucket. Returns false if some bucket could not be placed with this seed.
+			bool place_buckets(size_type n, const ft::vector<uint64_t>& hashes, const ft::vector<size_type>& bucket_start,
+				const ft::vector<size_type>& by_bucket, const ft::vector<size_type>& bucket_order, const ft::vector<value_type>& items,
+				ft::vector<uint32_t>& pilots, ft::vector<size_type>& slot_owner, ft::vector<char>& taken, ft::vector<size_type>& positions) const
+			{
+				for (size_type o = 0; o < bucket_order.size(); o++)
+				{
+					size_type b = bucket_order[o];
+					size_type begin = bucket_start[b];
+					size_type end = bucket_start[b + 1];
+					pilots[b] = 0;
+					if (begin == end)
+						continue;
+
+					//Keys with the same hash can never be separated: either they are duplicates or the seed is bad
+					for (size_type i = begin; i < end; i++)
+						for (size_type j = i + 1; j < end; j++)
+							if (hashes[by_bucket[i]] == hashes[by_bucket[j]])
+							{
+								if (items[by_bucket[i]].first == items[by_bucket[j]].first)
+									throw std::invalid_argument("frozen_map: duplicate key");
+								return false;
+							}
+
+					uint32_t pilot = 0;
+					for (; pilot < _max_pilot; pilot++)
+					{
+						positions.clear();
+						size_type i = begin;
+						for (; i < end; i++)
+						{
+							size_type s = slot_for_size(hashes[by_bucket[i]], pilot, n);
+							if (taken[s])
+								break;
+							size_type p = 0;
+							while (p < positions.size() && positions[p] != s)
+								p++;
+							if (p < positions.size())
+								break;
+							positions.push_back(s);
+						}
+						if (i == end)
+							break;
+					}
+					if (pilot == _max_pilot)
+						return false;
+
+					pilots[b] = pilot;
+					for (size_type i = begin; i < end; i++)
+					{
+						taken[positions[i - begin]] = 1;
+						slot_owner[positions[i - begin]] = by_bucket[i];
+					}
+				}
+				return true;
+			}
+	};
+
+	template < class Key, class T, class Hash >
+	const char frozen_map<Key, T, Hash>::_magic[8] = {'F', 'T', 'M', 'P', 'H', 'F', '0', '1'};
+
+	template < class Key, class T, class Hash >
+	void swap(frozen_map<Key, T, Hash>& x, frozen_map<Key, T, Hash>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
@@ -0,0 +1,368 @@
+#ifndef INTERVAL_MAP_HPP
+# define INTERVAL_MAP_HPP
+
+# include <memory>
+# include <functional>
+# include "utils.hpp"
+# include "avl_tree.hpp"
+# include "iterator.hpp"
+
+namespace ft
+{
+	//Augmentation policy of interval_map : each node stores the greatest interval end of its subtree
+	template <class Key, class Compare>
+	struct interval_max_end : public no_augmentation
+	{
+		typedef Key data_type;
+
+		template <class Node>
+		static void init(Node * r)
+		{
+			update(r);
+		}
+
+		template <class Node>
+		static void update(Node * r)
+		{
+			Compare comp;
+			r->aug = r->value.first.second;
+			if (r->left && comp(r->aug, r->left->aug))
+				r->aug = r->left->aug;
+			if (r->right && comp(r->aug, r->right->aug))
+				r->aug = r->right->aug;
+		}
+	};
+
+	//Associative container whose keys are closed intervals [first, second] of Key.
+	//It is an AVL tree ordered by interval start (then end), augmented with the maximum end of each subtree,
+	//which allows to find all the intervals overlapping a range in O(log(n) + k).
+	template < class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::pair<const ft::pair<Key, Key>, T> > >
+	class interval_map
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef Key bound_type;
+			typedef ft::pair<Key, Key> key_type; //the interval [first, second]
+			typedef T mapped_type;
+			typedef ft::pair<const key_type, mapped_type> value_type;
+			typedef Compare bound_compare;
+			typedef std::size_t size_type;
+
+			//Orders intervals by start, then by end
+			class value_compare
+			{
+				friend class interval_map;
+				protected:
+					Compare comp;
+					value_compare (Compare c) : comp(c) {}
+				public:
+					typedef void is_three_way;
+					bool operator() (const value_type& x, const value_type& y) const
+					{
+						return three_way(x, y) < 0;
+					}
+					int three_way (const value_type& x, const value_type& y) const
+					{
+						int c = key_three_way<Key, Compare>::compare(comp, x.first.first, y.first.first);
+						if (c != 0)
+							return c;
+						return key_three_way<Key, Compare>::compare(comp, x.first.second, y.first.second);
+					}
+			};
+
+		private:
+			typedef AVLTree<value_type, value_compare, Alloc, interval_max_end<Key, Compare> > tree_type;
+			typedef typename tree_type::node_type node_type;
+
+		public:
+			typedef typename tree_type::allocator_type allocator_type;
+			typedef ft::avl_tree_iterator<node_type, false> iterator;
+			typedef ft::avl_tree_iterator<const node_type, true> const_iterator;
+			typedef ft::reverse_iterator<iterator> reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			//Empty constructor
+			explicit interval_map (const bound_compare& comp = bound_compare(), const allocator_type& alloc = allocator_type())
+				: _comp(comp), _alloc(alloc), _tree(value_compare(comp), alloc) {}
+
+			//Range constructor
+			template <class InputIterator>
+			interval_map (InputIterator first, InputIterator last, const bound_compare& comp = bound_compare(), const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+				: _comp(comp), _alloc(alloc), _tree(value_compare(comp), alloc)
+			{
+				insert(first, last);
+			}
+
+			//Copy constructor
+			interval_map (const interval_map& x) : _comp(x._comp), _alloc(x._alloc), _tree(value_compare(x._comp), x._alloc)
+			{
+				insert(x.begin(), x.end());
+			}
+
+			~interval_map()
+			{
+				clear();
+			}
+
+			interval_map& operator= (const interval_map& x)
+			{
+				if (&x == this)
+					return (*this);
+				clear();
+				insert(x.begin(), x.end());
+				return *this;
+			}
+
+			/// ITERATORS ///
+			//The intervals are visited by increasing start, then increasing end
+
+			iterator begin()
+			{
+				if (_tree.root == NULL)
+					return iterator(_tree.dummy_past_end);
+				return iterator(_tree.min_value_node(_tree.root), _tree.dummy_past_end);
+			}
+
+			const_iterator begin() const
+			{
+				if (_tree.root == NULL)
+					return const_iterator(_tree.dummy_past_end);
+				return const_iterator(_tree.min_value_node(_tree.root), _tree.dummy_past_end);
+			}
+
+			iterator end()
+			{
+				return iterator(_tree.dummy_past_end, _tree.dummy_past_end);
+			}
+
+			const_iterator end() const
+			{
+				return const_iterator(_tree.dummy_past_end, _tree.dummy_past_end);
+			}
+
+			reverse_iterator rbegin()
+			{
+				return reverse_iterator(end());
+			}
+
+			const_reverse_iterator rbegin() const
+			{
+				return const_reverse_iterator(end());
+			}
+
+			reverse_iterator rend()
+			{
+				return reverse_iterator(begin());
+			}
+
+			const_reverse_iterator rend() const
+			{
+				return const_reverse_iterator(begin());
+			}
+
+			/// CAPACITY ///
+
+			bool empty() const
+			{
+				return _tree.tree_is_empty();
+			}
+
+			size_type size() const
+			{
+				return _tree.size(_tree.root);
+			}
+
+			size_type max_size() const
+			{
+				return _tree.max_size();
+			}
+
+			/// MODIFIERS ///
+
+			//Inserts the interval [lo, hi] mapped to val, unless this exact interval is already in the container
+			pair<iterator,bool> insert (const bound_type& lo, const bound_type& hi, const mapped_type& val)
+			{
+				return insert(value_type(key_type(lo, hi), val));
+			}
+
+			pair<iterator,bool> insert (const value_type& val)
+			{
+				bool inserted;
+				node_type * inserted_or_found;
+
+				_tree.create_and_insert(val, &inserted, &inserted_or_found);
+				return ft::make_pair<iterator, bool>(iterator(inserted_or_found, _tree.dummy_past_end), inserted);
+			}
+
+			template <class InputIterator>
+			void insert (InputIterator first, InputIterator last, typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+			{
+				while (first != last)
+					insert(*(first++));
+			}
+
+			void erase (iterator position)
+			{
+				_tree.root = _tree.delete_node(_tree.root, *position);
+				_tree.update_past_end();
+			}
+
+			//Removes the interval [lo, hi]. Returns the number of elements erased.
+			size_type erase (const bound_type& lo, const bound_type& hi)
+			{
+				iterator it = find(lo, hi);
+				if (it == end())
+					return 0;
+				erase(it);
+				return 1;
+			}
+
+			void swap (interval_map& x)
+			{
+				_tree.swap(x._tree);
+				std::swap(_comp, x._comp);
+				std::swap(_alloc, x._alloc);
+			}
+
+			void clear()
+			{
+				_tree.clear(_tree.root);
+				_tree.root = NULL;
+				_tree.update_past_end();
+			}
+
+			/// LOOKUP ///
+
+			//Searches the exact interval [lo, hi]
+			iterator find (const bound_type& lo, const bound_type& hi)
+			{
+				node_type * node_found = _tree.iterative_search(value_type(key_type(lo, hi), mapped_type()));
+				if (node_found == NULL)
+					return end();
+				return iterator(node_found, _tree.dummy_past_end);
+			}
+
+			const_iterator find (const bound_type& lo, const bound_type& hi) const
+			{
+				node_type * node_found = _tree.iterative_search(value_type(key_type(lo, hi), mapped_type()));
+				if (node_found == NULL)
+					return end();
+				return const_iterator(node_found, _tree.dummy_past_end);
+			}
+
+			//Writes to out an iterator to every interval overlapping [lo, hi], by increasing start.
+			//Returns the output iterator past the last written element.
+			template <class OutputIterator>
+			OutputIterator find_overlaps (const bound_type& lo, const bound_type& hi, OutputIterator out)
+			{
+				collect(_tree.root, lo, hi, out);
+				return out;
+			}
+
+			template <class OutputIterator>
+			OutputIterator find_overlaps (const bound_type& lo, const bound_type& hi, OutputIterator out) const
+			{
+				collect_const(_tree.root, lo, hi, out);
+				return out;
+			}
+
+			//Writes to out an iterator to every interval containing the point x (stabbing query)
+			template <class OutputIterator>
+			OutputIterator find_containing (const bound_type& x, OutputIterator out)
+			{
+				return find_overlaps(x, x, out);
+			}
+
+			template <class OutputIterator>
+			OutputIterator find_containing (const bound_type& x, OutputIterator out) const
+			{
+				return find_overlaps(x, x, out);
+			}
+
+			//Returns whether at least one interval overlaps [lo, hi], in O(log(n))
+			bool overlaps (const bound_type& lo, const bound_type& hi) const
+			{
+				node_type * r = _tree.root;
+				while (r != NULL)
+				{
+					if (!_comp(hi, r->value.first.first) && !_comp(r->value.first.second, lo))
+						return true;
+					//The left subtree can only hold an overlapping interval if one of its intervals ends after lo.
+					//Otherwise every candidate starts after this node, so it is in the right subtree.
+					if (r->left != NULL && !_comp(r->left->aug, lo))
+						r = r->left;
+					else if (_comp(hi, r->value.first.first))
+						return false;
+					else
+						r = r->right;
+				}
+				return false;
+			}
+
+			/// OBSERVERS ///
+
+			bound_compare bound_comp() const
+			{
+				return _comp;
+			}
+
+			value_compare value_comp() const
+			{
+				return value_compare(_comp);
+			}
+
+			allocator_type get_allocator() const
+			{
+				return allocator_type(_alloc);
+			}
+
+		private:
+			bound_compare _comp;
+			allocator_type _alloc;
+			tree_type _tree;
+
+			//In-order walk of the subtree of r which skips every subtree that cannot overlap [lo, hi]:
+			//subtrees whose maximum end is before lo, and right subtrees of nodes starting after hi.
+			template <class OutputIterator>
+			void collect (node_type * r, const bound_type& lo, const bound_type& hi, OutputIterator& out)
+			{
+				if (r == NULL || _comp(r->aug, lo))
+					return;
+				collect(r->left, lo, hi, out);
+				if (_comp(hi, r->value.first.first))
+					return;
+				if (!_comp(r->value.first.second, lo))
+					*out++ = iterator(r, _tree.dummy_past_end);
+				collect(r->right, lo, hi, out);
+			}
+
+			template <class OutputIterator>
+			void collect_const (node_type * r, const bound_type& lo, const bound_type& hi, OutputIterator& out) const
+			{
+				if (r == NULL || _comp(r->aug, lo))
+					return;
+				collect_const(r->left, lo, hi, out);
+				if (_comp(hi, r->value.first.first))
+					return;
+				if (!_comp(r->value.first.second, lo))
+					*out++ = const_iterator(r, _tree.dummy_past_end);
+				collect_const(r->right, lo, hi, out);
+			}
+	};
+
+	template < class Key, class T, class Compare, class Alloc >
+	void swap (interval_map<Key, T, Compare, Alloc>& x, interval_map<Key, T, Compare, Alloc>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
@@ -530,6 +530,8 @@ namespace ft
 		public:
 			typedef typename T::value_type value_type; //value inside the node
 			typedef T* node_pointer; //pointer to the node
+			//pointer to the links of a node, or to the past-the-end sentinel which has no value
+			typedef typename choose<is_const, const typename T::links_type *, typename T::links_type *>::type links_pointer;
 			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::difference_type   difference_type;
 			typedef typename ft::iterator<ft::bidirectional_iterator_tag, value_type>::iterator_category iterator_category;
 			
@@ -542,35 +544,20 @@ namespace ft
 			///------------------///
 
 			//Default constructor
-			avl_tree_iterator(node_pointer p = 0, node_pointer dummy_past_end = 0) : _ptr(p), _dummy_past_end(dummy_past_end) {}
+			avl_tree_iterator(links_pointer p = 0, links_pointer dummy_past_end = 0) : _ptr(p), _dummy_past_end(dummy_past_end) {}
 
-			//Copy constructor
-			avl_tree_iterator(const avl_tree_iterator& r) : _ptr(r._ptr), _dummy_past_end(r._dummy_past_end) {}
-			
-			//Assignment operator overload
-			avl_tree_iterator& operator=(const avl_tree_iterator& r)
-            {
-				if (this == &r)
-					return *this;
-
-				_ptr = r._ptr;
-				_dummy_past_end = r._dummy_past_end;
-				return *this;
-            }
-			
-			//Destructor
-			virtual ~avl_tree_iterator() {}
+			//The implicit copy constructor, assignment and destructor keep the iterator two pointers wide and trivially copyable
 			
 			//Dereference, return rvalue (non assignable) pointed to by pointer
 			reference operator*() const
 			{
-				return _ptr->value;
+				return static_cast<node_pointer>(_ptr)->value;
 			}
 
 			//Return lvalue (assignable) to pointer 
 			pointer operator->() const
 			{
-				return &(_ptr->value);
+				return &(static_cast<node_pointer>(_ptr)->value);
 			}
 
 			//Prefix increment
@@ -641,9 +628,15 @@ namespace ft
 			operator avl_tree_iterator<const T, B> () const
                 { return avl_tree_iterator<const T, B>(_ptr, _dummy_past_end); }
 
+			//Links of the node pointed to, or the past-the-end sentinel
+			links_pointer base() const
+			{
+				return _ptr;
+			}
+
 		private:
-			node_pointer _ptr;
-			node_pointer _dummy_past_end;
+			links_pointer _ptr;
+			links_pointer _dummy_past_end;
 
 			node_pointer min_value_node(node_pointer node) 
 			{
@@ -670,15 +663,16 @@ namespace ft
 			
 	};
 
+	//The sentinel has no value to dereference : the iterators are compared on the links they point to
 	template<typename L, typename R, bool B_L, bool B_R>
 	bool operator==(const avl_tree_iterator<L, B_L> & lhs, const avl_tree_iterator<R, B_R> & rhs)
 	{
-			return &(*lhs) == &(*rhs);
+			return static_cast<const void *>(lhs.base()) == static_cast<const void *>(rhs.base());
 	}
 	template<typename L, typename R, bool B_L, bool B_R>
 	bool operator!=(const avl_tree_iterator<L, B_L> & lhs, const avl_tree_iterator<R, B_R> & rhs)
 	{
-			return &(*lhs) != &(*rhs);
+			return static_cast<const void *>(lhs.base()) != static_cast<const void *>(rhs.base());
 	}
 }
 
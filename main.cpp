@@ -1,6 +1,9 @@
 #include <iostream>
 #include <cassert>
 #include <deque>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
 
 #if NAMESPACE==1
 	#include <map>
@@ -11,6 +14,16 @@
 	#include "map.hpp"
 	#include "stack.hpp"
 	#include "vector.hpp"
+	#include "frozen_map.hpp"
+	#include "interval_map.hpp"
+	#include "art_map.hpp"
+	#include "small_map.hpp"
+	#include "small_vector.hpp"
+	#include "static_vector.hpp"
+	#include "mmap_allocator.hpp"
+	#include "split_map.hpp"
+	#include "parallel.hpp"
+	#include "buffered_map.hpp"
 	#define NS ft
 #endif
 
@@ -245,8 +258,32 @@ void vector_tests()
 	v2 = NS::vector<int>(arr, arr+3);
 	assert(v1 <= v2);
 	assert(v1 >= v2);
+
+	//insertions and erasures without reallocation shift the following elements
+	NS::vector<std::string> words;
+	words.reserve(10);
+	words.push_back("b");
+	words.push_back("d");
+	words.insert(words.begin(), "a");
+	words.insert(words.begin() + 2, 2, "c");
+	std::string tail[] = {"e", "f"};
+	words.insert(words.end(), tail, tail + 2);
+	assert(words.size() == 7 && words.capacity() == 10);
+	std::string expected[] = {"a", "b", "c", "c", "d", "e", "f"};
+	assert(NS::equal(words.begin(), words.end(), expected));
+	words.erase(words.begin() + 1);
+	words.erase(words.begin() + 2, words.begin() + 4);
+	assert(words.size() == 4 && words[0] == "a" && words[1] == "c" && words[2] == "e" && words[3] == "f");
+	words.insert(words.begin(), words.back()); //a copy of an element which moves
+	assert(words[0] == "f" && words[4] == "f");
 }
 
+struct no_default
+{
+	int value;
+	explicit no_default(int v) : value(v) {}
+};
+
 void map_tests()
 {
 	//empty constructor
@@ -380,6 +417,13 @@ void map_tests()
 	m.swap(m1);
 	assert(m.empty());
 
+	//iterators follow their elements into the other map, up to its end()
+	NS::map<int, int>::iterator first = m1.begin();
+	m[5] = 6;
+	m.swap(m1);
+	assert(first == m.begin() && (++first)->first == 2 && ++first == m.end() && --first == m.find(2));
+	assert(m1.size() == 1 && m1.begin()->first == 5 && ++m1.begin() == m1.end());
+
 	//clear
 	m[1] = 2;
 	m[2] = 1;
@@ -468,12 +512,1833 @@ void map_tests()
 
 	assert(m == m1);
 
+	//mapped type without default constructor, end() of an empty map
+	NS::map<int, no_default> nd;
+	assert(nd.begin() == nd.end());
+	nd.insert(NS::make_pair(2, no_default(20)));
+	nd.insert(NS::make_pair(1, no_default(10)));
+	assert(nd.find(2)->second.value == 20 && (--nd.end())->first == 2);
+	assert(nd.erase(1) == 1 && nd.count(1) == 0 && nd.size() == 1);
+}
+
+#if __cplusplus >= 201103L
+//Counts the copies and moves of its instances
+struct move_counter
+{
+	static int copies;
+	static int moves;
+	int value;
+
+	move_counter(int v = 0) : value(v) {}
+	move_counter(const move_counter& x) : value(x.value) { copies++; }
+	move_counter(move_counter&& x) noexcept : value(x.value) { moves++; }
+	move_counter& operator=(const move_counter& x) { value = x.value; copies++; return *this; }
+	move_counter& operator=(move_counter&& x) noexcept { value = x.value; moves++; return *this; }
+};
+
+int move_counter::copies = 0;
+int move_counter::moves = 0;
+
+void move_semantics_tests()
+{
+	//vector : rvalues, emplacement and reallocations do not copy
+	NS::vector<move_counter> v;
+	for (int i = 0; i < 100; i++)
+		v.push_back(move_counter(i));
+	v.emplace_back(100);
+	v.emplace(v.begin(), -1);
+	v.insert(v.begin() + 50, move_counter(49));
+	assert(v.size() == 103 && v[0].value == -1 && v[50].value == 49 && v[102].value == 100);
+	NS::vector<move_counter> moved(std::move(v));
+	assert(moved.size() == 103 && v.empty());
+	v = std::move(moved);
+	assert(v.size() == 103 && moved.empty());
+	assert(move_counter::copies == 0 && move_counter::moves > 0);
+
+	//map : elements are moved into the nodes, try_emplace leaves its arguments alone when the key is present
+	NS::map<std::string, move_counter> m;
+	std::string key = "key";
+	assert(m.emplace(key, move_counter(1)).second);
+	m[std::string(100, 'x')].value = 5;
+	assert(m.count(std::string(100, 'x')) == 1 && m[key].value == 1);
+#if NAMESPACE==0 || __cplusplus >= 201703L
+	assert(m.try_emplace(std::move(key), 3).second == false && key == "key" && m["key"].value == 1);
+	assert(m.try_emplace("new", 4).second && m["new"].value == 4);
+	assert(m.insert_or_assign(key, move_counter(6)).second == false && m[key].value == 6);
+	assert(m.insert_or_assign("third", move_counter(7)).second && m.size() == 4);
+#else
+	m.emplace("new", 4);
+	m.emplace("third", 7);
+#endif
+	NS::map<std::string, move_counter>::iterator element = m.find("third");
+	NS::map<std::string, move_counter> moved_map(std::move(m));
+	assert(moved_map.size() == 4 && m.empty());
+	assert(++element == moved_map.find(std::string(100, 'x')) && ++element == moved_map.end());
+	element = moved_map.find("third");
+	m = std::move(moved_map);
+	assert(m.size() == 4 && m["third"].value == 7 && moved_map.empty());
+	assert(++element == m.find(std::string(100, 'x')) && ++element == m.end());
+	assert(move_counter::copies == 0);
+
+	//stack
+	NS::stack<move_counter> s;
+	s.push(move_counter(1));
+	s.emplace(2);
+	assert(s.size() == 2 && s.top().value == 2 && move_counter::copies == 0);
+}
+#endif
+
+#if NAMESPACE==0
+//Tests of the ft-only extensions, which have no std equivalent
+//Opts in to memmove relocation
+struct relocatable_counter
+{
+	int * count;
+	relocatable_counter(int * c = NULL) : count(c) { if (count) ++*count; }
+	relocatable_counter(const relocatable_counter& x) : count(x.count) { if (count) ++*count; }
+	~relocatable_counter() { if (count) --*count; }
+};
+
+namespace ft
+{
+	template <>
+	struct is_trivially_relocatable<relocatable_counter> : public ft::integral_constant<bool, true> {};
+}
+
+//Counts its live objects. Copying one whose value is poison throws once poison_copies_left copies of it were made.
+struct throwing_counter
+{
+	static int live;
+	static int poison;
+	static int poison_copies_left;
+	int value;
+
+	throwing_counter(int v = 0) : value(v) { live++; }
+	throwing_counter(const throwing_counter& x) : value(x.value)
+	{
+		if (value == poison && poison_copies_left-- == 0)
+			throw std::runtime_error("throwing_counter copy");
+		live++;
+	}
+	~throwing_counter() { live--; }
+};
+
+int throwing_counter::live = 0;
+int throwing_counter::poison = -1;
+int throwing_counter::poison_copies_left = 0;
+
+//An insertion whose copies throw midway leaves the vector with its elements, and destroys the ones it built
+template <class Vector>
+void insertion_rollback_tests()
+{
+	{
+		Vector v;
+		for (int i = 0; i < 4; i++)
+			v.push_back(throwing_counter(i));
+		const throwing_counter range[3] = {throwing_counter(10), throwing_counter(-1), throwing_counter(11)};
+		for (int position = 0; position <= 4; position += 2)
+		{
+			bool thrown = false;
+			throwing_counter::poison_copies_left = 0;
+			try { v.insert(v.begin() + position, range, range + 3); } catch (std::runtime_error&) { thrown = true; }
+			assert(thrown && v.size() == 4 && throwing_counter::live == 7);
+			thrown = false;
+			throwing_counter::poison_copies_left = 2; //the copy of val, the first element, then the second one throws
+			try { v.insert(v.begin() + position, 3, range[1]); } catch (std::runtime_error&) { thrown = true; }
+			assert(thrown && v.size() == 4 && throwing_counter::live == 7);
+			for (int i = 0; i < 4; i++)
+				assert(v[i].value == i);
+		}
+		v.insert(v.begin() + 1, range, range + 1);
+		assert(v.size() == 5 && v[1].value == 10 && v[2].value == 1 && throwing_counter::live == 8);
+	}
+	assert(throwing_counter::live == 0);
+}
+
+void vector_relocation_tests()
+{
+	assert(ft::is_trivially_copyable<int>::value && ft::is_trivially_relocatable<int>::value);
+	assert(!ft::is_trivially_copyable<std::string>::value && !ft::is_trivially_relocatable<std::string>::value);
+	assert(!ft::is_trivially_destructible<relocatable_counter>::value && ft::is_trivially_relocatable<relocatable_counter>::value);
+
+	//relocating does not copy nor destroy : the live objects are counted exactly
+	int live = 0;
+	{
+		ft::vector<relocatable_counter> v;
+		for (int i = 0; i < 100; i++)
+			v.push_back(relocatable_counter(&live));
+		assert(live == 100);
+		v.insert(v.begin() + 10, 5, relocatable_counter(&live));
+		v.erase(v.begin(), v.begin() + 20);
+		v.erase(v.begin() + 3);
+		assert(live == 84 && v.size() == 84);
+		v.resize(10);
+		assert(live == 10);
+	}
+	assert(live == 0);
+	insertion_rollback_tests< ft::vector<throwing_counter> >();
+
+	ft::vector<int> ints;
+	std::deque<int> reference;
+	for (int i = 0; i < 1000; i++)
+	{
+		ints.insert(ints.begin() + ints.size() / 2, i);
+		reference.insert(reference.begin() + reference.size() / 2, i);
+	}
+	ft::vector<int> copy(ints);
+	assert(copy == ints && ft::equal(copy.begin(), copy.end(), reference.begin()));
+	copy.erase(copy.begin() + 100, copy.begin() + 900);
+	assert(copy.size() == 200 && copy[99] == ints[99] && copy[100] == ints[900]);
+}
+
+//Fills a vector with single-element insertions at pos (0 : front, 1 : middle, 2 : end) and returns the number of reallocations
+template <class Vector>
+int count_reallocations(Vector& v, int pos, int count)
+{
+	int reallocations = 0;
+	for (int i = 0; i < count; i++)
+	{
+		typename Vector::size_type capacity = v.capacity();
+		typename Vector::iterator where = pos == 0 ? v.begin() : pos == 1 ? v.begin() + v.size() / 2 : v.end();
+		v.insert(where, i);
+		assert(v.capacity() >= v.size());
+		if (v.capacity() != capacity)
+			reallocations++;
+	}
+	return reallocations;
+}
+
+void vector_growth_tests()
+{
+	//the policies
+	assert(ft::grow_double::next_capacity(0, 1, 100, 4) == 1);
+	assert(ft::grow_double::next_capacity(8, 9, 100, 4) == 16);
+	assert(ft::grow_double::next_capacity(8, 40, 100, 4) == 40);
+	assert(ft::grow_double::next_capacity(80, 81, 100, 4) == 100);
+	assert(ft::grow_one_and_half::next_capacity(1, 2, 100, 4) == 2);
+	assert(ft::grow_one_and_half::next_capacity(8, 9, 100, 4) == 12);
+	assert(ft::grow_one_and_half::next_capacity(90, 91, 100, 4) == 100);
+	assert(ft::grow_size_class::next_capacity(0, 1, 100, 4) == 4); //16 bytes
+	assert(ft::grow_size_class::next_capacity(100, 101, 1000, 4) == 160); //600 bytes in the 640 class
+	assert(ft::grow_size_class::next_capacity(100, 101, 150, 4) == 150);
+	assert(ft::grow_size_class::next_capacity(0, 7, 100, 12) == 8); //84 bytes in the 96 class
+
+	//insertions anywhere reallocate geometrically
+	for (int pos = 0; pos < 3; pos++)
+	{
+		ft::vector<int> doubling;
+		assert(count_reallocations(doubling, pos, 1000) == 11);
+		ft::vector<int, std::allocator<int>, ft::grow_one_and_half> one_and_half;
+		assert(count_reallocations(one_and_half, pos, 1000) == 18);
+		ft::vector<int, std::allocator<int>, ft::grow_size_class> size_class;
+		assert(count_reallocations(size_class, pos, 1000) <= 18);
+		assert(doubling == ft::vector<int>(one_and_half.begin(), one_and_half.end()));
+		assert(ft::equal(doubling.begin(), doubling.end(), size_class.begin()));
+	}
+
+	//so do range insertions, resize and assign
+	int values[] = {1, 2, 3, 4, 5};
+	ft::vector<int> v(values, values + 5);
+	v.insert(v.begin() + 2, values, values + 2);
+	assert(v.size() == 7 && v.capacity() == 10);
+	v.resize(11);
+	assert(v.size() == 11 && v.capacity() == 20 && v[10] == 0);
+	v.assign(30, 7);
+	assert(v.size() == 30 && v.capacity() == 40);
+	v.assign(values, values + 5);
+	assert(v.size() == 5 && v.capacity() == 40);
+	ft::vector<int> fresh;
+	fresh.assign(values, values + 5);
+	assert(fresh.capacity() == 5);
+	fresh.resize(6);
+	assert(fresh.capacity() == 10);
+}
+
+//std::allocator counting the allocations of all its instances
+int g_allocations = 0;
+
+template <class T>
+struct counting_allocator : public std::allocator<T>
+{
+	template <class U>
+	struct rebind
+	{
+		typedef counting_allocator<U> other;
+	};
+
+	counting_allocator() {}
+
+	template <class U>
+	counting_allocator(const counting_allocator<U>&) {}
+
+	T * allocate(std::size_t n, const void * = 0)
+	{
+		g_allocations++;
+		return std::allocator<T>::allocate(n);
+	}
+};
+
+//Allocator carrying an id, to check which allocator a container keeps
+template <class T>
+struct tagged_allocator : public std::allocator<T>
+{
+	int id;
+
+	template <class U>
+	struct rebind
+	{
+		typedef tagged_allocator<U> other;
+	};
+
+	tagged_allocator(int i = 0) : id(i) {}
+
+	template <class U>
+	tagged_allocator(const tagged_allocator<U>& x) : std::allocator<T>(), id(x.id) {}
+};
+
+//Allocator which fails once g_allocations_left allocations were made, and counts the blocks in use, from any thread
+pthread_mutex_t g_limited_lock = PTHREAD_MUTEX_INITIALIZER;
+int g_allocations_left = -1; //no limit
+int g_blocks_in_use = 0;
+
+template <class T>
+struct limited_allocator : public std::allocator<T>
+{
+	template <class U>
+	struct rebind
+	{
+		typedef limited_allocator<U> other;
+	};
+
+	limited_allocator() {}
+
+	template <class U>
+	limited_allocator(const limited_allocator<U>&) {}
+
+	T * allocate(std::size_t n, const void * = 0)
+	{
+		pthread_mutex_lock(&g_limited_lock);
+		bool fail = (g_allocations_left == 0);
+		if (!fail)
+		{
+			if (g_allocations_left > 0)
+				g_allocations_left--;
+			g_blocks_in_use++;
+		}
+		pthread_mutex_unlock(&g_limited_lock);
+		if (fail)
+			throw std::bad_alloc();
+		return std::allocator<T>::allocate(n);
+	}
+
+	void deallocate(T * p, std::size_t n)
+	{
+		pthread_mutex_lock(&g_limited_lock);
+		g_blocks_in_use--;
+		pthread_mutex_unlock(&g_limited_lock);
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+//Factory of find_or_insert counting its calls
+struct string_factory
+{
+	int * calls;
+
+	std::string operator()() const
+	{
+		(*calls)++;
+		return "made";
+	}
+};
+
+void map_find_or_insert_tests()
+{
+	typedef ft::map<int, std::string, std::less<int>, counting_allocator<ft::TreeNode<ft::pair<const int, std::string> > > > counted_map;
+	counted_map m;
+	int calls = 0;
+	string_factory factory = {&calls};
+	int allocations = g_allocations;
+	assert(m.find_or_insert(1, factory).second && m[1] == "made" && calls == 1 && g_allocations == allocations + 2); //node and past-the-end
+
+	//hits neither allocate nor call the factory
+	assert(m.find_or_insert(1, factory).second == false && m.find_or_insert(1, factory).first->second == "made" && calls == 1);
+	m[1] = "assigned";
+	assert(m.insert(ft::make_pair(1, std::string("ignored"))).second == false && m[1] == "assigned");
+	assert(g_allocations == allocations + 2);
+
+	//misses link the new node where the search ended, keeping the tree sorted and balanced through erasures
+	srand(11);
+	bool present[1000] = {false};
+	present[1] = true;
+	for (int i = 0; i < 20000; i++)
+	{
+		int k = rand() % 1000;
+		if (rand() % 3 == 0)
+		{
+			assert(m.erase(k) == (present[k] ? 1u : 0u));
+			present[k] = false;
+			continue;
+		}
+		if (i % 2 == 0)
+			assert(m.find_or_insert(k, factory).second == !present[k]);
+		else
+			assert(m.insert(ft::make_pair(k, std::string("inserted"))).second == !present[k]);
+		present[k] = true;
+	}
+	std::size_t expected = 0;
+	counted_map::iterator it = m.begin();
+	for (int k = 0; k < 1000; k++)
+	{
+		if (!present[k])
+			continue;
+		expected++;
+		assert(it->first == k);
+		++it;
+	}
+	assert(it == m.end() && m.size() == expected && (--m.end())->first == m.rbegin()->first);
+	assert(g_allocations - allocations >= static_cast<int>(expected) && calls > 1);
+}
+
+void map_node_handle_tests()
+{
+	typedef counting_allocator<ft::TreeNode<ft::pair<const int, std::string> > > allocator;
+	typedef ft::map<int, std::string, std::less<int>, allocator> counted_map;
+	counted_map source;
+	counted_map target;
+	for (int i = 0; i < 100; i++)
+		source[i] = "value";
+
+	//extracting and inserting moves the node itself
+	int allocations = g_allocations;
+	std::string * element = &source[42];
+	counted_map::node_handle nh = source.extract(42);
+	assert(!nh.empty() && nh.key() == 42 && &nh.mapped() == element && source.size() == 99 && source.count(42) == 0);
+	counted_map::insert_return_type inserted = target.insert(nh);
+	assert(nh.empty() && inserted.inserted && inserted.node.empty() && &inserted.position->second == element);
+	assert(source.extract(42).empty() && target.insert(source.extract(42)).position == target.end());
+
+	//copies transfer the node, and a node whose key is present comes back in the result
+	counted_map::node_handle first = source.extract(source.begin());
+	counted_map::node_handle copy(first);
+	assert(first.empty() && copy.key() == 0);
+	target[0] = "present";
+	counted_map::insert_return_type refused = target.insert(copy);
+	assert(!refused.inserted && !refused.node.empty() && refused.node.key() == 0 && refused.position->second == "present");
+
+	//rekeying
+	refused.node.key() = 1000;
+	refused.node.mapped() = "rekeyed";
+	assert(target.insert(target.end(), refused.node)->second == "rekeyed" && (--target.end())->first == 1000);
+	assert(g_allocations == allocations + 2); //past-the-end of target, target[0]
+
+	//merge takes the nodes of the keys which are not present, even from a map ordered differently
+	ft::map<int, std::string, std::greater<int>, allocator> reversed;
+	for (int i = 95; i < 110; i++)
+		reversed[i] = "reversed";
+	allocations = g_allocations;
+	target.merge(source);
+	target.merge(reversed);
+	assert(g_allocations == allocations);
+	assert(source.empty() && reversed.size() == 5 && reversed.begin()->first == 99 && (--reversed.end())->first == 95);
+	assert(target.size() == 111 && target[99] == "value" && target[109] == "reversed" && target[0] == "present");
+	int expected = 0;
+	for (counted_map::iterator it = target.begin(); it != target.end(); ++it, expected++)
+		assert(it->first == (expected <= 109 ? expected : 1000));
+
+	//nodes of a compacted map are copied out of its block once
+	target.compact();
+	counted_map::node_handle from_block = target.extract(50);
+	assert(from_block.mapped() == "value" && target.size() == 110 && target.count(51) == 1);
+	target.erase(51);
+	assert(target.insert(from_block).inserted && target[50] == "value");
+
+	//a changed key gets its cache recomputed
+	typedef ft::map<std::string, int, std::less<std::string>, std::allocator<ft::TreeNode<ft::pair<const std::string, int> > >, ft::key_prefix_cache> prefix_map;
+	prefix_map prefixes;
+	prefixes["aaaaaaaaaa"] = 1;
+	prefixes["mmmmmmmmmm"] = 2;
+	prefix_map::node_handle renamed = prefixes.extract("aaaaaaaaaa");
+	renamed.key() = "zzzzzzzzzz";
+	prefixes.insert(renamed);
+	assert(prefixes.begin()->first == "mmmmmmmmmm" && prefixes.find("zzzzzzzzzz")->second == 1 && prefixes.count("aaaaaaaaaa") == 0);
+}
+
+void small_vector_tests()
+{
+	typedef ft::small_vector<std::string, 4, counting_allocator<std::string> > small;
+
+	//up to N elements stay inline, without allocating
+	int allocations = g_allocations;
+	small v;
+	assert(v.empty() && v.is_inline() && v.capacity() == 4 && v.begin() == v.end());
+	v.push_back("b");
+	v.insert(v.begin(), "a");
+	v.insert(v.end(), 2, "c");
+	assert(v.size() == 4 && v.is_inline() && v[0] == "a" && v.back() == "c" && g_allocations == allocations);
+	small copy(v);
+	assert(copy == v && copy.is_inline() && g_allocations == allocations);
+	v.erase(v.begin() + 1);
+	assert(v.size() == 3 && v[1] == "c" && copy < v);
+
+	//the element after N moves them all to the heap, where they stay
+	v.push_back(v[0]);
+	v.push_back("e");
+	assert(v.size() == 5 && !v.is_inline() && v.capacity() == 8 && g_allocations == allocations + 1);
+	assert(v[3] == "a" && v.at(4) == "e" && *v.rbegin() == "e");
+	v.clear();
+	assert(v.empty() && !v.is_inline() && v.capacity() == 8);
+
+	//swaps exchange heap blocks, or move inline elements
+	v.assign(6, "x");
+	small heap(7, "y");
+	v.swap(heap);
+	assert(v.size() == 7 && heap.size() == 6 && heap[5] == "x");
+	v.swap(copy);
+	assert(v.size() == 4 && v.is_inline() && v[1] == "b" && copy.size() == 7 && copy[6] == "y");
+	ft::swap(v, copy);
+	assert(v.size() == 7 && copy.size() == 4 && copy.is_inline() && copy.front() == "a");
+
+	//same results as ft::vector
+	srand(15);
+	ft::small_vector<int, 8> ints;
+	ft::vector<int> reference;
+	for (int i = 0; i < 3000; i++)
+	{
+		int op = rand() % 4;
+		if (op == 0 && !reference.empty())
+		{
+			std::size_t at = rand() % reference.size();
+			ints.erase(ints.begin() + at);
+			reference.erase(reference.begin() + at);
+		}
+		else if (op == 1)
+		{
+			std::size_t at = reference.empty() ? 0 : rand() % reference.size();
+			ints.insert(ints.begin() + at, i);
+			reference.insert(reference.begin() + at, i);
+		}
+		else
+		{
+			ints.push_back(i);
+			reference.push_back(i);
+		}
+		if (i % 500 == 0)
+			ints.resize(3), reference.resize(3);
+		assert(ints.size() == reference.size());
+	}
+	assert(ft::equal(ints.begin(), ints.end(), reference.begin()));
+
+	//as the container of a stack
+	ft::stack<int, ft::small_vector<int, 4> > stack;
+	for (int i = 0; i < 10; i++)
+		stack.push(i);
+	assert(stack.size() == 10 && stack.top() == 9);
+	stack.pop();
+	assert(stack.top() == 8);
+
+	//insertions which throw midway, inline and on the heap
+	insertion_rollback_tests< ft::small_vector<throwing_counter, 8> >();
+	insertion_rollback_tests< ft::small_vector<throwing_counter, 2> >();
+}
+
+void static_vector_tests()
+{
+	typedef ft::static_vector<int, 8> ints;
+	assert(ft::is_trivially_copyable<ints>::value && ft::is_trivially_relocatable<ints>::value);
+	typedef ft::static_vector<std::string, 4> strings_type;
+	typedef ft::static_vector<relocatable_counter, 6> counters_type;
+	assert(!ft::is_trivially_copyable<strings_type>::value && ft::is_trivially_relocatable<counters_type>::value);
+
+	//filling up to the capacity, beyond which the checked modifiers throw
+	ints v;
+	for (int i = 0; i < 7; i++)
+		v.push_back_unchecked(i);
+	v.push_back(7);
+	assert(v.full() && v.size() == 8 && v.capacity() == 8 && v.back() == 7 && v[3] == 3);
+	bool thrown = false;
+	try { v.push_back(8); } catch (std::length_error&) { thrown = true; }
+	assert(thrown && v.size() == 8);
+	thrown = false;
+	try { v.insert(v.begin(), 1, 0); } catch (std::length_error&) { thrown = true; }
+	assert(thrown && v.size() == 8 && v.front() == 0);
+	ints copy = v;
+	v.erase(v.begin() + 2, v.begin() + 5);
+	assert(v.size() == 5 && v[2] == 5 && copy.size() == 8 && copy[2] == 2 && v > copy);
+	v.insert(v.begin(), -1);
+	assert(v.front() == -1 && v.size() == 6);
+
+	//elements which are not trivially copyable are copied, swapped and destroyed one by one
+	int live = 0;
+	{
+		counters_type counters(4, relocatable_counter(&live));
+		counters_type other(counters);
+		other.resize(6, relocatable_counter(&live));
+		assert(live == 10);
+		counters.swap(other);
+		assert(counters.size() == 6 && other.size() == 4 && live == 10);
+		other.erase(other.begin());
+		other = counters;
+		assert(live == 12);
+		counters.clear();
+		assert(live == 6);
+	}
+	assert(live == 0);
+	strings_type strings(2, "long enough to be allocated by the string");
+	strings_type more;
+	more.push_back("a");
+	more.insert(more.begin(), "b");
+	more.insert(more.end(), strings.begin(), strings.end());
+	ft::swap(more, strings);
+	assert(strings.size() == 4 && strings[0] == "b" && strings[3] == more[1] && more.size() == 2);
+	strings.assign(3, strings[1]);
+	assert(strings.size() == 3 && strings[2] == "a");
+
+	//as the container of a stack
+	ft::stack<int, ft::static_vector<int, 16> > stack;
+	for (int i = 0; i < 16; i++)
+		stack.push(i);
+	stack.pop();
+	assert(stack.size() == 15 && stack.top() == 14);
+
+	insertion_rollback_tests< ft::static_vector<throwing_counter, 16> >();
+}
+
+//ft algorithms against the std ones, on ranges of every length up to a few blocks, with some equal values
+template <class T>
+void simd_range_tests()
+{
+	for (int n = 0; n < 300; n += 1 + n / 8)
+	{
+		ft::vector<T> a;
+		for (int i = 0; i < n; i++)
+			a.push_back(static_cast<T>((rand() % 16) * 37 - 200));
+		std::deque<T> ref(a.begin(), a.end());
+		T val = static_cast<T>((rand() % 16) * 37 - 200);
+		assert(ft::find(a.begin(), a.end(), val) - a.begin() == std::find(ref.begin(), ref.end(), val) - ref.begin());
+		assert(ft::count(a.begin(), a.end(), val) == static_cast<std::size_t>(std::count(ref.begin(), ref.end(), val)));
+		assert(ft::min_element(a.begin(), a.end()) - a.begin() == std::min_element(ref.begin(), ref.end()) - ref.begin());
+		assert(ft::max_element(a.begin(), a.end()) - a.begin() == std::max_element(ref.begin(), ref.end()) - ref.begin());
+		assert(ft::accumulate(a.begin(), a.end(), val) == std::accumulate(ref.begin(), ref.end(), val));
+
+		ft::vector<T> b(a);
+		assert(a == b && !(a < b) && ft::equal(a.begin(), a.end(), b.begin()));
+		if (n == 0)
+			continue;
+		int at = rand() % n;
+		b[at] = static_cast<T>(b[at] + 1);
+		std::deque<T> ref_b(b.begin(), b.end());
+		assert(!(a == b) && ft::equal(a.begin(), a.begin() + at, b.begin()) && !ft::equal(a.begin(), a.end(), b.begin()));
+		assert((a < b) == std::lexicographical_compare(ref.begin(), ref.end(), ref_b.begin(), ref_b.end()));
+		assert((b < a) == std::lexicographical_compare(ref_b.begin(), ref_b.end(), ref.begin(), ref.end()));
+		assert(ft::lexicographical_compare(a.begin(), a.begin() + at, b.begin(), b.end()));
+		assert(!ft::lexicographical_compare(a.begin(), a.end(), a.begin(), a.begin() + at));
+	}
+}
+
+void simd_tests()
+{
+	ft::simd_level detected = ft::get_simd_level();
+	for (int level = ft::simd_scalar; level <= detected; level++)
+	{
+		ft::set_simd_level(static_cast<ft::simd_level>(level));
+		assert(ft::get_simd_level() == level);
+		srand(16 + level);
+		simd_range_tests<char>();
+		simd_range_tests<signed char>();
+		simd_range_tests<unsigned char>();
+		simd_range_tests<short>();
+		simd_range_tests<unsigned short>();
+		simd_range_tests<int>();
+		simd_range_tests<unsigned int>();
+		simd_range_tests<long long>();
+		simd_range_tests<unsigned long>();
+	}
+	ft::set_simd_level(ft::simd_avx2);
+	assert(ft::get_simd_level() == detected);
+
+	//counts beyond what a lane holds
+	ft::vector<unsigned char> bytes(100000, 7);
+	bytes[99999] = 8;
+	assert(ft::count(bytes.begin(), bytes.end(), 7) == 99999 && ft::count(bytes.begin(), bytes.end(), static_cast<unsigned char>(7)) == 99999);
+	assert(*ft::max_element(bytes.begin(), bytes.end()) == 8 && ft::min_element(bytes.begin(), bytes.end()) == bytes.begin());
+
+	//values of another type than the elements, pointers, and the types which keep the scalar loops
+	assert(ft::find(bytes.begin(), bytes.end(), 263) == bytes.end());
+	assert(ft::accumulate(bytes.begin(), bytes.begin() + 1000, 0L) == 7000);
+	const int ints[] = {3, 1, 4, 1, 5, 9, 2, 6};
+	assert(ft::find(ints, ints + 8, 9) == ints + 5 && *ft::min_element(ints, ints + 8) == 1 && ft::accumulate(ints, ints + 8, 0) == 31);
+	double doubles[] = {1.5, -0.0, 0.0, 2.5};
+	assert(ft::find(doubles, doubles + 4, 0.0) == doubles + 1 && ft::accumulate(doubles, doubles + 4, 0.0) == 4.0);
+	ft::vector<bool> flags(10, false);
+	flags[4] = true;
+	assert(ft::find(flags.begin(), flags.end(), true) - flags.begin() == 4 && ft::count(flags.begin(), flags.end(), false) == 9);
+}
+
+void vector_bool_check(const ft::vector<bool>& v, const std::deque<bool>& ref)
+{
+	assert(v.size() == ref.size() && ft::equal(v.begin(), v.end(), ref.begin()));
+	assert(v.count() == static_cast<size_t>(std::count(ref.begin(), ref.end(), true)));
+	size_t expected = std::find(ref.begin(), ref.end(), true) - ref.begin();
+	for (size_t pos = v.find_first(); ; pos = v.find_next(pos))
+	{
+		assert(pos == expected);
+		if (pos == v.size())
+			break;
+		expected = std::find(ref.begin() + pos + 1, ref.end(), true) - ref.begin();
+	}
+}
+
+void vector_bool_tests()
+{
+	//packing, proxies, and the bits past the size kept at 0
+	ft::vector<bool> v(130, true);
+	assert(v.size() == 130 && v.capacity() == 192 && v.count() == 130 && v.words()[2] == 3);
+	v[1] = false;
+	v[2] = v[1];
+	v[3].flip();
+	assert(!v[1] && !v[2] && !v[3] && ~v[1] && v.count() == 127 && v.find_first() == 0 && v.find_next(0) == 4);
+	ft::vector<bool>::swap(v[0], v[1]);
+	assert(!v[0] && v[1] && v.front() == false && v.back() == true);
+	v.resize(65);
+	assert(v.words()[1] == 1 && v.count() == 62);
+	v.flip();
+	assert(v.count() == 3 && v.find_first() == 0 && v.find_next(0) == 2 && v.find_next(2) == 3 && v.find_next(3) == 65);
+	v.resize(200, true);
+	assert(v.count() == 138 && v.find_next(64) == 65);
+	try { v.at(200); assert(false); } catch (std::out_of_range&) {}
+	const ft::vector<bool>& cv = v;
+	assert(cv[199] && cv.at(199) && *(cv.end() - 1) && cv.rbegin()[0] && cv.rend()[-1] && !cv.rend()[-2]);
+	assert(cv.end() - cv.begin() == 200 && v.begin() + 64 < cv.begin() + 65 && (cv.begin() + 70) - 70 == v.begin());
+	assert(v.end()[-135] && !v.begin()[64] && 3 + v.begin() == v.begin() + 3);
+
+	//random operations against a reference, each simd level running the bit scans and the bitwise operators
+	ft::simd_level detected = ft::get_simd_level();
+	for (int level = ft::simd_scalar; level <= detected; level++)
+	{
+		ft::set_simd_level(static_cast<ft::simd_level>(level));
+		srand(48 + level);
+		ft::vector<bool> bits;
+		std::deque<bool> ref;
+		for (int i = 0; i < 3000; i++)
+		{
+			int op = rand() % 10;
+			bool val = rand() % 4 == 0;
+			size_t pos = ref.empty() ? 0 : rand() % (ref.size() + 1);
+			if (op < 5)
+			{
+				bits.push_back(val);
+				ref.push_back(val);
+			}
+			else if (op == 5)
+			{
+				size_t n = rand() % 100;
+				bits.insert(bits.begin() + pos, n, val);
+				ref.insert(ref.begin() + pos, n, val);
+			}
+			else if (op == 6 && pos < ref.size())
+			{
+				size_t n = rand() % (ref.size() - pos + 1);
+				assert(bits.erase(bits.begin() + pos, bits.begin() + pos + n) == bits.begin() + pos);
+				ref.erase(ref.begin() + pos, ref.begin() + pos + n);
+			}
+			else if (op == 7 && !ref.empty())
+			{
+				bits.pop_back();
+				ref.pop_back();
+			}
+			else if (op == 8)
+			{
+				assert(*bits.insert(bits.begin() + pos, val) == val);
+				ref.insert(ref.begin() + pos, val);
+			}
+			else if (pos < ref.size())
+			{
+				bits[pos] = !bits[pos];
+				ref[pos] = !ref[pos];
+			}
+			if (i % 100 == 0)
+				vector_bool_check(bits, ref);
+		}
+		vector_bool_check(bits, ref);
+
+		std::deque<bool> other_ref;
+		for (size_t i = 0; i < ref.size(); i++)
+			other_ref.push_back(rand() % 3 == 0);
+		ft::vector<bool> other(other_ref.begin(), other_ref.end());
+		ft::vector<bool> copy(bits);
+		std::deque<bool> expected(ref);
+		copy &= other;
+		for (size_t i = 0; i < ref.size(); i++)
+			expected[i] = ref[i] && other_ref[i];
+		vector_bool_check(copy, expected);
+		copy = bits;
+		copy |= other;
+		for (size_t i = 0; i < ref.size(); i++)
+			expected[i] = ref[i] || other_ref[i];
+		vector_bool_check(copy, expected);
+		copy = bits;
+		copy ^= other;
+		for (size_t i = 0; i < ref.size(); i++)
+			expected[i] = ref[i] != other_ref[i];
+		vector_bool_check(copy, expected);
+		copy ^= other;
+		assert(copy == bits && !(copy != bits) && !(copy < bits));
+		copy.flip();
+		assert(copy.count() == copy.size() - bits.count() && copy != bits);
+		other.push_back(true);
+		try { copy &= other; assert(false); } catch (std::invalid_argument&) {}
+	}
+	ft::set_simd_level(ft::simd_avx2);
+
+	//comparisons, assignments, and a run of words at 0 before the first true bit
+	ft::vector<bool> a(1000, false), b(1000, false);
+	a[999] = true;
+	assert(a.find_first() == 999 && a.find_next(999) == 1000 && b.find_first() == 1000 && b < a && a != b);
+	b.assign(64, true);
+	assert(b.size() == 64 && b.count() == 64 && b.words()[1] == 0 && b.words()[15] == 0);
+	b.clear();
+	assert(b.empty() && b.count() == 0 && b.find_first() == 0 && b.words()[0] == 0);
+	b = a;
+	b.reserve(5000);
+	assert(b == a && b.capacity() == 5056);
+	a.swap(b);
+	ft::swap(a, b);
+	assert(a == b && a.size() == 1000);
+}
+
+void mmap_allocator_tests()
+{
+	//ints grow in place : with realloc while small, then in mapped pages grown by mremap
+	typedef ft::vector<int, ft::mmap_allocator<int> > mapped_ints;
+	mapped_ints v;
+	for (int i = 0; i < 1000000; i++)
+	{
+		v.push_back(i);
+		assert(v.capacity() >= v.size() && v[i / 2] == i / 2);
+	}
+	v.insert(v.begin() + 10, 1000000, -1);
+	assert(v.size() == 2000000 && v[9] == 9 && v[10] == -1 && v[1000009] == -1 && v[1000010] == 10 && v.back() == 999999);
+	v.erase(v.begin() + 10, v.begin() + 1000010);
+	for (int i = 0; i < 1000000; i++)
+		assert(v[i] == i);
+	mapped_ints copy(v);
+	assert(copy == v);
+	copy.assign(10, 3);
+	copy = v;
+	assert(copy == v);
+	copy.reserve(3000000);
+	assert(copy.capacity() >= 3000000 && copy == v);
+
+	//the capacity covers the whole block : the size class of malloc, the pages of a mapping
+	ft::mmap_allocator<char> alloc;
+	std::size_t n = 100;
+	char * p = alloc.allocate_at_least(n);
+	assert(n >= 100);
+	std::memset(p, 1, n);
+	std::size_t m = 5000;
+	p = alloc.reallocate(p, n, m);
+	assert(m >= 5000 && p[99] == 1);
+	std::size_t big = ft::mmap_allocator<char>::mmap_threshold + 1;
+	std::memset(p, 2, m);
+	p = alloc.reallocate(p, m, big);
+	assert(big > ft::mmap_allocator<char>::mmap_threshold + 1 && p[4999] == 2);
+	alloc.deallocate(p, big);
+
+	//strings are not relocatable : they are moved to new blocks
+	ft::vector<std::string, ft::mmap_allocator<std::string> > strings;
+	for (int i = 0; i < 100000; i++)
+		strings.push_back(std::string(i % 50, 'a' + i % 26));
+	for (int i = 0; i < 100000; i++)
+		assert(strings[i] == std::string(i % 50, 'a' + i % 26));
+	ft::vector<bool, ft::mmap_allocator<bool> > bits(20000000, true);
+	bits.push_back(false);
+	assert(bits.count() == 20000000 && !bits.back());
 }
 
+void vector_uninitialized_tests()
+{
+	//default-initialized elements : strings are constructed, chars are left to be written
+	ft::vector<std::string> strings(2, "kept");
+	strings.resize_default_init(5);
+	assert(strings.size() == 5 && strings[1] == "kept" && strings[4].empty());
+	strings.resize_default_init(1);
+	assert(strings.size() == 1 && strings[0] == "kept");
+	ft::vector<char> bytes;
+	bytes.resize_default_init(100);
+	assert(bytes.size() == 100 && bytes.capacity() >= 100);
+	std::memset(&bytes[0], 'x', 100);
+
+	//appends written in place, then committed
+	const char text[] = "0123456789";
+	for (int i = 0; i < 50; i++)
+	{
+		char * room = bytes.append_uninitialized(10);
+		assert(room == &bytes[0] + bytes.size() && bytes.capacity() - bytes.size() >= 10);
+		std::memcpy(room, text, 10);
+		bytes.commit(i % 2 == 0 ? 10 : 5);
+	}
+	assert(bytes.size() == 475 && bytes[99] == 'x' && bytes[100] == '0' && bytes[474] == '4');
+	bytes.append_uninitialized(0);
+	try { bytes.commit(bytes.capacity() - bytes.size() + 1); assert(false); } catch (std::length_error&) {}
+	try { bytes.append_uninitialized(bytes.max_size()); assert(false); } catch (std::length_error&) {}
+	assert(bytes.size() == 475);
+
+	//a constructed element, counted like a written one
+	std::string * slot = strings.append_uninitialized(1);
+	new (static_cast<void *>(slot)) std::string("built");
+	strings.commit(1);
+	assert(strings.size() == 2 && strings.back() == "built");
+}
+
+void frozen_map_tests()
+{
+	//build from a map
+	ft::map<int, int> m;
+	for (int i = 0; i < 1000; i++)
+		m[i * 7] = i;
+	ft::frozen_map<int, int> f(m);
+	assert(f.size() == 1000);
+	for (int i = 0; i < 1000; i++)
+		assert(f.at(i * 7) == i);
+	assert(f.find(3) == f.end());
+	assert(f.count(14) == 1 && f.count(15) == 0);
+
+	//range constructor with string keys
+	NS::pair<std::string, int> arr[] = {NS::make_pair(std::string("fr"), 33), NS::make_pair(std::string("de"), 49), NS::make_pair(std::string("it"), 39)};
+	ft::frozen_map<std::string, int> codes(arr, arr + 3);
+	assert(codes.at("de") == 49);
+	assert(codes.find("es") == codes.end());
+
+	//duplicate keys are rejected
+	NS::pair<int, int> dup[] = {NS::make_pair(1, 1), NS::make_pair(1, 2)};
+	try {
+		ft::frozen_map<int, int> bad(dup, dup + 2);
+		assert(false);
+	} catch (const std::invalid_argument& e) {}
+
+	//serialization round trip
+	std::string blob;
+	codes.serialize(blob);
+	ft::frozen_map<std::string, int> loaded;
+	loaded.load(blob.data(), blob.size());
+	assert(loaded.size() == 3);
+	assert(loaded.at("fr") == 33 && loaded.at("it") == 39);
+	try {
+		loaded.load(blob.data(), blob.size() - 1);
+		assert(false);
+	} catch (const std::invalid_argument& e) {}
+	assert(loaded.size() == 3);
+
+	//empty table
+	ft::frozen_map<int, int> empty;
+	assert(empty.empty() && empty.find(1) == empty.end());
+}
+
+void interval_map_tests()
+{
+	typedef ft::interval_map<int, int> imap;
+
+	imap im;
+	im.insert(1, 5, 0);
+	im.insert(10, 20, 1);
+	im.insert(3, 12, 2);
+	im.insert(30, 40, 3);
+	assert(im.insert(3, 12, 4).second == false);
+	assert(im.size() == 4);
+	assert(im.begin()->first.first == 1);
+
+	//overlap query
+	ft::vector<imap::iterator> found;
+	im.find_overlaps(11, 25, std::back_inserter(found));
+	assert(found.size() == 2);
+	assert(found[0]->second == 2 && found[1]->second == 1);
+
+	//stabbing query
+	found.clear();
+	im.find_containing(4, std::back_inserter(found));
+	assert(found.size() == 2);
+	assert(im.overlaps(25, 29) == false);
+	assert(im.overlaps(40, 50) == true);
+
+	//the augmentation must survive erasures and rotations: compare with a linear scan
+	srand(7);
+	for (int i = 0; i < 500; i++)
+	{
+		int lo = rand() % 1000;
+		im.insert(lo, lo + rand() % 50, i);
+	}
+	for (int i = 0; i < 200; i++)
+		im.erase(im.begin());
+	assert(im.erase(30, 40) + im.erase(-1, -1) <= 1);
+	for (int q = 0; q < 100; q++)
+	{
+		int lo = rand() % 1100;
+		int hi = lo + rand() % 20;
+		std::size_t expected = 0;
+		for (imap::iterator it = im.begin(); it != im.end(); it++)
+			if (it->first.first <= hi && it->first.second >= lo)
+				expected++;
+		found.clear();
+		im.find_overlaps(lo, hi, std::back_inserter(found));
+		assert(found.size() == expected);
+		assert(im.overlaps(lo, hi) == (expected != 0));
+	}
+
+	//copies keep the allocator
+	typedef tagged_allocator<ft::pair<const ft::pair<int, int>, int> > interval_allocator;
+	typedef ft::interval_map<int, int, std::less<int>, interval_allocator> tagged_intervals;
+	tagged_intervals tagged(std::less<int>(), interval_allocator(9));
+	tagged.insert(1, 5, 0);
+	tagged_intervals tagged_copy(tagged);
+	assert(tagged.get_allocator().id == 9 && tagged_copy.get_allocator().id == 9 && tagged_copy.size() == 1);
+}
+
+//Records the keys it is applied to
+struct key_recorder
+{
+	ft::vector<int> * keys;
+	key_recorder(ft::vector<int> * k) : keys(k) {}
+	void operator()(const ft::pair<const int, int>& p) { keys->push_back(p.first); }
+};
+
+struct double_value
+{
+	void operator()(ft::pair<const int, int>& p) { p.second *= 2; }
+};
+
+void map_for_each_tests()
+{
+	ft::map<int, int> m;
+	ft::vector<int> keys;
+	m.for_each(key_recorder(&keys));
+	assert(keys.empty());
+
+	srand(35);
+	for (int i = 0; i < 1000; i++)
+		m[(rand() % 500) * 2] = i; //even keys only
+	m.for_each(key_recorder(&keys));
+	assert(keys.size() == m.size());
+	ft::vector<int>::iterator k = keys.begin();
+	for (ft::map<int, int>::iterator it = m.begin(); it != m.end(); it++, k++)
+		assert(it->first == *k);
+
+	//ranges include both bounds, and give the same elements as lower_bound / upper_bound
+	for (int i = 0; i < 200; i++)
+	{
+		int lo = rand() % 1100 - 50;
+		int hi = lo + rand() % 300 - 20;
+		keys.clear();
+		m.for_each_range(lo, hi, key_recorder(&keys));
+		k = keys.begin();
+		ft::map<int, int>::iterator it = m.lower_bound(lo);
+		for (; it != m.end() && it->first <= hi; it++, k++)
+			assert(k != keys.end() && it->first == *k);
+		assert(k == keys.end());
+		if (lo <= hi)
+			assert(it == m.upper_bound(hi));
+	}
+
+	ft::map<int, int> copy(m);
+	m.for_each(double_value());
+	for (ft::map<int, int>::iterator it = m.begin(); it != m.end(); it++)
+		assert(it->second == copy[it->first] * 2);
+	keys.clear();
+	const ft::map<int, int>& cm = m;
+	cm.for_each_range(10, 10, key_recorder(&keys));
+	assert(keys.size() == m.count(10));
+}
+
+//Counts its comparisons
+struct counting_less
+{
+	int * count;
+	counting_less(int * c = NULL) : count(c) {}
+	bool operator()(int a, int b) const
+	{
+		if (count != NULL)
+			++*count;
+		return a < b;
+	}
+};
+
+void map_aggregate_tests()
+{
+	typedef std::allocator<ft::TreeNode<ft::pair<const int, int> > > node_alloc;
+	typedef ft::map<int, int, std::less<int>, node_alloc, ft::sum_aggregate<int> > sum_map;
+	typedef ft::map<int, int, std::less<int>, node_alloc, ft::min_aggregate<int> > min_map;
+	typedef ft::map<int, int, std::less<int>, node_alloc, ft::max_aggregate<int> > max_map;
+	typedef ft::map<int, int, std::less<int>, node_alloc, ft::count_aggregate> count_map;
+
+	sum_map sum;
+	min_map min;
+	max_map max;
+	count_map count;
+	assert(sum.aggregate() == 0 && sum.aggregate(1, 10) == 0);
+	assert(min.aggregate(1, 10) == std::numeric_limits<int>::max());
+
+	//compare with an iteration between lower_bound and upper_bound, after insertions, updates and erasures
+	srand(11);
+	for (int i = 0; i < 2000; i++)
+	{
+		int k = rand() % 3000;
+		int v = rand() % 1000 - 500;
+		sum[k] = v;
+		sum.refresh_aggregate(sum.find(k));
+		min.erase(k);
+		min.insert(ft::make_pair(k, v));
+		max[k] = v;
+		max.refresh_aggregate(max.find(k));
+		count[k] = v;
+	}
+	for (int i = 0; i < 500; i++)
+	{
+		int k = rand() % 3000;
+		sum.erase(k);
+		min.erase(k);
+		max.erase(k);
+		count.erase(k);
+	}
+	for (int q = 0; q < 200; q++)
+	{
+		int lo = rand() % 3100 - 50;
+		int hi = lo + rand() % 500;
+		int expected_sum = 0;
+		int expected_min = std::numeric_limits<int>::max();
+		int expected_max = std::numeric_limits<int>::min();
+		std::size_t expected_count = 0;
+		for (sum_map::iterator it = sum.lower_bound(lo); it != sum.upper_bound(hi); it++)
+		{
+			expected_sum += it->second;
+			expected_min = std::min(expected_min, it->second);
+			expected_max = std::max(expected_max, it->second);
+			expected_count++;
+		}
+		assert(sum.aggregate(lo, hi) == expected_sum);
+		assert(min.aggregate(lo, hi) == expected_min);
+		assert(max.aggregate(lo, hi) == expected_max);
+		assert(count.aggregate(lo, hi) == expected_count);
+	}
+	assert(count.aggregate() == count.size());
+
+	//refresh_aggregate updates the node of the iterator and its ancestors, without searching it again
+	int comparisons = 0;
+	ft::map<int, int, counting_less, node_alloc, ft::sum_aggregate<int> > counted((counting_less(&comparisons)));
+	for (int i = 0; i < 1000; i++)
+		counted.insert(ft::make_pair(i, 1));
+	ft::map<int, int, counting_less, node_alloc, ft::sum_aggregate<int> >::iterator it = counted.find(500);
+	it->second = 1001;
+	comparisons = 0;
+	counted.refresh_aggregate(it);
+	assert(comparisons == 0 && counted.aggregate() == 2000 && counted.aggregate(400, 600) == 1201);
+}
+
+void key_prefix_cache_tests()
+{
+	typedef ft::map<std::string, int, std::less<std::string>, std::allocator<ft::TreeNode<ft::pair<const std::string, int> > >, ft::key_prefix_cache> prefix_map;
+
+	//keys tying on their prefix, shorter than it, with embedded zeros or bytes above 0x7f
+	const char * fixed[] = {"", "a", "ab", "abcdefgh", "abcdefghi", "abcdefgha", "abcdefg", "b", "\xff", "\xfe\x01", "zzzzzzzzzzzz"};
+	prefix_map m;
+	ft::map<std::string, int> reference;
+	for (std::size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++)
+	{
+		m[fixed[i]] = static_cast<int>(i);
+		reference[fixed[i]] = static_cast<int>(i);
+	}
+	m[std::string("a\0", 2)] = 100;
+	reference[std::string("a\0", 2)] = 100;
+	srand(12);
+	for (int i = 0; i < 3000; i++)
+	{
+		std::string k(rand() % 14, 'a');
+		for (std::size_t j = 0; j < k.size(); j++)
+			k[j] = static_cast<char>('a' + rand() % 3);
+		if (rand() % 4 == 0)
+		{
+			assert(m.erase(k) == reference.erase(k));
+			continue;
+		}
+		assert(m.insert(ft::make_pair(k, i)).second == reference.insert(ft::make_pair(k, i)).second);
+	}
+	assert(m.size() == reference.size());
+	prefix_map::iterator it = m.begin();
+	for (ft::map<std::string, int>::iterator ref = reference.begin(); ref != reference.end(); ref++, it++)
+	{
+		assert(it->first == ref->first && it->second == ref->second);
+		assert(m.find(ref->first) == it && m.count(ref->first) == 1);
+	}
+	assert(it == m.end());
+	assert(m.find("abcdefghij") == m.end() && m.at("abcdefgh") == 3);
+}
+
+template <class Key>
+void check_art_map(const ft::art_map<Key, int>& art, const ft::map<Key, int>& reference)
+{
+	assert(art.size() == reference.size());
+	typename ft::art_map<Key, int>::const_iterator it = art.begin();
+	for (typename ft::map<Key, int>::const_iterator ref = reference.begin(); ref != reference.end(); ref++, it++)
+		assert(it->first == ref->first && it->second == ref->second);
+	assert(it == art.end());
+	typename ft::art_map<Key, int>::const_reverse_iterator rit = art.rbegin();
+	for (typename ft::map<Key, int>::const_reverse_iterator ref = reference.rbegin(); ref != reference.rend(); ref++, rit++)
+		assert(rit->first == ref->first);
+	assert(rit == art.rend());
+}
+
+void art_map_tests()
+{
+	//int keys, negative values included, through every node size
+	ft::art_map<int, int> ints;
+	ft::map<int, int> ints_ref;
+	srand(13);
+	for (int i = 0; i < 20000; i++)
+	{
+		int k = (rand() % 2 ? rand() % 600 - 300 : rand() - RAND_MAX / 2);
+		if (rand() % 3 == 0)
+			assert(ints.erase(k) == ints_ref.erase(k));
+		else
+			assert(ints.insert(ft::make_pair(k, i)).second == ints_ref.insert(ft::make_pair(k, i)).second);
+	}
+	check_art_map(ints, ints_ref);
+	for (int q = 0; q < 2000; q++)
+	{
+		int k = (q % 2 ? rand() % 700 - 350 : rand() - RAND_MAX / 2);
+		assert(ints.count(k) == ints_ref.count(k));
+		ft::art_map<int, int>::iterator lb = ints.lower_bound(k);
+		ft::map<int, int>::iterator lb_ref = ints_ref.lower_bound(k);
+		assert((lb == ints.end()) == (lb_ref == ints_ref.end()));
+		if (lb_ref != ints_ref.end())
+			assert(lb->first == lb_ref->first);
+		ft::art_map<int, int>::iterator ub = ints.upper_bound(k);
+		ft::map<int, int>::iterator ub_ref = ints_ref.upper_bound(k);
+		assert((ub == ints.end()) == (ub_ref == ints_ref.end()));
+		if (ub_ref != ints_ref.end())
+			assert(ub->first == ub_ref->first);
+	}
+
+	//string keys which are prefixes of each other or share prefixes longer than the stored part
+	ft::art_map<std::string, int> strings;
+	ft::map<std::string, int> strings_ref;
+	const char * stems[] = {"", "a", "ab", "https://www.example.com/", "https://www.example.com/index/"};
+	for (int i = 0; i < 20000; i++)
+	{
+		std::string k = stems[rand() % 5];
+		k.append(rand() % 4, static_cast<char>('a' + rand() % 3));
+		if (rand() % 8 == 0)
+			k.push_back('\0');
+		if (rand() % 3 == 0)
+			assert(strings.erase(k) == strings_ref.erase(k));
+		else
+			strings[k] = i;
+		if (strings_ref.count(k) || strings.count(k))
+			strings_ref[k] = i;
+	}
+	check_art_map(strings, strings_ref);
+	assert(strings.lower_bound("https://www.example.com/index") == strings.find(strings_ref.lower_bound("https://www.example.com/index")->first));
+	assert(strings.upper_bound("zzz") == strings.end());
+
+	//copy, swap, erase of every element
+	ft::art_map<std::string, int> copy(strings);
+	ft::art_map<std::string, int> other;
+	other.swap(copy);
+	assert(copy.empty());
+	check_art_map(other, strings_ref);
+	while (!other.empty())
+		other.erase(other.begin());
+	assert(other.begin() == other.end());
+	try
+	{
+		other.at("missing");
+		assert(false);
+	}
+	catch (const std::out_of_range&) {}
+
+	//a copy which throws while building a leaf frees it, and leaves the map as it was
+	{
+		typedef ft::art_map<int, throwing_counter, limited_allocator<ft::pair<const int, throwing_counter> > > counters;
+		counters m;
+		for (int i = 0; i < 3; i++)
+			m.insert(counters::value_type(i, throwing_counter(i)));
+		int blocks = g_blocks_in_use;
+		throwing_counter::poison_copies_left = 1; //the copy into the pair
+		try { m.insert(counters::value_type(8, throwing_counter(-1))); assert(false); } catch (std::runtime_error&) {}
+		assert(m.size() == 3 && m.count(8) == 0 && g_blocks_in_use == blocks && throwing_counter::live == 3);
+		m.insert(counters::value_type(8, throwing_counter(8)));
+		assert(m.size() == 4 && (--m.end())->first == 8 && throwing_counter::live == 4);
+	}
+	assert(throwing_counter::live == 0 && g_blocks_in_use == 0);
+}
+
+//Comparator with a state : the order of the keys, ascending or descending
+struct direction_less
+{
+	bool descending;
+
+	direction_less(bool d = false) : descending(d) {}
+
+	bool operator()(int a, int b) const
+	{
+		return descending ? b < a : a < b;
+	}
+};
+
+void small_map_tests()
+{
+	typedef ft::small_map<int, int, 4> small;
+
+	small m;
+	ft::map<int, int> reference;
+	assert(m.empty() && m.begin() == m.end() && m.is_inline());
+
+	//inline elements, inserted out of order, walked in both directions
+	int keys[] = {30, 10, 20, 40};
+	for (int i = 0; i < 4; i++)
+	{
+		assert(m.insert(ft::make_pair(keys[i], i)).second);
+		reference.insert(ft::make_pair(keys[i], i));
+	}
+	assert(!m.insert(ft::make_pair(20, 9)).second && m.is_inline());
+	small::iterator it = m.begin();
+	for (ft::map<int, int>::iterator ref = reference.begin(); ref != reference.end(); ref++, it++)
+		assert(it->first == ref->first && it->second == ref->second);
+	assert(it == m.end());
+	assert((--m.end())->first == 40 && m.rbegin()->first == 40);
+	assert(m.lower_bound(15)->first == 20 && m.upper_bound(20)->first == 30 && m.upper_bound(40) == m.end());
+	assert(m.at(10) == 1 && m.count(25) == 0);
+
+	//iterators stay valid when other inline elements come and go
+	small::iterator forty = m.find(40);
+	m.erase(10);
+	m[5] = 5;
+	assert(forty->first == 40 && m.begin()->first == 5 && m.size() == 4);
+
+	//the fifth element moves them to a map, clear brings them back inline
+	m[50] = 50;
+	assert(!m.is_inline() && m.size() == 5 && m.begin()->first == 5 && (--m.end())->first == 50);
+	small copy(m);
+	assert(copy == m);
+	m.clear();
+	assert(m.is_inline() && m.empty());
+
+	srand(14);
+	reference.clear();
+	for (int i = 0; i < 2000; i++)
+	{
+		int k = rand() % 12;
+		if (rand() % 2)
+			assert(m.erase(k) == reference.erase(k));
+		else
+			m[k] = reference[k] = i;
+		if (i % 100 == 0)
+			m.clear(), reference.clear();
+		assert(m.size() == reference.size());
+	}
+	small other;
+	other[1] = 1;
+	other.swap(m);
+	assert(m.size() == 1 && other.size() == reference.size());
+	assert(ft::equal(other.begin(), other.end(), reference.begin()));
+
+	//swaps exchange the comparators with the elements, inline or not
+	typedef ft::small_map<int, int, 4, direction_less> directed;
+	directed ascending((direction_less(false))), descending((direction_less(true)));
+	for (int i = 1; i <= 3; i++)
+		ascending[i] = i;
+	descending[5] = 5;
+	descending[6] = 6;
+	ascending.swap(descending);
+	assert(ascending.size() == 2 && ascending.begin()->first == 6 && ascending.key_comp().descending);
+	assert(descending.size() == 3 && descending.begin()->first == 1 && !descending.key_comp().descending);
+	ascending[7] = 7;
+	descending[0] = 0;
+	assert(ascending.begin()->first == 7 && descending.begin()->first == 0);
+	for (int i = 10; i < 20; i++)
+		ascending[i] = i;
+	ft::swap(ascending, descending);
+	assert(descending.begin()->first == 19 && !descending.is_inline() && ascending.begin()->first == 0 && ascending.is_inline());
+	ascending.swap(descending);
+	assert(ascending.begin()->first == 19 && descending.size() == 4 && (--descending.end())->first == 3);
+
+	//a copy which throws while moving the elements to a map, or in a swap, leaves the maps valid
+	typedef ft::small_map<int, throwing_counter, 2> counters;
+	{
+		throwing_counter::poison_copies_left = 100;
+		counters full, other;
+		full.insert(counters::value_type(1, throwing_counter(-1)));
+		full.insert(counters::value_type(2, throwing_counter(2)));
+		other.insert(counters::value_type(3, throwing_counter(3)));
+		throwing_counter::poison_copies_left = 0;
+		try { full.insert(counters::value_type(3, throwing_counter(3))); assert(false); } catch (std::runtime_error&) {}
+		assert(full.is_inline() && full.size() == 2 && full.begin()->second.value == -1);
+		throwing_counter::poison_copies_left = 0;
+		try { full.swap(other); assert(false); } catch (std::runtime_error&) {}
+		assert(full.size() == 2 && other.size() == 1 && other.begin()->first == 3 && throwing_counter::live == 3);
+	}
+	assert(throwing_counter::live == 0);
+
+	//an inline insertion whose copy throws leaves its slot free for the next one
+	{
+		counters m;
+		m.insert(counters::value_type(1, throwing_counter(1)));
+		throwing_counter::poison_copies_left = 1; //the copy into the pair
+		try { m.insert(counters::value_type(2, throwing_counter(-1))); assert(false); } catch (std::runtime_error&) {}
+		assert(m.size() == 1 && m.count(2) == 0 && throwing_counter::live == 1);
+		m.insert(counters::value_type(3, throwing_counter(3)));
+		const char * element = reinterpret_cast<const char *>(&m[3]);
+		assert(element > reinterpret_cast<const char *>(&m) && element < reinterpret_cast<const char *>(&m + 1));
+		assert(m.is_inline() && m.size() == 2 && m[3].value == 3);
+		m.insert(counters::value_type(4, throwing_counter(4)));
+		assert(!m.is_inline() && m.size() == 3 && m[1].value == 1 && m[4].value == 4 && throwing_counter::live == 3);
+	}
+	assert(throwing_counter::live == 0);
+}
+
+void split_map_tests()
+{
+	typedef ft::split_map<int, std::string> split;
+
+	split m;
+	ft::map<int, std::string> reference;
+	assert(m.empty() && m.begin() == m.end());
+
+	int keys[] = {30, 10, 20, 40, 25};
+	for (int i = 0; i < 5; i++)
+	{
+		assert(m.insert(ft::make_pair(keys[i], std::string(i + 1, 'a'))).second);
+		reference.insert(ft::make_pair(keys[i], std::string(i + 1, 'a')));
+	}
+	//a duplicate key does not replace the element in the arena
+	assert(!m.insert(ft::make_pair(20, std::string("dup"))).second && m.at(20) == "aaa");
+	assert(m.size() == 5 && ft::equal(m.begin(), m.end(), reference.begin()));
+	assert((--m.end())->first == 40 && m.rbegin()->first == 40);
+	assert(m.lower_bound(21)->first == 25 && m.upper_bound(25)->first == 30 && m.lower_bound(41) == m.end());
+	split::const_iterator cit = m.find(10);
+	assert(cit->second == "aa" && m.count(11) == 0);
+	try
+	{
+		m.at(11);
+		assert(false);
+	}
+	catch (std::out_of_range&) {}
+
+	//the slot of an erased element is reused, the other elements do not move
+	std::string * forty = &m.find(40)->second;
+	std::string * ten = &m.find(10)->second;
+	m.erase(10);
+	m[15] = "new";
+	assert(&m.find(15)->second == ten && &m.find(40)->second == forty);
+	assert(m.begin()->first == 15 && m.size() == 5);
+
+	srand(34);
+	reference.clear();
+	m.clear();
+	for (int i = 0; i < 3000; i++)
+	{
+		int k = rand() % 200;
+		if (rand() % 3 == 0)
+			assert(m.erase(k) == reference.erase(k));
+		else
+			m[k] = reference[k] = std::string(i % 40, 'x');
+		assert(m.size() == reference.size());
+	}
+	assert(ft::equal(m.begin(), m.end(), reference.begin()));
+	split copy(m), other;
+	assert(copy == m);
+	other[1] = "one";
+	other.swap(m);
+	assert(m.size() == 1 && other == copy && copy != m);
+	other.erase(other.begin(), other.end());
+	assert(other.empty());
+
+	//a duplicate key allocates nothing, and a throwing copy of the element leaves the map unchanged
+	typedef ft::split_map<int, throwing_counter, std::less<int>, counting_allocator<ft::pair<const int, throwing_counter> > > counted_split;
+	{
+		counted_split counted;
+		throwing_counter::poison_copies_left = 100;
+		counted_split::value_type poisoned(2, throwing_counter(-1));
+		counted.insert(counted_split::value_type(1, throwing_counter(1)));
+		int allocations = g_allocations;
+		assert(!counted.insert(counted_split::value_type(1, throwing_counter(5))).second && g_allocations == allocations);
+		throwing_counter::poison_copies_left = 0;
+		try { counted.insert(poisoned); assert(false); } catch (std::runtime_error&) {}
+		assert(counted.size() == 1 && counted.find(2) == counted.end() && counted.begin()->second.value == 1);
+		throwing_counter::poison_copies_left = 100;
+		assert(counted.insert(poisoned).second && counted.size() == 2 && counted.at(2).value == -1);
+	}
+	assert(throwing_counter::live == 0);
+
+	//copies keep the allocator
+	typedef ft::split_map<int, int, std::less<int>, tagged_allocator<ft::pair<const int, int> > > tagged_split;
+	tagged_split tagged(std::less<int>(), tagged_allocator<ft::pair<const int, int> >(7));
+	tagged[1] = 1;
+	tagged_split tagged_copy(tagged);
+	assert(tagged.get_allocator().id == 7 && tagged_copy.get_allocator().id == 7 && tagged_copy == tagged);
+}
+//Marks every visited key, and checks that each piece is visited in key order
+struct visit_marker
+{
+	ft::vector<int> * visits;
+	int last;
+	visit_marker(ft::vector<int> * v) : visits(v), last(-1) {}
+	void operator()(ft::pair<const int, int>& p)
+	{
+		assert(p.first > last);
+		last = p.first;
+		(*visits)[p.first]++;
+		p.second = -p.second;
+	}
+};
+
+//Throws when it reaches the key stop
+struct stop_at
+{
+	int stop;
+	stop_at(int k) : stop(k) {}
+	void operator()(const ft::pair<const int, int>& p) const
+	{
+		if (p.first == stop)
+			throw std::runtime_error("stop_at");
+	}
+	long operator()(long sum, const ft::pair<const int, int>& p) const
+	{
+		operator()(p);
+		return sum + p.second;
+	}
+};
+
+//Concatenates keys : the result depends on the order of the elements
+struct key_concat
+{
+	std::string operator()(const std::string& s, const ft::pair<const int, int>& p) const
+	{
+		std::ostringstream key;
+		key << p.first << ',';
+		return s + key.str();
+	}
+	std::string operator()(const std::string& s, const std::string& t) const
+	{
+		return s + t;
+	}
+};
+
+struct value_sum
+{
+	long operator()(long sum, const ft::pair<const int, int>& p) const { return sum + p.second; }
+	long operator()(long a, long b) const { return a + b; }
+};
+
+void parallel_tests()
+{
+	ft::map<int, int> m;
+	assert(ft::parallel_reduce(m, 7L, value_sum()) == 7);
+
+	const int keys = 5000;
+	long sum = 0;
+	for (int i = 0; i < keys; i += 2)
+	{
+		m[i] = i;
+		sum += i;
+	}
+	std::string order;
+	for (ft::map<int, int>::iterator it = m.begin(); it != m.end(); it++)
+		order = key_concat()(order, *it);
+
+	for (unsigned int threads = 1; threads <= 8; threads *= 2)
+	{
+		assert(ft::parallel_reduce(m, 0L, value_sum(), value_sum(), threads) == sum);
+		assert(ft::parallel_reduce(m, std::string(), key_concat(), key_concat(), threads) == order);
+
+		ft::vector<int> visits(keys, 0);
+		ft::parallel_for_each(m, visit_marker(&visits), threads);
+		for (int i = 0; i < keys; i++)
+			assert(visits[i] == (i % 2 == 0 ? 1 : 0));
+		sum = -sum; //the values have been negated
+	}
+	//a tiny map gives fewer pieces than threads
+	ft::map<int, int> one;
+	one[1] = 1;
+	assert(ft::parallel_reduce(one, 0L, value_sum(), value_sum(), 8) == 1);
+
+	//an exception thrown on any thread reaches the caller
+	for (int stop = 0; stop < keys; stop += 998)
+	{
+		try { ft::parallel_for_each(m, stop_at(stop), 4); assert(false); }
+		catch (std::runtime_error& e) { assert(std::string(e.what()) == "stop_at"); }
+		try { ft::parallel_reduce(m, 0L, stop_at(stop), value_sum(), 4); assert(false); }
+		catch (std::runtime_error& e) { assert(std::string(e.what()) == "stop_at"); }
+	}
+}
+
+//Height of the subtree of node, checking that each height stored below it is that of its subtree, and balanced
+template <class Node>
+int checked_height(const Node * node)
+{
+	if (node == NULL)
+		return -1;
+	int left = checked_height(node->left);
+	int right = checked_height(node->right);
+	assert(node->height == std::max(left, right) + 1 && left - right <= 1 && right - left <= 1);
+	return node->height;
+}
+
+//Checks the heights of the tree of m from its root
+template <class Map>
+void check_heights(const Map& m)
+{
+	if (m.empty())
+		return;
+	typedef typename Map::const_iterator::node_pointer node_pointer;
+	node_pointer root = static_cast<node_pointer>(m.begin().base());
+	while (root->parent != NULL)
+		root = root->parent;
+	checked_height(root);
+}
+
+//Checks the links and the heights of an AVL tree through its iterators : the elements are sorted and reachable
+//in both directions, and the map stays usable
+template <class Map>
+void check_built_map(Map& m, const ft::map<int, int>& reference)
+{
+	check_heights(m);
+	assert(m.size() == reference.size());
+	assert(ft::equal(m.begin(), m.end(), reference.begin()));
+	typename Map::reverse_iterator rit = m.rbegin();
+	for (ft::map<int, int>::const_reverse_iterator ref = reference.rbegin(); ref != reference.rend(); ref++, rit++)
+		assert(rit->first == ref->first);
+	for (ft::map<int, int>::const_iterator ref = reference.begin(); ref != reference.end(); ref++)
+		assert(m.find(ref->first)->second == ref->second);
+}
+
+void build_map_parallel_tests()
+{
+	ft::vector<ft::pair<int, int> > input;
+	ft::map<int, int> built;
+	built[5] = 5;
+	ft::build_map_parallel(input.begin(), input.end(), built);
+	assert(built.empty());
+
+	srand(37);
+	const int sizes[] = {1, 2, 3, 100, 5000, 40000};
+	for (std::size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		input.clear();
+		for (int i = 0; i < sizes[s]; i++)
+			input.push_back(ft::make_pair(rand() % (sizes[s] * 2), i));
+		ft::map<int, int> first_wins(input.begin(), input.end());
+		ft::map<int, int> last_wins;
+		for (std::size_t i = 0; i < input.size(); i++)
+			last_wins[input[i].first] = input[i].second;
+
+		for (unsigned int threads = 1; threads <= 4; threads++)
+		{
+			ft::build_map_parallel(input.begin(), input.end(), built, ft::keep_first, threads);
+			check_built_map(built, first_wins);
+			ft::build_map_parallel(input.begin(), input.end(), built, ft::keep_last, threads);
+			check_built_map(built, last_wins);
+		}
+		//the built tree is a valid AVL tree for later insertions and erasures
+		for (int i = 0; i < sizes[s]; i++)
+		{
+			int k = rand() % (sizes[s] * 2);
+			if (rand() % 2)
+				assert(built.erase(k) == last_wins.erase(k));
+			else
+				built[k] = last_wins[k] = i;
+		}
+		check_built_map(built, last_wins);
+	}
+
+	//the augmentation of the nodes is computed while building, with or without threads
+	typedef std::allocator<ft::TreeNode<ft::pair<const int, int> > > node_alloc;
+	ft::map<int, int, std::less<int>, node_alloc, ft::sum_aggregate<int> > sums;
+	ft::vector<ft::pair<int, int> > ones;
+	for (int i = 0; i < 100; i++)
+		ones.push_back(ft::make_pair(i, 1));
+	for (unsigned int threads = 1; threads <= 4; threads++)
+	{
+		ft::build_map_parallel(ones.begin(), ones.end(), sums, ft::keep_first, threads);
+		check_heights(sums);
+		assert(sums.aggregate() == 100 && sums.aggregate(0, 99) == 100 && sums.aggregate(10, 19) == 10);
+	}
+	ft::build_map_parallel(input.begin(), input.end(), sums, ft::keep_last, 3);
+	ft::map<int, int> reference;
+	for (std::size_t i = 0; i < input.size(); i++)
+		reference[input[i].first] = input[i].second;
+	for (int i = 0; i < 100; i++)
+	{
+		int lo = rand() % 80000;
+		int hi = lo + rand() % 10000;
+		int expected = 0;
+		for (ft::map<int, int>::iterator it = reference.lower_bound(lo); it != reference.upper_bound(hi); it++)
+			expected += it->second;
+		assert(sums.aggregate(lo, hi) == expected);
+	}
+
+	//the elements are sorted with the comparator of the map
+	ft::map<int, int, direction_less> descending(direction_less(true));
+	ft::build_map_parallel(input.begin(), input.end(), descending, ft::keep_last, 3);
+	assert(descending.size() == reference.size() && descending.key_comp().descending && descending.value_comp()(*descending.begin(), *descending.rbegin()));
+	assert(ft::equal(descending.begin(), descending.end(), reference.rbegin()));
+
+	//a node allocation failing on any thread reaches the caller, which frees the nodes already built
+	{
+		ft::vector<ft::pair<int, int> > many;
+		for (int i = 0; i < 40000; i++)
+			many.push_back(ft::make_pair(i, i));
+		ft::map<int, int, std::less<int>, limited_allocator<ft::TreeNode<ft::pair<const int, int> > > > limited;
+		const int budgets[] = {1, 2, 5000, 39999};
+		for (std::size_t b = 0; b < sizeof(budgets) / sizeof(budgets[0]); b++)
+		{
+			g_allocations_left = budgets[b];
+			try { ft::build_map_parallel(many.begin(), many.end(), limited, ft::keep_first, 4); assert(false); }
+			catch (std::bad_alloc&) {}
+			g_allocations_left = -1;
+			assert(limited.empty() && limited.begin() == limited.end() && g_blocks_in_use == 1); //the past-the-end
+		}
+		ft::build_map_parallel(many.begin(), many.end(), limited, ft::keep_first, 4);
+		assert(limited.size() == 40000 && g_blocks_in_use == 40001);
+	}
+	assert(g_blocks_in_use == 0);
+}
+void buffered_map_tests()
+{
+	ft::buffered_map<int, std::string> empty;
+	assert(empty.find(1) == NULL && empty.empty());
+
+	//thresholds flushing often into a small map (one by one) and rarely into a large one (merge and rebuild)
+	const std::size_t thresholds[] = {1, 7, 64, 5000};
+	srand(38);
+	for (std::size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); t++)
+	{
+		ft::buffered_map<int, std::string> m(thresholds[t]);
+		ft::map<int, std::string> reference;
+		for (int i = 0; i < 4000; i++)
+		{
+			int k = rand() % 500;
+			if (rand() % 4 == 0)
+			{
+				m.erase(k);
+				reference.erase(k);
+			}
+			else
+			{
+				std::ostringstream value;
+				value << i;
+				m.assign(k, value.str());
+				reference[k] = value.str();
+			}
+			assert(m.buffered() < m.flush_threshold());
+			k = rand() % 500;
+			const std::string * found = m.find(k);
+			ft::map<int, std::string>::iterator it = reference.find(k);
+			assert(it == reference.end() ? found == NULL : (found != NULL && *found == it->second));
+			if (i % 1000 == 999)
+			{
+				assert(m.size() == reference.size() && m.buffered() == 0);
+				assert(m.merged() == reference);
+			}
+		}
+		m.set_flush_threshold(1);
+		assert(m.buffered() == 0);
+	}
+
+	//the last operation on a key wins inside a batch
+	ft::buffered_map<int, int> batch(100);
+	batch.assign(1, 1);
+	batch.erase(1);
+	batch.assign(2, 2);
+	batch.assign(2, 3);
+	batch.erase(3);
+	batch.assign(3, 4);
+	assert(batch.find(1) == NULL && *batch.find(2) == 3 && batch.count(3) == 1 && batch.buffered() == 6);
+	ft::vector<int> keys;
+	batch.for_each(key_recorder(&keys));
+	assert(keys.size() == 2 && keys[0] == 2 && keys[1] == 3 && batch.buffered() == 0);
+	assert(batch.merged().find(2)->second == 3);
+
+	//a small merge leaves a balanced tree with its heights, which the following insertions rebalance from
+	ft::buffered_map<int, int> rebuilt(1500);
+	for (int i = 0; i < 1500; i++)
+		rebuilt.assign(i * 2, i);
+	assert(rebuilt.buffered() == 0 && rebuilt.size() == 1500);
+	check_heights(rebuilt.merged());
+	rebuilt.set_flush_threshold(1);
+	for (int i = 0; i < 100; i++)
+		rebuilt.assign(3000 + i, i);
+	check_heights(rebuilt.merged());
+	assert(rebuilt.size() == 1600 && *rebuilt.find(2998) == 1499 && *rebuilt.find(3099) == 99);
+}
+void map_compact_tests()
+{
+	ft::map<int, std::string> m;
+	m.compact();
+	assert(m.empty());
+
+	srand(39);
+	ft::map<int, std::string> reference;
+	for (int round = 0; round < 3; round++)
+	{
+		for (int i = 0; i < 3000; i++)
+		{
+			int k = rand() % 1000;
+			if (rand() % 3 == 0)
+				assert(m.erase(k) == reference.erase(k));
+			else
+				m[k] = reference[k] = std::string(k % 30, 'c');
+		}
+		//erasures and insertions after a compaction mix nodes of the block and single nodes
+		m.compact();
+		assert(m == reference);
+		assert(ft::equal(m.rbegin(), m.rend(), reference.rbegin()));
+		assert(m.lower_bound(500)->first == reference.lower_bound(500)->first);
+	}
+	while (!m.empty())
+		m.erase(m.begin());
+
+	typedef std::allocator<ft::TreeNode<ft::pair<const int, int> > > node_alloc;
+	ft::map<int, int, std::less<int>, node_alloc, ft::sum_aggregate<int> > sums;
+	for (int i = 0; i < 100; i++)
+		sums[i * 3 % 100] = i;
+	sums.erase(50); //holds 50, since 3 * 50 % 100 == 50
+	sums.compact();
+	assert(sums.aggregate(0, 99) == 4950 - 50 && sums.aggregate(10, 12) == sums[10] + sums[11] + sums[12]);
+	sums.insert(ft::make_pair(50, 1000));
+	assert(sums.aggregate(0, 99) == 4900 + 1000);
+}
+#endif
+
 int main() 
 {
 	stack_tests();
 	vector_tests();
 	map_tests();
+#if __cplusplus >= 201103L
+	move_semantics_tests();
+#endif
+#if NAMESPACE==0
+	frozen_map_tests();
+	interval_map_tests();
+	map_aggregate_tests();
+	map_for_each_tests();
+	key_prefix_cache_tests();
+	art_map_tests();
+	small_map_tests();
+	split_map_tests();
+	vector_relocation_tests();
+	vector_growth_tests();
+	parallel_tests();
+	build_map_parallel_tests();
+	buffered_map_tests();
+	map_compact_tests();
+	map_find_or_insert_tests();
+	map_node_handle_tests();
+	small_vector_tests();
+	static_vector_tests();
+	simd_tests();
+	vector_bool_tests();
+	mmap_allocator_tests();
+	vector_uninitialized_tests();
+#endif
 	return 0;
 }
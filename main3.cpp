@@ -0,0 +1,1514 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <map>
+#include <vector>
+
+#include "map.hpp"
+#include "stack.hpp"
+#include "vector.hpp"
+#include "frozen_map.hpp"
+#include "interval_map.hpp"
+#include "art_map.hpp"
+#include "small_map.hpp"
+#include "split_map.hpp"
+#include "parallel.hpp"
+#include "buffered_map.hpp"
+#include "small_vector.hpp"
+#include "static_vector.hpp"
+#include "mmap_allocator.hpp"
+
+//Benchmarks of the ft-only extensions (no std equivalent, so they are not part of main2.cpp)
+//Usage: ./bench_extensions [benchmark names...] (all benchmarks when no name is given)
+
+static double now()
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void report(const std::string& what, double seconds, std::size_t ops)
+{
+	std::cout << "  " << std::left << std::setw(44) << what << std::right << std::fixed << std::setprecision(3)
+		<< std::setw(10) << seconds * 1e3 << " ms";
+	if (ops != 0)
+		std::cout << std::setw(12) << std::setprecision(1) << seconds * 1e9 / ops << " ns/op";
+	std::cout << std::endl;
+}
+
+//Keeps the optimizer from removing the measured loops
+static volatile long g_sink;
+
+static std::string random_string(std::size_t len)
+{
+	std::string s(len, 'a');
+	for (std::size_t i = 0; i < len; i++)
+		s[i] = static_cast<char>('a' + rand() % 26);
+	return s;
+}
+
+/// FROZEN MAP ///
+
+template <class Key>
+static void bench_frozen_map_keys(const std::string& title, const ft::vector<Key>& keys)
+{
+	std::size_t n = keys.size();
+	std::cout << title << " (" << n << " keys)" << std::endl;
+
+	double t = now();
+	ft::map<Key, int> m;
+	for (std::size_t i = 0; i < n; i++)
+		m[keys[i]] = static_cast<int>(i);
+	report("ft::map build", now() - t, n);
+
+	t = now();
+	ft::frozen_map<Key, int> f(m);
+	report("frozen_map build from ft::map", now() - t, n);
+
+	std::string blob;
+	t = now();
+	f.serialize(blob);
+	report("frozen_map serialize", now() - t, n);
+	ft::frozen_map<Key, int> loaded;
+	t = now();
+	loaded.load(blob.data(), blob.size());
+	report("frozen_map load", now() - t, n);
+
+	std::cout << "  bytes/key: frozen_map " << static_cast<double>(f.memory_usage()) / n
+		<< ", serialized " << static_cast<double>(blob.size()) / n
+		<< ", ft::map node " << sizeof(ft::TreeNode<typename ft::map<Key, int>::value_type>) << std::endl;
+
+	const std::size_t lookups = 2000000;
+	ft::vector<std::size_t> order(lookups);
+	for (std::size_t i = 0; i < lookups; i++)
+		order[i] = static_cast<std::size_t>(rand()) % n;
+
+	long sum = 0;
+	t = now();
+	for (std::size_t i = 0; i < lookups; i++)
+		sum += m.find(keys[order[i]])->second;
+	report("ft::map find", now() - t, lookups);
+	t = now();
+	for (std::size_t i = 0; i < lookups; i++)
+		sum -= loaded.find(keys[order[i]])->second;
+	report("frozen_map find", now() - t, lookups);
+	g_sink = sum;
+}
+
+static void bench_frozen_map()
+{
+	ft::vector<int> ints;
+	ft::map<int, bool> seen;
+	while (ints.size() < 1000000)
+	{
+		int k = rand();
+		if (seen.insert(ft::make_pair(k, true)).second)
+			ints.push_back(k);
+	}
+	bench_frozen_map_keys("frozen_map<int, int>", ints);
+
+	ft::vector<std::string> strings;
+	ft::map<std::string, bool> seen_str;
+	while (strings.size() < 200000)
+	{
+		std::string k = random_string(8 + rand() % 24);
+		if (seen_str.insert(ft::make_pair(k, true)).second)
+			strings.push_back(k);
+	}
+	bench_frozen_map_keys("frozen_map<std::string, int>", strings);
+}
+
+/// INTERVAL MAP ///
+
+static void bench_interval_map()
+{
+	const int n = 1000000;
+	const int span = 100000000;
+	ft::interval_map<int, int> im;
+	ft::map<int, int> starts; //the linear scan baseline : start -> end
+
+	double t = now();
+	for (int i = 0; i < n; i++)
+	{
+		int lo = rand() % span;
+		im.insert(lo, lo + rand() % 1000, i);
+	}
+	report("interval_map insert 1M intervals", now() - t, n);
+	for (ft::interval_map<int, int>::iterator it = im.begin(); it != im.end(); it++)
+		starts[it->first.first] = it->first.second;
+
+	const int queries = 200;
+	ft::vector<int> query_lo(queries);
+	for (int q = 0; q < queries; q++)
+		query_lo[q] = rand() % span;
+
+	long found = 0;
+	t = now();
+	for (int q = 0; q < queries; q++)
+	{
+		for (ft::map<int, int>::iterator it = starts.begin(); it != starts.end(); it++)
+			if (it->first <= query_lo[q] + 5000 && it->second >= query_lo[q])
+				found++;
+	}
+	report("linear scan of ft::map, overlap query", now() - t, queries);
+
+	ft::vector<ft::interval_map<int, int>::iterator> out;
+	t = now();
+	for (int q = 0; q < queries; q++)
+	{
+		out.clear();
+		im.find_overlaps(query_lo[q], query_lo[q] + 5000, std::back_inserter(out));
+		found -= out.size();
+	}
+	report("interval_map overlap query", now() - t, queries);
+	t = now();
+	for (int q = 0; q < queries; q++)
+	{
+		out.clear();
+		im.find_containing(query_lo[q], std::back_inserter(out));
+		found += out.size();
+	}
+	report("interval_map stabbing query", now() - t, queries);
+	g_sink = found;
+}
+
+/// MAP AGGREGATE ///
+
+static void bench_map_aggregate()
+{
+	typedef ft::map<int, long, std::less<int>, std::allocator<ft::TreeNode<ft::pair<const int, long> > >, ft::sum_aggregate<long> > sum_map;
+	const int n = 1000000;
+	sum_map m;
+	ft::map<int, long> plain;
+
+	double t = now();
+	for (int i = 0; i < n; i++)
+		plain.insert(ft::make_pair(rand(), static_cast<long>(rand() % 1000)));
+	report("ft::map insert 1M", now() - t, n);
+	t = now();
+	for (ft::map<int, long>::iterator it = plain.begin(); it != plain.end(); it++)
+		m.insert(*it);
+	report("ft::map<sum_aggregate> insert 1M", now() - t, n);
+
+	const int queries = 20;
+	ft::vector<int> lo(queries);
+	for (int q = 0; q < queries; q++)
+		lo[q] = rand() % (RAND_MAX - RAND_MAX / 100);
+
+	//The bounds are looked up beforehand so that only the accumulation itself is measured
+	ft::vector<ft::map<int, long>::iterator> first(queries);
+	ft::vector<ft::map<int, long>::iterator> last(queries);
+	for (int q = 0; q < queries; q++)
+	{
+		first[q] = plain.lower_bound(lo[q]);
+		last[q] = plain.upper_bound(lo[q] + RAND_MAX / 100);
+	}
+
+	long total = 0;
+	t = now();
+	for (int q = 0; q < queries; q++)
+		for (ft::map<int, long>::iterator it = first[q]; it != last[q]; it++)
+			total += it->second;
+	report("iterator accumulation over 1% ranges", now() - t, queries);
+	t = now();
+	for (int q = 0; q < queries; q++)
+		total -= m.aggregate(lo[q], lo[q] + RAND_MAX / 100);
+	report("map::aggregate over 1% ranges", now() - t, queries);
+	g_sink = total;
+}
+
+/// THREE-WAY COMPARISON ///
+
+static unsigned long g_comparisons;
+
+//Strict weak ordering on strings only: the tree falls back to two calls per level
+struct counting_less
+{
+	bool operator()(const std::string& a, const std::string& b) const
+	{
+		g_comparisons++;
+		return a < b;
+	}
+};
+
+//Same ordering, with a three-way comparison registered through ft::key_three_way
+struct counting_three_way_less : public counting_less {};
+
+namespace ft
+{
+	template <>
+	struct key_three_way<std::string, counting_three_way_less>
+	{
+		static int compare(const counting_three_way_less&, const std::string& a, const std::string& b)
+		{
+			g_comparisons++;
+			return a.compare(b);
+		}
+	};
+}
+
+template <class Compare>
+static void bench_comparisons_with(const std::string& title, const ft::vector<std::string>& keys, const ft::vector<std::size_t>& order)
+{
+	ft::map<std::string, int, Compare> m;
+
+	g_comparisons = 0;
+	double t = now();
+	for (std::size_t i = 0; i < keys.size(); i++)
+		m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+	double elapsed = now() - t;
+	report(title + " insert", elapsed, keys.size());
+	if (g_comparisons != 0)
+		std::cout << "    " << static_cast<double>(g_comparisons) / keys.size() << " comparisons/insert" << std::endl;
+
+	g_comparisons = 0;
+	long sum = 0;
+	t = now();
+	for (std::size_t i = 0; i < order.size(); i++)
+		sum += m.find(keys[order[i]])->second;
+	elapsed = now() - t;
+	report(title + " find", elapsed, order.size());
+	if (g_comparisons != 0)
+		std::cout << "    " << static_cast<double>(g_comparisons) / order.size() << " comparisons/find" << std::endl;
+	g_sink = sum;
+}
+
+static void bench_three_way()
+{
+	ft::vector<std::string> keys;
+	for (int i = 0; i < 200000; i++)
+		keys.push_back("https://example.com/" + random_string(4 + rand() % 20));
+	ft::vector<std::size_t> order(1000000);
+	for (std::size_t i = 0; i < order.size(); i++)
+		order[i] = static_cast<std::size_t>(rand()) % keys.size();
+
+	bench_comparisons_with<counting_less>("two calls per level", keys, order);
+	bench_comparisons_with<counting_three_way_less>("three-way, one call per level", keys, order);
+	bench_comparisons_with<std::less<std::string> >("std::less<std::string>", keys, order);
+}
+
+/// KEY PREFIX CACHE ///
+
+typedef ft::map<std::string, int, std::less<std::string>, std::allocator<ft::TreeNode<ft::pair<const std::string, int> > >, ft::key_prefix_cache> prefix_map;
+
+template <class Map>
+static void bench_lookups(const std::string& title, const ft::vector<std::string>& keys, const ft::vector<std::size_t>& order)
+{
+	Map m;
+	for (std::size_t i = 0; i < keys.size(); i++)
+		m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+	long sum = 0;
+	double t = now();
+	for (std::size_t i = 0; i < order.size(); i++)
+		sum += m.find(keys[order[i]])->second;
+	report(title, now() - t, order.size());
+	g_sink = sum;
+}
+
+static std::string random_uuid()
+{
+	static const char hex[] = "0123456789abcdef";
+	std::string s(36, '-');
+	for (std::size_t i = 0; i < s.size(); i++)
+		if (i != 8 && i != 13 && i != 18 && i != 23)
+			s[i] = hex[rand() % 16];
+	return s;
+}
+
+static void bench_prefix_keys(const std::string& title, const ft::vector<std::string>& keys)
+{
+	ft::vector<std::size_t> order(1000000);
+	for (std::size_t i = 0; i < order.size(); i++)
+		order[i] = static_cast<std::size_t>(rand()) % keys.size();
+	std::cout << title << " (" << keys.size() << " keys)" << std::endl;
+	bench_lookups<ft::map<std::string, int> >("ft::map find", keys, order);
+	bench_lookups<prefix_map>("ft::map<key_prefix_cache> find", keys, order);
+}
+
+static void bench_prefix_cache()
+{
+	const std::size_t n = 500000;
+	ft::vector<std::string> uuids;
+	for (std::size_t i = 0; i < n; i++)
+		uuids.push_back(random_uuid());
+	bench_prefix_keys("UUID-like keys", uuids);
+
+	//the scheme fills the whole prefix : every comparison ties
+	ft::vector<std::string> urls;
+	for (std::size_t i = 0; i < n; i++)
+		urls.push_back("https://" + random_string(3 + rand() % 10) + ".com/" + random_string(4 + rand() % 20));
+	bench_prefix_keys("URL-like keys", urls);
+
+	//the same URLs without the scheme, as a URL index normalized on the host would store them
+	for (std::size_t i = 0; i < n; i++)
+		urls[i].erase(0, 8);
+	bench_prefix_keys("URL-like keys without scheme", urls);
+}
+
+/// ART MAP ///
+
+template <class Map, class Key>
+static void bench_ordered_map(const std::string& name, const ft::vector<Key>& keys, const ft::vector<Key>& probes)
+{
+	Map m;
+	double t = now();
+	for (std::size_t i = 0; i < keys.size(); i++)
+		m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+	report(name + " insert", now() - t, keys.size());
+
+	long sum = 0;
+	t = now();
+	for (std::size_t i = 0; i < probes.size(); i++)
+		sum += m.count(probes[i]);
+	report(name + " find", now() - t, probes.size());
+	t = now();
+	for (std::size_t i = 0; i < probes.size(); i++)
+		sum += m.lower_bound(probes[i]) == m.end();
+	report(name + " lower_bound", now() - t, probes.size());
+	t = now();
+	for (typename Map::iterator it = m.begin(); it != m.end(); it++)
+		sum += it->second;
+	report(name + " full iteration", now() - t, keys.size());
+	t = now();
+	for (std::size_t i = 0; i < keys.size(); i += 2)
+		m.erase(keys[i]);
+	report(name + " erase half", now() - t, keys.size() / 2);
+	g_sink = sum;
+}
+
+template <class Key>
+static void bench_art_keys(const std::string& title, const ft::vector<Key>& keys)
+{
+	ft::vector<Key> probes;
+	for (std::size_t i = 0; i < 1000000; i++)
+		probes.push_back(keys[static_cast<std::size_t>(rand()) % keys.size()]);
+	std::cout << title << " (" << keys.size() << " keys)" << std::endl;
+	bench_ordered_map<ft::map<Key, int> >("ft::map", keys, probes);
+	bench_ordered_map<ft::art_map<Key, int> >("ft::art_map", keys, probes);
+}
+
+static void bench_art_map()
+{
+	//main2.cpp's map workload : rand() keys, then operator[] accesses which mostly insert
+	const int count = 42949672 / static_cast<int>(sizeof(int) + 4096);
+	double t = now();
+	{
+		ft::map<int, int> m;
+		for (int i = 0; i < count; ++i)
+			m.insert(ft::make_pair(rand(), rand()));
+		for (int i = 0; i < 10000; i++)
+			g_sink += m[rand()];
+	}
+	report("main2.cpp map workload, ft::map", now() - t, 0);
+	t = now();
+	{
+		ft::art_map<int, int> m;
+		for (int i = 0; i < count; ++i)
+			m.insert(ft::make_pair(rand(), rand()));
+		for (int i = 0; i < 10000; i++)
+			g_sink += m[rand()];
+	}
+	report("main2.cpp map workload, ft::art_map", now() - t, 0);
+
+	ft::vector<int> ints;
+	for (int i = 0; i < 1000000; i++)
+		ints.push_back(rand() - RAND_MAX / 2);
+	bench_art_keys("random int keys", ints);
+
+	ft::vector<std::string> urls;
+	for (int i = 0; i < 500000; i++)
+		urls.push_back("https://" + random_string(3 + rand() % 10) + ".com/" + random_string(4 + rand() % 20));
+	bench_art_keys("URL-like string keys", urls);
+}
+
+/// SMALL MAP ///
+
+//Builds, queries and destroys many maps of the given size
+template <class Map>
+static void bench_tiny_maps(const std::string& name, int entries)
+{
+	const int maps = 1000000 / (entries + 1);
+	long sum = 0;
+	double t = now();
+	for (int i = 0; i < maps; i++)
+	{
+		Map m;
+		for (int k = 0; k < entries; k++)
+			m[(k * 7919 + i) % 64] = k;
+		for (int k = 0; k < 64; k += 4)
+			sum += m.count(k);
+	}
+	std::ostringstream title;
+	title << name << ", " << entries << " entries";
+	report(title.str(), now() - t, maps);
+	g_sink = sum;
+}
+
+static void bench_small_map()
+{
+	const int sizes[] = {0, 1, 4, 8, 16};
+	for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		bench_tiny_maps<ft::map<int, int> >("ft::map", sizes[i]);
+		bench_tiny_maps<ft::small_map<int, int, 8> >("ft::small_map<8>", sizes[i]);
+	}
+}
+
+/// EMPTY MAPS ///
+
+//Maps embedded in records, most of them left empty or almost
+template <class Map>
+static void bench_short_lived_maps(const std::string& name, int entries)
+{
+	const int maps = 10000000 / (entries + 1);
+	long sum = 0;
+	double t = now();
+	for (int i = 0; i < maps; i++)
+	{
+		Map m;
+		for (int k = 0; k < entries; k++)
+			m.insert(typename Map::value_type(i + k, "value"));
+		sum += m.size();
+	}
+	std::ostringstream title;
+	title << name << ", " << entries << " entries";
+	report(title.str(), now() - t, maps);
+	g_sink = sum;
+}
+
+static void bench_empty_map()
+{
+	for (int entries = 0; entries <= 2; entries++)
+	{
+		bench_short_lived_maps<std::map<int, std::string> >("std::map<int, std::string>", entries);
+		bench_short_lived_maps<ft::map<int, std::string> >("ft::map<int, std::string>", entries);
+	}
+}
+
+/// SPLIT MAP ///
+
+template <std::size_t Size>
+struct payload
+{
+	char bytes[Size];
+	payload() { std::memset(bytes, 1, Size); }
+};
+
+//Lookups of random present keys, then a full in-order scan reading each element
+template <class Map>
+static void bench_split_lookups(const std::string& name, const ft::vector<int>& keys, const ft::vector<int>& probes)
+{
+	Map m;
+	for (std::size_t i = 0; i < keys.size(); i++)
+		m[keys[i]];
+	long sum = 0;
+	double t = now();
+	for (std::size_t i = 0; i < probes.size(); i++)
+		sum += m.find(probes[i])->second.bytes[0];
+	report(name + " find", now() - t, probes.size());
+	t = now();
+	for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->first + it->second.bytes[0];
+	report(name + " scan", now() - t, keys.size());
+	g_sink = sum;
+}
+
+template <std::size_t Size>
+static void bench_split_size(const ft::vector<int>& keys, const ft::vector<int>& probes)
+{
+	std::ostringstream title;
+	title << Size << " bytes, ";
+	bench_split_lookups<ft::map<int, payload<Size> > >(title.str() + "ft::map", keys, probes);
+	bench_split_lookups<ft::split_map<int, payload<Size> > >(title.str() + "ft::split_map", keys, probes);
+}
+
+static void bench_split_map()
+{
+	ft::vector<int> keys;
+	ft::vector<int> probes;
+	for (int i = 0; i < 200000; i++)
+		keys.push_back(rand());
+	for (int i = 0; i < 1000000; i++)
+		probes.push_back(keys[rand() % keys.size()]);
+	bench_split_size<8>(keys, probes);
+	bench_split_size<64>(keys, probes);
+	bench_split_size<256>(keys, probes);
+	bench_split_size<1024>(keys, probes);
+}
+
+/// MAP TRAVERSAL ///
+
+struct value_summer
+{
+	long sum;
+	value_summer() : sum(0) {}
+	void operator()(const ft::pair<const int, int>& p) { sum += p.second; }
+};
+
+template <class Map>
+static void bench_iterator_scan(const std::string& name, const Map& m, int rounds)
+{
+	long sum = 0;
+	double t = now();
+	for (int r = 0; r < rounds; r++)
+		for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+			sum += it->second;
+	report(name + " iterator scan", now() - t, m.size() * rounds);
+	g_sink = sum;
+}
+
+static void bench_map_traversal()
+{
+	const int sizes[] = {1000, 100000, 1000000};
+	for (std::size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		const int rounds = 10000000 / sizes[s];
+		std::map<int, int> std_map;
+		ft::map<int, int> ft_map;
+		for (int i = 0; i < sizes[s]; i++)
+		{
+			int k = rand();
+			std_map[k] = i;
+			ft_map[k] = i;
+		}
+		std::cout << ft_map.size() << " keys" << std::endl;
+		bench_iterator_scan("std::map", std_map, rounds);
+		bench_iterator_scan("ft::map", ft_map, rounds);
+		long sum = 0;
+		double t = now();
+		for (int r = 0; r < rounds; r++)
+			sum += ft_map.for_each(value_summer()).sum;
+		report("ft::map for_each", now() - t, ft_map.size() * rounds);
+
+		//ranges of about 100 keys
+		const int ranges = 100000;
+		const int width = RAND_MAX / sizes[s] * 100;
+		t = now();
+		for (int r = 0; r < ranges; r++)
+		{
+			int lo = rand() % (RAND_MAX - width);
+			std::map<int, int>::const_iterator hi = std_map.upper_bound(lo + width);
+			for (std::map<int, int>::const_iterator it = std_map.lower_bound(lo); it != hi; ++it)
+				sum += it->second;
+		}
+		report("std::map range scan", now() - t, ranges);
+		t = now();
+		for (int r = 0; r < ranges; r++)
+		{
+			int lo = rand() % (RAND_MAX - width);
+			ft::map<int, int>::const_iterator hi = ft_map.upper_bound(lo + width);
+			for (ft::map<int, int>::const_iterator it = ft_map.lower_bound(lo); it != hi; ++it)
+				sum += it->second;
+		}
+		report("ft::map range scan", now() - t, ranges);
+		t = now();
+		for (int r = 0; r < ranges; r++)
+		{
+			int lo = rand() % (RAND_MAX - width);
+			sum += ft_map.for_each_range(lo, lo + width, value_summer()).sum;
+		}
+		report("ft::map for_each_range", now() - t, ranges);
+		g_sink = sum;
+	}
+}
+
+/// PARALLEL MAP ALGORITHMS ///
+
+struct parallel_sum
+{
+	long operator()(long sum, const ft::pair<const int, int>& p) const { return sum + p.second; }
+	long operator()(long a, long b) const { return a + b; }
+};
+
+//A few hundred cycles of work per element
+struct hash_values
+{
+	void operator()(ft::pair<const int, int>& p) const
+	{
+		unsigned int h = static_cast<unsigned int>(p.second);
+		for (int i = 0; i < 64; i++)
+			h = h * 2654435761u + 0x9e3779b9u;
+		p.second = static_cast<int>(h >> 1);
+	}
+};
+
+static void bench_parallel_map()
+{
+	ft::map<int, int> m;
+	for (int i = 0; i < 2000000; i++)
+		m[rand()] = i;
+	std::cout << m.size() << " keys" << std::endl;
+
+	long sum = 0;
+	double t = now();
+	sum += m.for_each(value_summer()).sum;
+	report("sequential for_each sum", now() - t, m.size());
+	t = now();
+	m.for_each(hash_values());
+	report("sequential for_each hash", now() - t, m.size());
+	for (unsigned int threads = 1; threads <= ft::hardware_threads(); threads++)
+	{
+		std::ostringstream title;
+		title << threads << " thread" << (threads > 1 ? "s" : " ");
+		t = now();
+		sum += ft::parallel_reduce(m, 0L, parallel_sum(), parallel_sum(), threads);
+		report(title.str() + " parallel_reduce sum", now() - t, m.size());
+		t = now();
+		ft::parallel_for_each(m, hash_values(), threads);
+		report(title.str() + " parallel_for_each hash", now() - t, m.size());
+	}
+	g_sink = sum;
+}
+
+/// PARALLEL MAP CONSTRUCTION ///
+
+static void bench_build_map()
+{
+	ft::vector<ft::pair<int, int> > input;
+	for (int i = 0; i < 2000000; i++)
+		input.push_back(ft::make_pair(rand(), i));
+	std::cout << input.size() << " unsorted pairs" << std::endl;
+
+	double t = now();
+	double sequential;
+	{
+		ft::map<int, int> m(input.begin(), input.end());
+		sequential = now() - t;
+	}
+	report("range constructor", sequential, input.size());
+	for (unsigned int threads = 1; threads <= ft::hardware_threads(); threads++)
+	{
+		ft::map<int, int> m;
+		t = now();
+		ft::build_map_parallel(input.begin(), input.end(), m, ft::keep_first, threads);
+		double seconds = now() - t;
+		std::ostringstream title;
+		title << "build_map_parallel, " << threads << " thread" << (threads > 1 ? "s" : "");
+		report(title.str(), seconds, input.size());
+		std::cout << "  speedup " << std::fixed << std::setprecision(2) << sequential / seconds << "x" << std::endl;
+	}
+}
+
+/// BUFFERED MAP ///
+
+//Ingests random keys, then looks keys up while a quarter of the operations are still writes
+static void bench_buffered_map()
+{
+	const int writes = 1000000;
+	const int lookups = 200000;
+	ft::vector<int> keys;
+	for (int i = 0; i < writes; i++)
+		keys.push_back(rand());
+
+	ft::map<int, int> plain;
+	double t = now();
+	for (int i = 0; i < writes; i++)
+	{
+		ft::pair<ft::map<int, int>::iterator, bool> found = plain.insert(ft::make_pair(keys[i], i));
+		if (!found.second)
+			found.first->second = i;
+	}
+	report("ft::map ingest", now() - t, writes);
+	long sum = 0;
+	t = now();
+	for (int i = 0; i < lookups; i++)
+	{
+		if (i % 4 == 0)
+			plain[keys[i]] = i;
+		else
+			sum += plain.count(keys[(i * 7) % writes]);
+	}
+	report("ft::map mixed lookups", now() - t, lookups);
+
+	const std::size_t thresholds[] = {16, 256, 4096, 65536};
+	for (std::size_t th = 0; th < sizeof(thresholds) / sizeof(thresholds[0]); th++)
+	{
+		ft::buffered_map<int, int> m(thresholds[th]);
+		std::ostringstream name;
+		name << "buffered_map<" << thresholds[th] << ">";
+		t = now();
+		for (int i = 0; i < writes; i++)
+			m.assign(keys[i], i);
+		m.flush();
+		report(name.str() + " ingest", now() - t, writes);
+		t = now();
+		for (int i = 0; i < lookups; i++)
+		{
+			if (i % 4 == 0)
+				m.assign(keys[i], i);
+			else
+				sum += m.count(keys[(i * 7) % writes]);
+		}
+		report(name.str() + " mixed lookups", now() - t, lookups);
+	}
+	g_sink = sum;
+}
+
+/// MAP COMPACTION ///
+
+static void bench_compacted_map(const std::string& when, ft::map<int, int>& m, const ft::vector<int>& probes)
+{
+	long sum = 0;
+	double t = now();
+	for (ft::map<int, int>::const_iterator it = m.begin(); it != m.end(); ++it)
+		sum += it->second;
+	report(when + " iterator scan", now() - t, m.size());
+	t = now();
+	sum += m.for_each(value_summer()).sum;
+	report(when + " for_each scan", now() - t, m.size());
+	t = now();
+	for (std::size_t i = 0; i < probes.size(); i++)
+		sum += m.count(probes[i]);
+	report(when + " find", now() - t, probes.size());
+	g_sink = sum;
+}
+
+static void bench_map_compact()
+{
+	//insertions and erasures interleaved with other allocations scatter the nodes
+	ft::map<int, int> m;
+	ft::vector<int> keys;
+	ft::vector<std::string *> noise;
+	for (int i = 0; i < 1000000; i++)
+	{
+		keys.push_back(rand());
+		m[keys.back()] = i;
+	}
+	for (int i = 0; i < 2000000; i++)
+	{
+		std::size_t victim = static_cast<std::size_t>(rand()) % keys.size();
+		m.erase(keys[victim]);
+		keys[victim] = rand();
+		m[keys[victim]] = i;
+		if (i % 4 == 0)
+			noise.push_back(new std::string(40, 'n'));
+	}
+	ft::vector<int> probes;
+	for (int i = 0; i < 1000000; i++)
+		probes.push_back(keys[static_cast<std::size_t>(rand()) % keys.size()]);
+	std::cout << m.size() << " keys after 2M erasures and insertions" << std::endl;
+
+	bench_compacted_map("churned  ", m, probes);
+	double t = now();
+	m.compact();
+	report("compact()", now() - t, m.size());
+	bench_compacted_map("compacted", m, probes);
+	for (std::size_t i = 0; i < noise.size(); i++)
+		delete noise[i];
+}
+
+/// VECTOR RELOCATION ///
+
+//main2.cpp's element
+struct bench_buffer
+{
+	int idx;
+	char buff[4096];
+};
+
+//main2.cpp's workload (push_back of 4 KB buffers), then insertions and erasures at the front, which shift everything
+template <class Vector>
+static void bench_vector_shifts(const std::string& name, typename Vector::value_type val, int count, int shifts)
+{
+	double t = now();
+	{
+		Vector v;
+		for (int i = 0; i < count; i++)
+			v.push_back(val);
+		report(name + " push_back", now() - t, count);
+		t = now();
+		for (int i = 0; i < shifts; i++)
+			v.insert(v.begin(), val);
+		for (int i = 0; i < shifts; i++)
+			v.erase(v.begin());
+		report(name + " front insert/erase", now() - t, 2 * shifts);
+		t = now();
+	}
+	report(name + " destruction", now() - t, count);
+}
+
+static void bench_vector_relocation()
+{
+	bench_buffer buffer;
+	std::memset(&buffer, 0, sizeof(buffer));
+	const int buffers = 42949672 / static_cast<int>(sizeof(bench_buffer));
+	bench_vector_shifts<std::vector<bench_buffer> >("std::vector<Buffer>", buffer, buffers, 200);
+	bench_vector_shifts<ft::vector<bench_buffer> >("ft::vector<Buffer>", buffer, buffers, 200);
+	bench_vector_shifts<std::vector<int> >("std::vector<int>", 1, 1000000, 2000);
+	bench_vector_shifts<ft::vector<int> >("ft::vector<int>", 1, 1000000, 2000);
+	bench_vector_shifts<std::vector<std::string> >("std::vector<std::string>", "a string", 1000000, 200);
+	bench_vector_shifts<ft::vector<std::string> >("ft::vector<std::string>", "a string", 1000000, 200);
+}
+
+/// VECTOR GROWTH ///
+
+//Single-element insertions at the end or in the middle, counting the reallocations : with a geometric growth,
+//end insertions are amortized O(1) and middle insertions only pay for the shift
+template <class Vector>
+static void bench_vector_inserts(const std::string& name, bool middle, int count)
+{
+	double t = now();
+	Vector v;
+	int reallocations = 0;
+	for (int i = 0; i < count; i++)
+	{
+		typename Vector::size_type capacity = v.capacity();
+		v.insert(middle ? v.begin() + v.size() / 2 : v.end(), i);
+		if (v.capacity() != capacity)
+			reallocations++;
+	}
+	double elapsed = now() - t;
+	std::ostringstream title;
+	title << name << (middle ? " middle" : " end") << " insert, " << reallocations << " reallocations";
+	report(title.str(), elapsed, count);
+	g_sink = v.size();
+}
+
+static void bench_vector_growth()
+{
+	for (int middle = 0; middle < 2; middle++)
+	{
+		int count = middle ? 50000 : 200000;
+		bench_vector_inserts<std::vector<int> >("std::vector<int>", middle, count);
+		bench_vector_inserts<ft::vector<int> >("ft::vector<int> (grow_double)", middle, count);
+		bench_vector_inserts<ft::vector<int, std::allocator<int>, ft::grow_one_and_half> >("ft::vector<int> (grow_one_and_half)", middle, count);
+		bench_vector_inserts<ft::vector<int, std::allocator<int>, ft::grow_size_class> >("ft::vector<int> (grow_size_class)", middle, count);
+	}
+}
+
+/// MOVE SEMANTICS ///
+
+//Workloads passing temporaries, to compare the builds of make STD=c++98 (copies) and make STD=c++11 (moves)
+static void bench_move_semantics()
+{
+	const int count = 200000;
+	std::cout << "  built with " << (FT_MOVE_SEMANTICS ? "move semantics" : "copies only") << std::endl;
+
+	double t = now();
+	{
+		ft::vector<std::string> strings;
+		for (int i = 0; i < count; i++)
+			strings.push_back(std::string(64, static_cast<char>('a' + i % 26)));
+		report("ft::vector<std::string> push_back of temporaries", now() - t, count);
+		t = now();
+		ft::vector<std::string> taken;
+		taken.swap(strings);
+		strings.reserve(taken.size());
+		for (int i = 0; i < count; i++)
+			strings.push_back(FT_MOVE(taken[i]));
+		report("ft::vector<std::string> transfer to another vector", now() - t, count);
+		t = now();
+		strings.reserve(strings.capacity() * 2);
+		report("ft::vector<std::string> reallocation", now() - t, count);
+	}
+
+	const int buffers = 10000;
+	t = now();
+	{
+		ft::vector<bench_buffer> v;
+		for (int i = 0; i < buffers; i++)
+#if FT_MOVE_SEMANTICS
+			v.emplace_back();
+#else
+			v.push_back(bench_buffer());
+#endif
+		report("ft::vector<Buffer> push_back(Buffer()) / emplace_back()", now() - t, buffers);
+	}
+
+	t = now();
+	{
+		ft::map<int, std::string> m;
+		for (int i = 0; i < count; i++)
+			m.insert(ft::make_pair(i, std::string(64, 'm')));
+		report("ft::map<int, std::string> insert of temporaries", now() - t, count);
+		t = now();
+		for (int i = 0; i < count; i++)
+			m[i] = std::string(64, 'n');
+		report("ft::map<int, std::string> operator[] assignment of temporaries", now() - t, count);
+		g_sink = m.size();
+	}
+}
+
+/// MAP HITS ///
+
+//operator[] and insert on keys which are all present (main2.cpp's access loop) : the key is searched before any allocation
+template <class Map>
+static void bench_map_hit_accesses(const std::string& name, const std::vector<int>& keys, int rounds)
+{
+	Map m;
+	for (std::size_t i = 0; i < keys.size(); i++)
+		m[keys[i]] = typename Map::mapped_type();
+	double t = now();
+	std::size_t sum = 0;
+	for (int r = 0; r < rounds; r++)
+		for (std::size_t i = 0; i < keys.size(); i++)
+			sum += reinterpret_cast<std::size_t>(&m[keys[i]]);
+	report(name + " operator[] hits", now() - t, rounds * keys.size());
+	t = now();
+	for (int r = 0; r < rounds; r++)
+		for (std::size_t i = 0; i < keys.size(); i++)
+			sum += m.insert(typename Map::value_type(keys[i], typename Map::mapped_type())).second;
+	report(name + " insert of present keys", now() - t, rounds * keys.size());
+	g_sink = sum;
+}
+
+static void bench_map_hits()
+{
+	std::vector<int> keys;
+	for (int i = 0; i < 100000; i++)
+		keys.push_back(rand());
+	bench_map_hit_accesses<std::map<int, int> >("std::map<int, int>", keys, 10);
+	bench_map_hit_accesses<ft::map<int, int> >("ft::map<int, int>", keys, 10);
+	bench_map_hit_accesses<std::map<int, std::string> >("std::map<int, std::string>", keys, 10);
+	bench_map_hit_accesses<ft::map<int, std::string> >("ft::map<int, std::string>", keys, 10);
+}
+
+/// NODE HANDLES ///
+
+typedef ft::map<int, std::string> shard_map;
+
+static void fill_shard(shard_map& m, int count)
+{
+	for (int i = 0; i < count; i++)
+		m[i] = std::string(256, static_cast<char>('a' + i % 26));
+}
+
+//Migration of the odd keys of a shard to another one
+static void bench_node_handles()
+{
+	const int count = 200000;
+	shard_map from;
+	shard_map to;
+	fill_shard(from, count);
+	double t = now();
+	for (shard_map::iterator it = from.begin(); it != from.end(); )
+	{
+		if (it->first % 2 == 0)
+		{
+			++it;
+			continue;
+		}
+		to.insert(*it);
+		from.erase(it++);
+	}
+	report("ft::map<int, std::string> migration by insert + erase", now() - t, count / 2);
+
+	shard_map from2;
+	shard_map to2;
+	fill_shard(from2, count);
+	t = now();
+	for (shard_map::iterator it = from2.begin(); it != from2.end(); )
+	{
+		if (it->first % 2 == 0)
+		{
+			++it;
+			continue;
+		}
+		to2.insert(from2.extract(it++));
+	}
+	report("ft::map<int, std::string> migration by extract + insert", now() - t, count / 2);
+
+	t = now();
+	to.merge(to2);
+	report("ft::map<int, std::string> merge of all present keys", now() - t, count / 2);
+	t = now();
+	to.merge(from2);
+	report("ft::map<int, std::string> merge of new keys", now() - t, count / 2);
+	g_sink = to.size() + to2.size() + from.size();
+}
+
+/// SMALL VECTOR ///
+
+static std::size_t g_vector_allocations = 0;
+
+//std::allocator counting its allocations
+template <class T>
+struct counted_allocator : public std::allocator<T>
+{
+	template <class U>
+	struct rebind
+	{
+		typedef counted_allocator<U> other;
+	};
+
+	counted_allocator() {}
+
+	template <class U>
+	counted_allocator(const counted_allocator<U>&) {}
+
+	T * allocate(std::size_t n, const void * = 0)
+	{
+		g_vector_allocations++;
+		return std::allocator<T>::allocate(n);
+	}
+};
+
+//Short-lived vectors of a few elements, filled then walked, as temporaries of a parsing or routing loop
+template <class Vector>
+static void bench_short_lived_vectors(const std::string& name, int elements)
+{
+	const int vectors = 20000000 / (elements + 2);
+	g_vector_allocations = 0;
+	long sum = 0;
+	double t = now();
+	for (int i = 0; i < vectors; i++)
+	{
+		Vector v;
+		for (int k = 0; k < elements; k++)
+			v.push_back(i + k);
+		for (typename Vector::iterator it = v.begin(); it != v.end(); ++it)
+			sum += *it;
+	}
+	double elapsed = now() - t;
+	std::ostringstream title;
+	title << name << ", " << elements << " ints, " << std::setprecision(2) << std::fixed
+		<< static_cast<double>(g_vector_allocations) / vectors << " allocs";
+	report(title.str(), elapsed, vectors);
+	g_sink = sum;
+}
+
+static void bench_small_vector()
+{
+	const int sizes[] = {1, 4, 7, 8, 16};
+	for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		bench_short_lived_vectors<ft::vector<int, counted_allocator<int> > >("ft::vector", sizes[i]);
+		bench_short_lived_vectors<ft::small_vector<int, 8, counted_allocator<int> > >("ft::small_vector<8>", sizes[i]);
+	}
+
+	//a stack of a few elements per iteration
+	const int rounds = 5000000;
+	for (int small = 0; small < 2; small++)
+	{
+		g_vector_allocations = 0;
+		long sum = 0;
+		double t = now();
+		for (int i = 0; i < rounds; i++)
+		{
+			if (small)
+			{
+				ft::stack<int, ft::small_vector<int, 8, counted_allocator<int> > > stack;
+				for (int k = 0; k < 6; k++)
+					stack.push(i ^ k);
+				sum += stack.top();
+			}
+			else
+			{
+				ft::stack<int, ft::vector<int, counted_allocator<int> > > stack;
+				for (int k = 0; k < 6; k++)
+					stack.push(i ^ k);
+				sum += stack.top();
+			}
+		}
+		std::ostringstream title;
+		title << (small ? "ft::stack on ft::small_vector<8>" : "ft::stack on ft::vector") << ", "
+			<< g_vector_allocations / rounds << " allocs";
+		report(title.str(), now() - t, rounds);
+		g_sink = sum;
+	}
+}
+
+/// STATIC VECTOR ///
+
+//push_back, or push_back_unchecked for the vectors which have it
+template <class Vector>
+static void push_field(Vector& v, int value, bool)
+{
+	v.push_back(value);
+}
+
+static void push_field(ft::static_vector<int, 32>& v, int value, bool unchecked)
+{
+	if (unchecked)
+		v.push_back_unchecked(value);
+	else
+		v.push_back(value);
+}
+
+//Per-packet scratch arrays of a known upper bound, filled then summed
+template <class Vector>
+static void bench_scratch_arrays(const std::string& name, bool unchecked)
+{
+	const int packets = 2000000;
+	const int fields = 32;
+	long sum = 0;
+	double t = now();
+	for (int i = 0; i < packets; i++)
+	{
+		Vector v;
+		for (int k = 0; k < fields; k++)
+			push_field(v, i ^ k, unchecked);
+		for (int k = 0; k < fields; k++)
+			sum += v[k];
+	}
+	report(name + (unchecked ? " push_back_unchecked" : " push_back"), now() - t, packets);
+	g_sink = sum;
+}
+
+static void bench_static_vector()
+{
+	bench_scratch_arrays<ft::vector<int> >("ft::vector<int>", false);
+	bench_scratch_arrays<ft::small_vector<int, 32> >("ft::small_vector<32>", false);
+	bench_scratch_arrays<ft::static_vector<int, 32> >("ft::static_vector<32>", false);
+	bench_scratch_arrays<ft::static_vector<int, 32> >("ft::static_vector<32>", true);
+
+	//copies of a trivially copyable static_vector are a memcpy of the object
+	const int copies = 2000000;
+	ft::vector<int> heap(16, 1);
+	ft::static_vector<int, 32> inline_ints(16, 1);
+	long sum = 0;
+	double t = now();
+	for (int i = 0; i < copies; i++)
+	{
+		ft::vector<int> copy(heap);
+		sum += copy[i % 16];
+	}
+	report("ft::vector<int> copy of 16 ints", now() - t, copies);
+	t = now();
+	for (int i = 0; i < copies; i++)
+	{
+		ft::static_vector<int, 32> copy(inline_ints);
+		sum += copy[i % 16];
+	}
+	report("ft::static_vector<32> copy of 16 ints", now() - t, copies);
+	g_sink = sum;
+}
+
+/// SIMD ///
+
+static const char * const g_simd_level_names[] = {"scalar", "sse2", "avx2"};
+
+//The algorithms on 64 KB ranges of T, which fit in the L2 cache, at every level the CPU supports
+template <class T>
+static void bench_simd_type(const std::string& name, std::size_t n, int rounds)
+{
+	ft::vector<T> a;
+	for (std::size_t i = 0; i < n; i++)
+		a.push_back(static_cast<T>(rand() % 100));
+	ft::vector<T> b(a);
+	T absent = static_cast<T>(100);
+	ft::simd_level detected = ft::get_simd_level();
+	std::size_t ops = rounds; //passes over the range
+	for (int level = ft::simd_scalar; level <= detected; level++)
+	{
+		ft::set_simd_level(static_cast<ft::simd_level>(level));
+		std::string title = name + " " + g_simd_level_names[level];
+		long sum = 0;
+		double t = now();
+		for (int r = 0; r < rounds; r++)
+			sum += ft::find(a.begin(), a.end(), absent) - a.begin();
+		report(title + " find", now() - t, ops);
+		t = now();
+		for (int r = 0; r < rounds; r++)
+			sum += ft::count(a.begin(), a.end(), static_cast<T>(r % 100));
+		report(title + " count", now() - t, ops);
+		t = now();
+		for (int r = 0; r < rounds; r++)
+			sum += *ft::min_element(a.begin(), a.end()) + *ft::max_element(a.begin(), a.end());
+		report(title + " min_element + max_element", now() - t, ops);
+		t = now();
+		for (int r = 0; r < rounds; r++)
+			sum += ft::accumulate(a.begin(), a.end(), static_cast<T>(r));
+		report(title + " accumulate", now() - t, ops);
+		t = now();
+		for (int r = 0; r < rounds; r++)
+			sum += (a == b) + (a < b);
+		report(title + " operator== + operator<", now() - t, ops);
+		g_sink = sum;
+	}
+	ft::set_simd_level(detected);
+}
+
+static void bench_simd()
+{
+	std::cout << "  detected level: " << g_simd_level_names[ft::get_simd_level()] << std::endl;
+	bench_simd_type<char>("char", 65536, 2000);
+	bench_simd_type<short>("short", 32768, 2000);
+	bench_simd_type<int>("int", 16384, 2000);
+	bench_simd_type<long long>("long long", 8192, 2000);
+}
+
+/// VECTOR<BOOL> ///
+
+//A set of 64M flags, one in 16 set, as a vector<bool> and as a vector of one byte per flag : memory, then
+//counting, visiting the set flags, and intersecting two sets
+static void bench_vector_bool()
+{
+	const std::size_t n = 64 << 20;
+	const int rounds = 10;
+	ft::vector<bool> bits(n, false), other_bits(n, false);
+	ft::vector<unsigned char> bytes(n, 0), other_bytes(n, 0);
+	for (std::size_t i = 0; i < n / 16; i++)
+	{
+		std::size_t a = static_cast<std::size_t>(rand()) % n, b = static_cast<std::size_t>(rand()) % n;
+		bits[a] = true;
+		bytes[a] = 1;
+		other_bits[b] = true;
+		other_bytes[b] = 1;
+	}
+	std::cout << "  memory: vector<bool> " << bits.capacity() / 8 / 1024 << " KB, vector<unsigned char> "
+		<< bytes.capacity() / 1024 << " KB" << std::endl;
+	std::size_t ops = n / 1024 * rounds; //blocks of 1024 flags
+	long sum = 0;
+
+	double t = now();
+	for (int r = 0; r < rounds; r++)
+		sum += bits.count();
+	report("vector<bool> count", now() - t, ops);
+	t = now();
+	for (int r = 0; r < rounds; r++)
+		sum += ft::count(bytes.begin(), bytes.end(), 1);
+	report("byte vector count", now() - t, ops);
+
+	t = now();
+	for (int r = 0; r < rounds; r++)
+		for (std::size_t i = bits.find_first(); i != n; i = bits.find_next(i))
+			sum += i;
+	report("vector<bool> find_first + find_next", now() - t, ops);
+	t = now();
+	for (int r = 0; r < rounds; r++)
+	{
+		ft::vector<unsigned char>::iterator end = bytes.end();
+		for (ft::vector<unsigned char>::iterator it = ft::find(bytes.begin(), end, 1); it != end; it = ft::find(it + 1, end, 1))
+			sum += it - bytes.begin();
+	}
+	report("byte vector find loop", now() - t, ops);
+
+	t = now();
+	for (int r = 0; r < rounds; r++)
+		bits &= other_bits;
+	report("vector<bool> operator&=", now() - t, ops);
+	t = now();
+	for (int r = 0; r < rounds; r++)
+		for (std::size_t i = 0; i < n; i++)
+			bytes[i] &= other_bytes[i];
+	report("byte vector and loop", now() - t, ops);
+	g_sink = sum + bits.count() + ft::count(bytes.begin(), bytes.end(), 1);
+}
+
+/// MMAP ALLOCATOR ///
+
+//Peak address space of the process in MB, which counts the blocks before their pages are touched
+static long peak_virtual_mb()
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+		if (line.compare(0, 7, "VmPeak:") == 0)
+			return atol(line.c_str() + 7) / 1024;
+	return 0;
+}
+
+//Fills a vector of long long by push_back up to bytes, in a child process so that its peak resident memory is its own
+template <class Alloc>
+static void bench_huge_vector(const std::string& title, std::size_t bytes)
+{
+	std::cout.flush();
+	pid_t pid = fork();
+	if (pid != 0)
+	{
+		waitpid(pid, 0, 0);
+		return;
+	}
+	std::size_t n = bytes / sizeof(long long);
+	double t = now();
+	{
+		ft::vector<long long, Alloc> v;
+		for (std::size_t i = 0; i < n; i++)
+			v.push_back(static_cast<long long>(i));
+		g_sink = static_cast<long>(v[n / 2]);
+	}
+	double seconds = now() - t;
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	std::ostringstream what;
+	what << title << " " << (bytes >> 20) << " MB";
+	report(what.str(), seconds, n);
+	std::cout << "    peak RSS " << usage.ru_maxrss / 1024 << " MB, peak address space " << peak_virtual_mb() << " MB" << std::endl;
+	_exit(0);
+}
+
+//Many vectors of ints growing to 1 to 64 KB, where the allocator serves whole size classes
+template <class Alloc>
+static void bench_mid_vectors(const std::string& title)
+{
+	const int rounds = 20000;
+	double t = now();
+	for (int r = 0; r < rounds; r++)
+	{
+		ft::vector<int, Alloc> v;
+		int n = 256 << (r % 7);
+		for (int i = 0; i < n; i++)
+			v.push_back(i);
+		g_sink = v[n / 2];
+	}
+	report(title, now() - t, rounds);
+}
+
+static void bench_mmap_allocator()
+{
+	std::size_t sizes[] = {std::size_t(256) << 20, std::size_t(2048) << 20};
+	for (int s = 0; s < 2; s++)
+	{
+		bench_huge_vector< std::allocator<long long> >("std::allocator push_back", sizes[s]);
+		bench_huge_vector< ft::mmap_allocator<long long> >("mmap_allocator push_back", sizes[s]);
+	}
+	bench_mid_vectors< std::allocator<int> >("std::allocator vectors of 1 to 64 KB");
+	bench_mid_vectors< ft::mmap_allocator<int> >("mmap_allocator vectors of 1 to 64 KB");
+}
+
+/// UNINITIALIZED STORAGE ///
+
+//The 4 KB Buffer of main2.cpp
+struct io_buffer
+{
+	int idx;
+	char buff[4096];
+};
+
+//A reused vector filled with 64 MB by memcpy, standing for read() : sized with resize, which first copies a zeroed
+//element into every slot, or with resize_default_init or append_uninitialized + commit, which do not
+static void bench_vector_uninitialized()
+{
+	const std::size_t n = 16384;
+	const std::size_t chunk = 16;
+	const int rounds = 20;
+	std::size_t ops = n * rounds; //4 KB blocks filled
+	ft::vector<io_buffer> source(chunk);
+	for (std::size_t i = 0; i < chunk; i++)
+	{
+		source[i].idx = static_cast<int>(i);
+		std::memset(source[i].buff, 'a' + static_cast<int>(i), sizeof(source[i].buff));
+	}
+	const io_buffer * src = &source[0];
+	ft::vector<io_buffer> buffers;
+	long sum = 0;
+
+	double t = now();
+	for (int r = 0; r < rounds; r++)
+	{
+		buffers.clear();
+		buffers.resize(n);
+		for (std::size_t i = 0; i < n; i += chunk)
+			std::memcpy(static_cast<void *>(&buffers[i]), src, chunk * sizeof(io_buffer));
+		sum += buffers[r].idx;
+	}
+	report("vector<Buffer> resize + memcpy", now() - t, ops);
+	t = now();
+	for (int r = 0; r < rounds; r++)
+	{
+		buffers.clear();
+		buffers.resize_default_init(n);
+		for (std::size_t i = 0; i < n; i += chunk)
+			std::memcpy(static_cast<void *>(&buffers[i]), src, chunk * sizeof(io_buffer));
+		sum += buffers[r].idx;
+	}
+	report("vector<Buffer> resize_default_init + memcpy", now() - t, ops);
+	t = now();
+	for (int r = 0; r < rounds; r++)
+	{
+		buffers.clear();
+		for (std::size_t i = 0; i < n; i += chunk)
+		{
+			std::memcpy(static_cast<void *>(buffers.append_uninitialized(chunk)), src, chunk * sizeof(io_buffer));
+			buffers.commit(chunk);
+		}
+		sum += buffers[r].idx;
+	}
+	report("vector<Buffer> append_uninitialized + commit", now() - t, ops);
+
+	const char * bytes = source[0].buff;
+	const std::size_t block = sizeof(source[0].buff);
+	ft::vector<char> input;
+	t = now();
+	for (int r = 0; r < rounds; r++)
+	{
+		input.clear();
+		for (std::size_t i = 0; i < n; i++)
+		{
+			input.resize(input.size() + block);
+			std::memcpy(&input[input.size() - block], bytes, block);
+		}
+		sum += input[r];
+	}
+	report("vector<char> resize + memcpy", now() - t, ops);
+	t = now();
+	for (int r = 0; r < rounds; r++)
+	{
+		input.clear();
+		for (std::size_t i = 0; i < n; i++)
+		{
+			std::memcpy(input.append_uninitialized(block), bytes, block);
+			input.commit(block);
+		}
+		sum += input[r];
+	}
+	report("vector<char> append_uninitialized + commit", now() - t, ops);
+	g_sink = sum;
+}
+
+/// DRIVER ///
+
+struct benchmark
+{
+	const char * name;
+	void (*run)();
+};
+
+static const benchmark g_benchmarks[] = {
+	{"frozen_map", bench_frozen_map},
+	{"interval_map", bench_interval_map},
+	{"map_aggregate", bench_map_aggregate},
+	{"three_way", bench_three_way},
+	{"prefix_cache", bench_prefix_cache},
+	{"art_map", bench_art_map},
+	{"small_map", bench_small_map},
+	{"empty_map", bench_empty_map},
+	{"split_map", bench_split_map},
+	{"map_traversal", bench_map_traversal},
+	{"parallel_map", bench_parallel_map},
+	{"build_map", bench_build_map},
+	{"buffered_map", bench_buffered_map},
+	{"map_compact", bench_map_compact},
+	{"vector_relocation", bench_vector_relocation},
+	{"vector_growth", bench_vector_growth},
+	{"move_semantics", bench_move_semantics},
+	{"map_hits", bench_map_hits},
+	{"node_handles", bench_node_handles},
+	{"small_vector", bench_small_vector},
+	{"static_vector", bench_static_vector},
+	{"simd", bench_simd},
+	{"vector_bool", bench_vector_bool},
+	{"mmap_allocator", bench_mmap_allocator},
+	{"vector_uninitialized", bench_vector_uninitialized},
+};
+
+int main(int argc, char** argv)
+{
+	const std::size_t nb_benchmarks = sizeof(g_benchmarks) / sizeof(g_benchmarks[0]);
+
+	srand(42);
+	for (std::size_t i = 0; i < nb_benchmarks; i++)
+	{
+		bool selected = (argc == 1);
+		for (int a = 1; a < argc; a++)
+			if (std::strcmp(argv[a], g_benchmarks[i].name) == 0)
+				selected = true;
+		if (selected)
+		{
+			std::cout << "=== " << g_benchmarks[i].name << " ===" << std::endl;
+			g_benchmarks[i].run();
+		}
+	}
+	return (0);
+}
@@ -3,13 +3,222 @@
 
 # include <memory>
 # include <functional>
+# include <limits>
+# include <stdexcept>
 # include "utils.hpp"
 # include "avl_tree.hpp"
 # include "iterator.hpp"
 
 namespace ft
 {
-	template < class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::TreeNode<pair<const Key,T> > > >
+	///--------------------///
+	/// AGGREGATE POLICIES ///
+	///--------------------///
+
+	//Base of the map augmentation policies computing an aggregate of the mapped values (see map::aggregate).
+	//Derived must define identity(), lift(mapped value) and an associative combine(a, b) with identity() as neutral element.
+	//Each node stores the aggregate of its subtree, combined in key order, so combine does not need to be commutative.
+	template <class Derived, class Result>
+	struct aggregate_policy : public no_augmentation
+	{
+		typedef Result data_type;
+
+		template <class Node>
+		static void init(Node * r)
+		{
+			update(r);
+		}
+
+		template <class Node>
+		static void update(Node * r)
+		{
+			r->aug = Derived::lift(r->value.second);
+			if (r->left)
+				r->aug = Derived::combine(r->left->aug, r->aug);
+			if (r->right)
+				r->aug = Derived::combine(r->aug, r->right->aug);
+		}
+	};
+
+	//Sum of the mapped values
+	template <class T>
+	struct sum_aggregate : public aggregate_policy<sum_aggregate<T>, T>
+	{
+		static T identity() { return T(); }
+		static T lift(const T& v) { return v; }
+		static T combine(const T& a, const T& b) { return a + b; }
+	};
+
+	//Smallest mapped value. The aggregate of an empty range is the greatest value of T.
+	template <class T>
+	struct min_aggregate : public aggregate_policy<min_aggregate<T>, T>
+	{
+		static T identity() { return std::numeric_limits<T>::max(); }
+		static T lift(const T& v) { return v; }
+		static T combine(const T& a, const T& b) { return b < a ? b : a; }
+	};
+
+	//Greatest mapped value. The aggregate of an empty range is the lowest value of T.
+	template <class T>
+	struct max_aggregate : public aggregate_policy<max_aggregate<T>, T>
+	{
+		static T identity() { return std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::min() : -std::numeric_limits<T>::max(); }
+		static T lift(const T& v) { return v; }
+		static T combine(const T& a, const T& b) { return a < b ? b : a; }
+	};
+
+	//Number of elements
+	struct count_aggregate : public aggregate_policy<count_aggregate, std::size_t>
+	{
+		static std::size_t identity() { return 0; }
+		template <class T>
+		static std::size_t lift(const T&) { return 1; }
+		static std::size_t combine(std::size_t a, std::size_t b) { return a + b; }
+	};
+
+	///------------------///
+	/// KEY PREFIX CACHE ///
+	///------------------///
+
+	//Node layout for maps of std::string ordered by std::less : each node keeps the first 8 bytes of its key
+	//packed big-endian in an integer (shorter keys are padded with zeros), so that comparing two prefixes as integers
+	//orders them like the strings. Searches compare the prefixes first, and read the key itself only when they are equal,
+	//which saves the cache miss on the string buffer at most levels of the tree. It only helps when the keys differ early:
+	//keys sharing a long common prefix (URLs of a single site...) always tie and pay for the extra comparison.
+	struct key_prefix_cache : public no_augmentation
+	{
+		typedef unsigned long long data_type;
+		typedef unsigned long long cache_type;
+
+		static cache_type key_cache(const std::string& key)
+		{
+			cache_type prefix = 0;
+			for (std::size_t i = 0; i < sizeof(cache_type); i++)
+				prefix = (prefix << 8) | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0);
+			return prefix;
+		}
+
+		template <class V>
+		static cache_type value_cache(const V& value)
+		{
+			return key_cache(value.first);
+		}
+
+		template <class Node>
+		static void init(Node * r)
+		{
+			r->aug = key_cache(r->value.first);
+		}
+
+		template <class Node>
+		static int compare_cached(cache_type prefix, const Node * r)
+		{
+			return (prefix > r->aug) - (prefix < r->aug);
+		}
+	};
+
+	//Whether a map ordered by Compare can use the node layout Augment. The cached prefixes order the keys like
+	//std::less<std::string>, so key_prefix_cache would search a map ordered any other way in the wrong direction.
+	template <class Augment, class Compare>
+	struct augment_accepts_compare : public ft::integral_constant<bool, true> {};
+
+	template <class Compare>
+	struct augment_accepts_compare<key_prefix_cache, Compare> : public ft::is_same<Compare, std::less<std::string> > {};
+
+	template <class Map, bool is_const>
+	class map_subtrees;
+
+	template <class Map>
+	class map_builder;
+
+	//Owner of a node extracted from a map (see map::extract). Its element can be modified, key included, then
+	//inserted into a map of the same type without copying nor allocating. The node is destroyed with its handle if it is
+	//not inserted. Like std::auto_ptr, copying a handle (or passing it by value) transfers the node, and empties the source.
+	template <class Key, class T, class Node, class NodeAlloc>
+	class map_node_handle
+	{
+		public:
+			typedef Key key_type;
+			typedef T mapped_type;
+			typedef NodeAlloc allocator_type;
+
+			map_node_handle() : _node(NULL) {}
+
+			map_node_handle(const map_node_handle& x) : _node(x.release()), _alloc(x._alloc) {}
+
+			map_node_handle& operator= (const map_node_handle& x)
+			{
+				if (&x != this)
+				{
+					reset();
+					_alloc = x._alloc;
+					_node = x.release();
+				}
+				return *this;
+			}
+
+			~map_node_handle()
+			{
+				reset();
+			}
+
+			bool empty() const
+			{
+				return _node == NULL;
+			}
+
+			//The key can be changed before inserting the node again
+			key_type& key() const
+			{
+				return const_cast<key_type&>(_node->value.first);
+			}
+
+			mapped_type& mapped() const
+			{
+				return _node->value.second;
+			}
+
+			allocator_type get_allocator() const
+			{
+				return _alloc;
+			}
+
+			void swap (map_node_handle& x)
+			{
+				std::swap(_node, x._node);
+				std::swap(_alloc, x._alloc);
+			}
+
+		private:
+			mutable Node * _node; //mutable so that copies can take it
+			allocator_type _alloc;
+
+			map_node_handle(Node * node, const allocator_type& alloc) : _node(node), _alloc(alloc) {}
+
+			//Gives up the ownership of the node
+			Node * release() const
+			{
+				Node * node = _node;
+				_node = NULL;
+				return node;
+			}
+
+			void reset()
+			{
+				if (_node == NULL)
+					return;
+				_alloc.destroy(_node);
+				_alloc.deallocate(_node, 1);
+				_node = NULL;
+			}
+
+			template <class, class, class, class, class>
+			friend class map;
+	};
+
+	//Augment : augmentation policy of the inner AVL tree. With one of the aggregate policies above, map::aggregate
+	//computes the aggregate of a key range in O(log(n)). With key_prefix_cache, string keys are compared through their cached prefix.
+	template < class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::TreeNode<pair<const Key,T> > >, class Augment = ft::no_augmentation >
 	class map
 	{	
 		public:
@@ -34,10 +243,15 @@ namespace ft
 					typedef bool result_type;
 					typedef value_type first_argument_type;
 					typedef value_type second_argument_type;
+					typedef void is_three_way; //used by the tree to compare keys once per level (see ft::three_way)
 					bool operator() (const value_type& x, const value_type& y) const
 					{
 						return comp(x.first, y.first);
 					}
+					int three_way (const value_type& x, const value_type& y) const
+					{
+						return key_three_way<key_type, Compare>::compare(comp, x.first, y.first);
+					}
 			};
 
 			typedef Alloc allocator_type;
@@ -45,27 +259,43 @@ namespace ft
 			typedef typename allocator_type::const_reference const_reference;
 			typedef typename allocator_type::pointer pointer;
 			typedef typename allocator_type::const_pointer const_pointer;
-			typedef ft::avl_tree_iterator<ft::TreeNode<value_type>, false> iterator;
-			typedef ft::avl_tree_iterator<const ft::TreeNode<value_type>, true> const_iterator;
+
+		private:
+			typedef char compare_must_suit_augment[ft::augment_accepts_compare<Augment, Compare>::value ? 1 : -1];
+			typedef AVLTree<value_type, value_compare, allocator_type, Augment> tree_type;
+			typedef typename tree_type::node_type node_type;
+
+		public:
+			typedef ft::map_node_handle<Key, T, node_type, typename tree_type::allocator_type> node_handle;
+			typedef ft::avl_tree_iterator<node_type, false> iterator;
+			typedef ft::avl_tree_iterator<const node_type, true> const_iterator;
 			typedef ft::reverse_iterator<iterator> reverse_iterator;
 			typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
 
 			typedef typename std::ptrdiff_t difference_type;
 			typedef std::size_t size_type;
 
+			//Result of the insertion of a node handle. If the key was already present, node owns the node again.
+			struct insert_return_type
+			{
+				iterator position;
+				bool inserted;
+				node_handle node;
+			};
+
 			///------------------///
 			/// MEMBER FUNCTIONS ///
 			///------------------///
 			
 			//Empty constructor
-			explicit map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()) : _comp(comp), _alloc(alloc), _tree(tree_type(value_compare(_comp), _alloc)) {}
+			explicit map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()) : _comp(comp), _alloc(alloc), _tree(value_compare(comp), alloc) {}
 
 			//Range constructor
 			//Constructs a container with as many elements as the range [first,last),
 			//with each element constructed from its corresponding element in that range.
 			template <class InputIterator>
 			map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
-				:_comp(comp), _alloc(alloc), _tree(tree_type(value_compare(_comp), _alloc))
+				:_comp(comp), _alloc(alloc), _tree(value_compare(comp), alloc)
 			{
 				insert(first, last); //insert range in maps's tree
 			}
@@ -73,9 +303,8 @@ namespace ft
 			//Copy constructor
 			//Constructs a container with a copy of each of the elements in x.
 			//The copy constructor creates a container that keeps and uses copies of x's allocator and comparison object.
-			map (const map& x) : _comp(x._comp), _alloc(x._alloc), _tree(tree_type(value_compare(_comp), _alloc))
+			map (const map& x) : _comp(x._comp), _alloc(x._alloc), _tree(value_compare(x._comp), x._alloc)
 			{
-				const_iterator beg = x.begin();
 				insert(x.begin(), x.end());
 			}
 
@@ -97,6 +326,27 @@ namespace ft
 				return *this;
 			}
 
+# if FT_MOVE_SEMANTICS
+			//Move constructor
+			//Takes the elements of x, which is left empty.
+			map (map&& x) : _comp(x._comp), _alloc(x._alloc), _tree(value_compare(x._comp), x._alloc)
+			{
+				swap(x);
+			}
+
+			//Move assignment operator
+			//Destroys the elements of the container and takes those of x, which is left empty.
+			map& operator= (map&& x)
+			{
+				if (&x != this)
+				{
+					clear();
+					swap(x);
+				}
+				return *this;
+			}
+# endif
+
 			//Returns an iterator referring to the first element in the map container.
 			iterator begin()
 			{
@@ -170,9 +420,17 @@ namespace ft
 			//If not, inserts a new element with that key and returns a reference to its mapped value
 			mapped_type& operator[] (const key_type& k)
 			{
-				return (*((insert(ft::make_pair(k, mapped_type()))).first)).second;
+				return find_or_insert(k, default_mapped()).first->second;
 			}
 
+# if FT_MOVE_SEMANTICS
+			//Same as above, moving k into the new element
+			mapped_type& operator[] (key_type&& k)
+			{
+				return try_emplace(std::move(k)).first->second;
+			}
+# endif
+
 			//Returns a reference to the mapped value of the element identified with key k.
 			//If k does not match the key of any element in the container, the function throws an out_of_range exception.
 			mapped_type& at (const key_type& k)
@@ -187,23 +445,96 @@ namespace ft
 			//If k does not match the key of any element in the container, the function throws an out_of_range exception.
 			const mapped_type& at (const key_type& k) const
 			{
-				iterator it_found = find(k);
-				if (*it_found == end())
+				const_iterator it_found = find(k);
+				if (it_found == end())
 					throw std::out_of_range("map::at");
 				return it_found->second;
 			}
 
 			//Return a pair, with its member pair::first set to an iterator pointing to either the newly inserted element or to the element with an equivalent key in the map.
 			//The pair::second element in the pair is set to true if a new element was inserted or false if an equivalent key already existed.
+			//The key is searched before allocating the node, so nothing is allocated when it is already present.
 			pair<iterator,bool> insert (const value_type& val)
+			{
+				node_type * parent;
+				bool left;
+				node_type * found = find_slot(val.first, &parent, &left);
+				if (found != NULL)
+					return ft::make_pair<iterator, bool>(iterator(found, _tree.dummy_past_end), false);
+				_tree.reserve_past_end();
+				return ft::make_pair<iterator, bool>(link(parent, left, _tree.create_node(val)), true);
+			}
+
+			//Returns the element of key k, after inserting it with factory() as mapped value if k was not present.
+			//k is searched once, and nothing is allocated nor constructed (factory is not called) when it is present.
+			template <class Factory>
+			pair<iterator,bool> find_or_insert (const key_type& k, Factory factory)
+			{
+				node_type * parent;
+				bool left;
+				node_type * found = find_slot(k, &parent, &left);
+				if (found != NULL)
+					return ft::make_pair<iterator, bool>(iterator(found, _tree.dummy_past_end), false);
+				_tree.reserve_past_end();
+# if FT_MOVE_SEMANTICS
+				return ft::make_pair<iterator, bool>(link(parent, left, _tree.emplace_node(k, factory())), true);
+# else
+				return ft::make_pair<iterator, bool>(link(parent, left, _tree.create_node(value_type(k, factory()))), true);
+# endif
+			}
+
+# if FT_MOVE_SEMANTICS
+			//Inserts val, moving it into the new element. Nothing is allocated nor moved if its key is already present.
+			pair<iterator,bool> insert (value_type&& val)
+			{
+				node_type * parent;
+				bool left;
+				node_type * found = find_slot(val.first, &parent, &left);
+				if (found != NULL)
+					return ft::make_pair<iterator, bool>(iterator(found, _tree.dummy_past_end), false);
+				_tree.reserve_past_end();
+				return ft::make_pair<iterator, bool>(link(parent, left, _tree.emplace_node(std::move(val))), true);
+			}
+
+			//Inserts an element constructed from args, which is destroyed if its key is already present
+			template <class... Args>
+			pair<iterator,bool> emplace (Args&&... args)
 			{
 				bool inserted;
-				typename ft::TreeNode<value_type> * inserted_or_found;
+				node_type * inserted_or_found;
 
-				_tree.create_and_insert(val, &inserted, &inserted_or_found);
+				_tree.insert_node(_tree.emplace_node(std::forward<Args>(args)...), &inserted, &inserted_or_found);
 				return ft::make_pair<iterator, bool>(iterator(inserted_or_found, _tree.dummy_past_end), inserted);
 			}
 
+			//Inserts an element of key k whose mapped value is constructed from args, unless k is already present.
+			//In the latter case, nothing is allocated and k and args are left untouched.
+			template <class... Args>
+			pair<iterator,bool> try_emplace (const key_type& k, Args&&... args)
+			{
+				return try_emplace_key(k, std::forward<Args>(args)...);
+			}
+
+			template <class... Args>
+			pair<iterator,bool> try_emplace (key_type&& k, Args&&... args)
+			{
+				return try_emplace_key(std::move(k), std::forward<Args>(args)...);
+			}
+
+			//Assigns obj to the mapped value of k, inserting k if needed
+			template <class M>
+			pair<iterator,bool> insert_or_assign (const key_type& k, M&& obj)
+			{
+				return insert_or_assign_key(k, std::forward<M>(obj));
+			}
+
+			template <class M>
+			pair<iterator,bool> insert_or_assign (key_type&& k, M&& obj)
+			{
+				return insert_or_assign_key(std::move(k), std::forward<M>(obj));
+			}
+# endif
+
 			//Insert val using position as an hint about where to insert it. Position might not be used.
 			iterator insert (iterator position, const value_type& val)
 			{
@@ -223,17 +554,18 @@ namespace ft
 			void erase (iterator position)
 			{
 				_tree.root = _tree.delete_node(_tree.root, *position);
-				_tree.dummy_past_end->left = _tree.max_value_node(_tree.root); //update dummy past-the-end
+				_tree.update_past_end();
 			}
 
 			//Removes the element of key k from the map
 			//Returns the number of elements erased
 			size_type erase (const key_type& k)
 			{
-				if (find(k) == end())
+				node_type * node_found = find_node(k);
+				if (node_found == NULL)
 					return 0;
-				_tree.root = _tree.delete_node(_tree.root, ft::make_pair(k, mapped_type()));
-				_tree.dummy_past_end->left = _tree.max_value_node(_tree.root); //update dummy past-the-end
+				_tree.root = _tree.delete_node(_tree.root, node_found->value);
+				_tree.update_past_end();
 				return 1;
 			}
 
@@ -244,6 +576,81 @@ namespace ft
 					
 			}
 
+			/// NODE HANDLES ///
+
+			//Unlinks the element at position from the map and returns the handle owning its node, which is not freed
+			node_handle extract (iterator position)
+			{
+				return node_handle(unlink(*position), typename tree_type::allocator_type(_alloc));
+			}
+
+			//Same for the element of key k. The handle is empty if k is not present.
+			node_handle extract (const key_type& k)
+			{
+				node_type * found = find_node(k);
+				if (found == NULL)
+					return node_handle();
+				return node_handle(unlink(found->value), typename tree_type::allocator_type(_alloc));
+			}
+
+			//Links the node owned by nh into the map if its key is not present, without copying nor allocating.
+			//Otherwise, the node is handed back in the node member of the result.
+			insert_return_type insert (node_handle nh)
+			{
+				insert_return_type result;
+				result.position = end();
+				result.inserted = false;
+				if (nh.empty())
+					return result;
+				node_type * node = nh._node;
+				Augment::init(node); //the key may have been changed through the handle
+				node_type * parent;
+				bool left;
+				node_type * found = find_slot(node->value.first, &parent, &left);
+				if (found != NULL)
+				{
+					result.position = iterator(found, _tree.dummy_past_end);
+					result.node = nh;
+					return result;
+				}
+				_tree.reserve_past_end();
+				nh.release();
+				result.position = link(parent, left, node);
+				result.inserted = true;
+				return result;
+			}
+
+			//Same, using position as an hint which might not be used. Returns the element of the key of the node.
+			iterator insert (iterator position, node_handle nh)
+			{
+				(void)position;
+				return insert(nh).position;
+			}
+
+			//Moves into the map the nodes of source whose key is not present, without copying nor allocating.
+			//The other nodes stay in source. The allocators of both maps must compare equal.
+			template <class Compare2>
+			void merge (map<Key, T, Compare2, Alloc, Augment>& source)
+			{
+				typedef typename map<Key, T, Compare2, Alloc, Augment>::iterator source_iterator;
+				source_iterator it = source.begin();
+				while (it != source.end())
+				{
+					source_iterator next = it;
+					++next;
+					node_type * parent;
+					bool left;
+					if (find_slot(it->first, &parent, &left) == NULL)
+					{
+						_tree.reserve_past_end();
+						node_type * node = source.unlink(*it);
+						Augment::init(node);
+						link(parent, left, node);
+					}
+					it = next;
+				}
+			}
+
 			//Exchanges the content of the container by the content of x, which is another map of the same type
 			void swap (map& x)
 			{
@@ -257,25 +664,33 @@ namespace ft
 			{
 				_tree.clear(_tree.root);
 				_tree.root = NULL;
-				_tree.dummy_past_end->left = NULL;
+				_tree.update_past_end();
+			}
+
+			//Relocates the elements into a single block of memory, in key order, and rebalances the tree perfectly,
+			//so that scans read memory sequentially after insertions and erasures scattered the nodes.
+			//Iterators, pointers and references to the elements are invalidated.
+			void compact()
+			{
+				_tree.compact();
 			}
 
 			//Returns a copy of the comparison object used by the container to compare keys.
 			key_compare key_comp() const
 			{ 
-				return key_compare(); 
+				return _comp; 
 			}
 
 			//Returns a comparison object that can be used to compare two elements to get whether the key of the first one goes before the second.
 			value_compare value_comp() const
 			{ 
-				return value_compare(key_compare()); 
+				return value_compare(_comp); 
 			}
 
 			//Searches the container for an element with a key equivalent to k and returns an iterator to it if found, otherwise it returns an iterator to map::end.
 			iterator find (const key_type& k)
 			{
-				typename ft::TreeNode<value_type> * node_found = _tree.iterative_search(ft::make_pair(k, mapped_type()));
+				node_type * node_found = find_node(k);
 				if (node_found == NULL)
 					return iterator(end());
 				return iterator(node_found, _tree.dummy_past_end);
@@ -284,7 +699,7 @@ namespace ft
 			//Searches the container for an element with a key equivalent to k and returns a const iterator to it if found, otherwise it returns a const iterator to map::end.
 			const_iterator find (const key_type& k) const
 			{
-				typename ft::TreeNode<value_type> * node_found = _tree.iterative_search(ft::make_pair(k, mapped_type()));
+				node_type * node_found = find_node(k);
 				if (node_found == NULL)
 					return const_iterator(end());
 				return const_iterator(node_found, _tree.dummy_past_end);
@@ -303,61 +718,37 @@ namespace ft
 			//Returns an iterator pointing to the first element in the container whose key is not considered to go before k
 			iterator lower_bound (const key_type& k)
 			{
-				iterator begin = this->begin();
-				iterator end = this->end();
-
-				while (begin != end)
-				{
-					if (!_comp((*begin).first, k))
-						return (begin);
-					begin++;
-				}
-				return end; //if all keys are considered to go before k.
+				node_type * node = bound_node(k, false);
+				if (node == NULL)
+					return end(); //if all keys are considered to go before k.
+				return iterator(node, _tree.dummy_past_end);
 			}
 
 			//Returns a const iterator pointing to the first element in the container whose key is not considered to go before k
 			const_iterator lower_bound (const key_type& k) const
 			{
-				const_iterator begin = this->begin();
-				const_iterator end = this->end();
-
-				while (begin != end)
-				{
-					if (!_comp((*begin).first, k))
-						return (begin);
-					begin++;
-				}
-				return end; //if all keys are considered to go before k.
+				node_type * node = bound_node(k, false);
+				if (node == NULL)
+					return end(); //if all keys are considered to go before k.
+				return const_iterator(node, _tree.dummy_past_end);
 			}
 
 			//Returns an iterator pointing to the first element in the container whose key is considered to go after k.
 			iterator upper_bound (const key_type& k)
 			{
-				iterator begin = this->begin();
-				iterator end = this->end();
-
-				while (begin != end)
-				{
-					if (_comp(k, (*begin).first))
-						return (begin);
-					begin++;
-				}
-				return end; //if all keys are considered to go after k.
+				node_type * node = bound_node(k, true);
+				if (node == NULL)
+					return end(); //if no key is considered to go after k.
+				return iterator(node, _tree.dummy_past_end);
 			}
 
 			//Returns a const iterator pointing to the first element in the container whose key is considered to go after k.
 			const_iterator upper_bound (const key_type& k) const
 			{
-				const_iterator begin = this->begin();
-				const_iterator end = this->end();
-
-				while (begin != end)
-				{
-					if (_comp(k, (*begin).first))
-						return (begin);
-					begin++;
-				}
-				return end; //if all keys are considered to go after k.
+				node_type * node = bound_node(k, true);
+				if (node == NULL)
+					return end(); //if no key is considered to go after k.
+				return const_iterator(node, _tree.dummy_past_end);
 			}
 
 			
@@ -374,17 +765,277 @@ namespace ft
 				return ft::make_pair(lower_bound(k), upper_bound(k));
 			}
 			
+			//Applies f to every element in key order and returns f, as ft::for_each(begin(), end(), f) would.
+			//The tree is walked with a stack instead of the parent links, and the next subtree is prefetched while f runs.
+			//f must not insert or erase elements of the map.
+			template <class Function>
+			Function for_each (Function f)
+			{
+				return walk<node_type>(_tree.root, NULL, NULL, f);
+			}
+
+			template <class Function>
+			Function for_each (Function f) const
+			{
+				return walk<const node_type>(_tree.root, NULL, NULL, f);
+			}
+
+			//Applies f to the elements whose key is between lo and hi included, in key order, and returns f.
+			template <class Function>
+			Function for_each_range (const key_type& lo, const key_type& hi, Function f)
+			{
+				return walk<node_type>(_tree.root, &lo, &hi, f);
+			}
+
+			template <class Function>
+			Function for_each_range (const key_type& lo, const key_type& hi, Function f) const
+			{
+				return walk<const node_type>(_tree.root, &lo, &hi, f);
+			}
+
 			//Returns a copy of the allocator object associated with the map.
 			allocator_type get_allocator() const
 			{
 				return allocator_type(_alloc);
 			}
+
+			/// AGGREGATES ///
+			//Only available when the map is augmented with an aggregate policy (sum_aggregate, min_aggregate, ...)
+			//Insertions and erasures keep the aggregates up to date, but a mapped value modified in place
+			//(through operator[], at or an iterator) must be followed by a call to refresh_aggregate.
+
+			//Recomputes the aggregates depending on the element at position, in O(log(n)) : the node of position and
+			//its ancestors are updated, without searching its key
+			void refresh_aggregate(iterator position)
+			{
+				node_type * node = static_cast<node_type *>(position.base());
+				_tree.update_height(node);
+				_tree.update_predecessors_height(node);
+			}
+
+			//Returns the aggregate of the mapped values of all the elements, in O(1)
+			typename Augment::data_type aggregate() const
+			{
+				if (_tree.root == NULL)
+					return Augment::identity();
+				return _tree.root->aug;
+			}
+
+			//Returns the aggregate of the mapped values of the elements whose key is in [lo, hi], in O(log(n)).
+			//It is the same as combining the elements from lower_bound(lo) to upper_bound(hi), in key order.
+			typename Augment::data_type aggregate(const key_type& lo, const key_type& hi) const
+			{
+				node_type * r = _tree.root;
+
+				//Go down until the node where the paths to lo and hi split
+				while (r != NULL)
+				{
+					if (_comp(r->value.first, lo))
+						r = r->right;
+					else if (_comp(hi, r->value.first))
+						r = r->left;
+					else
+						break;
+				}
+				if (r == NULL)
+					return Augment::identity();
+
+				//Below the split node, the left path gathers the keys >= lo, the right path the keys <= hi
+				typename Augment::data_type left = Augment::identity();
+				for (node_type * n = r->left; n != NULL; )
+				{
+					if (_comp(n->value.first, lo))
+						n = n->right;
+					else
+					{
+						typename Augment::data_type part = Augment::lift(n->value.second);
+						if (n->right)
+							part = Augment::combine(part, n->right->aug);
+						left = Augment::combine(part, left);
+						n = n->left;
+					}
+				}
+				typename Augment::data_type right = Augment::identity();
+				for (node_type * n = r->right; n != NULL; )
+				{
+					if (_comp(hi, n->value.first))
+						n = n->left;
+					else
+					{
+						typename Augment::data_type part = Augment::lift(n->value.second);
+						if (n->left)
+							part = Augment::combine(n->left->aug, part);
+						right = Augment::combine(right, part);
+						n = n->right;
+					}
+				}
+				return Augment::combine(Augment::combine(left, Augment::lift(r->value.second)), right);
+			}
+
 		private:
+			template <class Map, bool is_const>
+			friend class map_subtrees; //splits the tree for the parallel algorithms (see parallel.hpp)
+			template <class Map>
+			friend class map_builder; //builds the tree from sorted values (see parallel.hpp)
+			template <class, class, class, class, class>
+			friend class map; //merge takes the nodes of maps with other comparators
+
 			key_compare _comp;
 			allocator_type _alloc;
-			typedef AVLTree<value_type, value_compare, allocator_type> tree_type;
 			tree_type _tree;
 
+			//Searches the node of key k by comparing keys directly, without building a value_type around k
+			node_type * find_node(const key_type& k) const
+			{
+				typename Augment::cache_type cache = Augment::key_cache(k);
+				node_type * r = _tree.root;
+				while (r != NULL)
+				{
+					int c = Augment::compare_cached(cache, r);
+					if (c == 0)
+						c = key_three_way<key_type, key_compare>::compare(_comp, k, r->value.first);
+					if (c == 0)
+						return r;
+					r = (c < 0) ? r->left : r->right;
+				}
+				return NULL;
+			}
+
+			//Node of key k, or NULL if there is none. In the latter case, a node of key k is to be linked
+			//as the left (*left is true) or right child of *parent, or as the root if *parent is NULL.
+			node_type * find_slot(const key_type& k, node_type ** parent, bool * left) const
+			{
+				typename Augment::cache_type cache = Augment::key_cache(k);
+				node_type * r = _tree.root;
+				*parent = NULL;
+				*left = false;
+				while (r != NULL)
+				{
+					int c = Augment::compare_cached(cache, r);
+					if (c == 0)
+						c = key_three_way<key_type, key_compare>::compare(_comp, k, r->value.first);
+					if (c == 0)
+						return r;
+					*parent = r;
+					*left = c < 0;
+					r = *left ? r->left : r->right;
+				}
+				return NULL;
+			}
+
+			//Unlinks the node of value v from the tree and returns it (see AVLTree::unlink_node)
+			node_type * unlink(const value_type& v)
+			{
+				node_type * node;
+				_tree.root = _tree.unlink_node(_tree.root, v, &node);
+				_tree.update_past_end();
+				return node;
+			}
+
+			//Links new_node at the position found by find_slot and returns its iterator. The past-the-end sentinel must
+			//have been allocated before new_node was created (see AVLTree::reserve_past_end).
+			iterator link(node_type * parent, bool left, node_type * new_node)
+			{
+				_tree.link_node(parent, left, new_node);
+				return iterator(new_node, _tree.dummy_past_end);
+			}
+
+			//Factory of find_or_insert making value-initialized mapped values, for operator[]
+			struct default_mapped
+			{
+				mapped_type operator()() const
+				{
+					return mapped_type();
+				}
+			};
+
+# if FT_MOVE_SEMANTICS
+			template <class K, class... Args>
+			pair<iterator,bool> try_emplace_key (K&& k, Args&&... args)
+			{
+				node_type * parent;
+				bool left;
+				node_type * found = find_slot(k, &parent, &left);
+				if (found != NULL)
+					return ft::make_pair<iterator, bool>(iterator(found, _tree.dummy_past_end), false);
+				_tree.reserve_past_end();
+				return ft::make_pair<iterator, bool>(link(parent, left, _tree.emplace_node(std::forward<K>(k), mapped_type(std::forward<Args>(args)...))), true);
+			}
+
+			template <class K, class M>
+			pair<iterator,bool> insert_or_assign_key (K&& k, M&& obj)
+			{
+				node_type * parent;
+				bool left;
+				node_type * found = find_slot(k, &parent, &left);
+				if (found != NULL)
+				{
+					found->value.second = std::forward<M>(obj);
+					return ft::make_pair<iterator, bool>(iterator(found, _tree.dummy_past_end), false);
+				}
+				_tree.reserve_past_end();
+				return ft::make_pair<iterator, bool>(link(parent, left, _tree.emplace_node(std::forward<K>(k), std::forward<M>(obj))), true);
+			}
+# endif
+
+			//First node whose key is not less than k (greater than k if strict), NULL if there is none
+			node_type * bound_node(const key_type& k, bool strict) const
+			{
+				typename Augment::cache_type cache = Augment::key_cache(k);
+				node_type * r = _tree.root;
+				node_type * bound = NULL;
+				while (r != NULL)
+				{
+					int c = Augment::compare_cached(cache, r);
+					if (c == 0)
+						c = key_three_way<key_type, key_compare>::compare(_comp, k, r->value.first);
+					if (c == 0 && !strict)
+						return r;
+					if (c < 0)
+					{
+						bound = r;
+						r = r->left;
+					}
+					else
+						r = r->right;
+				}
+				return bound;
+			}
+
+			//Higher than any AVL tree that fits in memory : a tree of height h holds at least fib(h + 2) - 1 nodes
+			static const int max_height = 96;
+
+			//In-order walk of the subtree r applying f to the values whose key is in [*lo, *hi], a NULL bound being unlimited
+			template <class Node, class Function>
+			Function walk (Node * r, const key_type * lo, const key_type * hi, Function f) const
+			{
+				Node * stack[max_height];
+				int top = 0;
+				while (true)
+				{
+					//stack the path to the smallest key of the subtree which is not below lo
+					while (r != NULL)
+					{
+						if (lo != NULL && _comp(r->value.first, *lo))
+							r = r->right;
+						else
+						{
+							stack[top++] = r;
+							r = r->left;
+						}
+					}
+					if (top == 0)
+						return f;
+					Node * n = stack[--top];
+					if (hi != NULL && _comp(*hi, n->value.first))
+						return f;
+					lo = NULL; //every key left to visit is greater than this one
+					r = n->right;
+					if (r != NULL)
+						ft::prefetch(r);
+					f(n->value);
+				}
+			}
 	};
 
 	///-------------------------------///
@@ -393,8 +1044,8 @@ namespace ft
 
 	/// RELATIONAL OPERATORS ///
 
-	template<class Key, class T, class Compare, class Alloc>
-	bool operator==(const map<Key, T, Compare, Alloc> & lhs, const map<Key, T, Compare, Alloc> & rhs)
+	template<class Key, class T, class Compare, class Alloc, class Augment>
+	bool operator==(const map<Key, T, Compare, Alloc, Augment> & lhs, const map<Key, T, Compare, Alloc, Augment> & rhs)
 	{
 		if (lhs.size() != rhs.size())
 			return false;
@@ -402,39 +1053,39 @@ namespace ft
 		return ft::equal(lhs.begin(), lhs.end(), rhs.begin());
 	}
 
-	template<class Key, class T, class Compare, class Alloc>
-	bool operator!=(const map<Key, T, Compare, Alloc> & lhs, const map<Key, T, Compare, Alloc> & rhs)
+	template<class Key, class T, class Compare, class Alloc, class Augment>
+	bool operator!=(const map<Key, T, Compare, Alloc, Augment> & lhs, const map<Key, T, Compare, Alloc, Augment> & rhs)
 	{
 			return !(lhs == rhs); 
 	}
 
-	template<class Key, class T, class Compare, class Alloc>
-	bool operator<(const map<Key, T, Compare, Alloc> & lhs, const map<Key, T, Compare, Alloc> & rhs)
+	template<class Key, class T, class Compare, class Alloc, class Augment>
+	bool operator<(const map<Key, T, Compare, Alloc, Augment> & lhs, const map<Key, T, Compare, Alloc, Augment> & rhs)
 	{
 			return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 	}
 
-	template<class Key, class T, class Compare, class Alloc>
-	bool operator>(const map<Key, T, Compare, Alloc> & lhs, const map<Key, T, Compare, Alloc> & rhs)
+	template<class Key, class T, class Compare, class Alloc, class Augment>
+	bool operator>(const map<Key, T, Compare, Alloc, Augment> & lhs, const map<Key, T, Compare, Alloc, Augment> & rhs)
 	{
 			return rhs < lhs;
 	}
 
-	template<class Key, class T, class Compare, class Alloc>
-	bool operator<=(const map<Key, T, Compare, Alloc> & lhs, const map<Key, T, Compare, Alloc> & rhs)
+	template<class Key, class T, class Compare, class Alloc, class Augment>
+	bool operator<=(const map<Key, T, Compare, Alloc, Augment> & lhs, const map<Key, T, Compare, Alloc, Augment> & rhs)
 	{
 			return !(lhs > rhs);
 	}
 
-	template<class Key, class T, class Compare, class Alloc>
-	bool operator>=(const map<Key, T, Compare, Alloc> & lhs, const map<Key, T, Compare, Alloc> & rhs)
+	template<class Key, class T, class Compare, class Alloc, class Augment>
+	bool operator>=(const map<Key, T, Compare, Alloc, Augment> & lhs, const map<Key, T, Compare, Alloc, Augment> & rhs)
 	{
 			return !(lhs < rhs);
 	}
 
 	//The contents of container x are exchanged with those of y.
-	template<class Key, class T, class Compare, class Alloc>
-	void swap(const map<Key, T, Compare, Alloc>& lhs, const map<Key, T, Compare, Alloc>& rhs)
+	template<class Key, class T, class Compare, class Alloc, class Augment>
+	void swap(map<Key, T, Compare, Alloc, Augment>& lhs, map<Key, T, Compare, Alloc, Augment>& rhs)
 	{
 		lhs.swap(rhs);
 	}
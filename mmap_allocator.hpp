@@ -0,0 +1,236 @@
+#ifndef MMAP_ALLOCATOR_HPP
+# define MMAP_ALLOCATOR_HPP
+
+# include <cstddef>
+# include <cstdlib>
+# include <cstring>
+# include <new>
+# include "vector.hpp"
+
+//On Linux, the large blocks are mapped with mmap and grown with mremap, and the size malloc really gave to the
+//others is read with malloc_usable_size. Elsewhere, all blocks come from malloc and grow with realloc.
+# if defined(__linux__)
+#  define FT_MMAP 1
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  include <malloc.h>
+# else
+#  define FT_MMAP 0
+# endif
+
+namespace ft
+{
+	//Allocator for vectors which grow large. Blocks of mmap_threshold bytes or more are mapped pages : growing one
+	//remaps its pages to a larger range of addresses, without copying them nor needing the old and the new block at
+	//once. The smaller blocks come from malloc and grow with realloc, and a vector uses the whole block malloc gave
+	//(its size class), not only the bytes it asked for.
+	//ft::vector grows in place only when its elements are relocatable (ft::is_trivially_relocatable), and otherwise
+	//allocates a new block as with any allocator. Blocks must be deallocated with the size they were allocated with.
+	template <class T>
+	class mmap_allocator
+	{
+		public:
+			typedef T value_type;
+			typedef T * pointer;
+			typedef const T * const_pointer;
+			typedef T & reference;
+			typedef const T & const_reference;
+			typedef std::size_t size_type;
+			typedef std::ptrdiff_t difference_type;
+
+			template <class U>
+			struct rebind
+			{
+				typedef mmap_allocator<U> other;
+			};
+
+			//Size from which blocks are mapped
+			static const std::size_t mmap_threshold = 1 << 20;
+
+			mmap_allocator() {}
+
+			template <class U>
+			mmap_allocator(const mmap_allocator<U>&) {}
+
+			pointer address(reference x) const
+			{
+				return &x;
+			}
+
+			const_pointer address(const_reference x) const
+			{
+				return &x;
+			}
+
+			size_type max_size() const
+			{
+				return static_cast<size_type>(-1) / sizeof(T) / 2;
+			}
+
+			pointer allocate(size_type n, const void * = 0)
+			{
+				return static_cast<pointer>(allocate_bytes(bytes_for(n)));
+			}
+
+			void deallocate(pointer p, size_type n)
+			{
+				std::size_t bytes = n * sizeof(T);
+# if FT_MMAP
+				if (bytes >= mmap_threshold)
+				{
+					munmap(static_cast<void *>(p), page_round(bytes));
+					return;
+				}
+# else
+				(void)bytes;
+# endif
+				std::free(static_cast<void *>(p));
+			}
+
+			void construct(pointer p, const_reference val)
+			{
+				new (static_cast<void *>(p)) T(val);
+			}
+
+			void destroy(pointer p)
+			{
+				p->~T();
+			}
+
+			//Allocates a block of at least n elements, and sets n to the number of elements it holds
+			pointer allocate_at_least(size_type& n)
+			{
+				std::size_t bytes = bytes_for(n);
+				void * p = allocate_bytes(bytes);
+				n = usable(p, bytes) / sizeof(T);
+				return static_cast<pointer>(p);
+			}
+
+			//Grows the block p of capacity elements to at least n elements, keeping its bytes, and sets n to the number
+			//of elements it holds
+			pointer reallocate(pointer p, size_type capacity, size_type& n)
+			{
+				std::size_t old_bytes = capacity * sizeof(T);
+				std::size_t bytes = bytes_for(n);
+				void * block;
+# if FT_MMAP
+				if (old_bytes >= mmap_threshold)
+				{
+					block = mremap(static_cast<void *>(p), page_round(old_bytes), page_round(bytes), MREMAP_MAYMOVE);
+					if (block == MAP_FAILED)
+						throw std::bad_alloc();
+				}
+				else if (bytes >= mmap_threshold)
+				{
+					block = allocate_bytes(bytes);
+					std::memcpy(block, static_cast<void *>(p), old_bytes);
+					std::free(static_cast<void *>(p));
+				}
+				else
+# endif
+				{
+					block = std::realloc(static_cast<void *>(p), bytes);
+					if (block == 0)
+						throw std::bad_alloc();
+				}
+				n = usable(block, bytes) / sizeof(T);
+				return static_cast<pointer>(block);
+			}
+
+		private:
+			static std::size_t bytes_for(size_type n)
+			{
+				if (n > static_cast<size_type>(-1) / sizeof(T) / 2)
+					throw std::bad_alloc();
+				return n != 0 ? n * sizeof(T) : 1;
+			}
+
+			static void * allocate_bytes(std::size_t bytes)
+			{
+				void * p;
+# if FT_MMAP
+				if (bytes >= mmap_threshold)
+				{
+					p = mmap(0, page_round(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+					if (p == MAP_FAILED)
+						throw std::bad_alloc();
+					return p;
+				}
+# endif
+				p = std::malloc(bytes);
+				if (p == 0)
+					throw std::bad_alloc();
+				return p;
+			}
+
+			//Bytes usable in the block p allocated for bytes : the whole pages of a mapping, and the size class of a malloc
+			//block, kept below the threshold so that deallocate frees it as it was allocated
+			static std::size_t usable(void *& p, std::size_t bytes)
+			{
+# if FT_MMAP
+				if (bytes >= mmap_threshold)
+					return page_round(bytes);
+				std::size_t size = malloc_usable_size(p);
+				if (size >= mmap_threshold)
+					size = mmap_threshold - 1;
+				if (size / sizeof(T) == bytes / sizeof(T))
+					return bytes;
+				void * resized = std::realloc(p, size); //in place, so that the block formally has the size which is used
+				if (resized == 0)
+					return bytes;
+				p = resized;
+				return size;
+# else
+				(void)p;
+				return bytes;
+# endif
+			}
+
+# if FT_MMAP
+			static std::size_t page_round(std::size_t bytes)
+			{
+				static const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+				return (bytes + page - 1) & ~(page - 1);
+			}
+# endif
+	};
+
+	template <class T>
+	const std::size_t mmap_allocator<T>::mmap_threshold;
+
+	template <class T, class U>
+	bool operator== (const mmap_allocator<T>&, const mmap_allocator<U>&)
+	{
+		return true;
+	}
+
+	template <class T, class U>
+	bool operator!= (const mmap_allocator<T>&, const mmap_allocator<U>&)
+	{
+		return false;
+	}
+
+	//Lets the vectors use the whole blocks and grow them in place
+	template <class T>
+	struct allocation_traits< mmap_allocator<T> >
+	{
+		typedef T * pointer;
+
+		static const bool can_reallocate = true;
+
+		static pointer allocate_at_least(mmap_allocator<T>& alloc, std::size_t& n)
+		{
+			return alloc.allocate_at_least(n);
+		}
+
+		static pointer reallocate(mmap_allocator<T>& alloc, pointer p, std::size_t capacity, std::size_t& n)
+		{
+			return alloc.reallocate(p, capacity, n);
+		}
+	};
+
+	template <class T>
+	const bool allocation_traits< mmap_allocator<T> >::can_reallocate;
+}
+
+#endif
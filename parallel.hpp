@@ -0,0 +1,635 @@
+#ifndef PARALLEL_HPP
+# define PARALLEL_HPP
+
+# include <pthread.h>
+# include <unistd.h>
+# include <algorithm>
+# include <cstring>
+# include <exception>
+# include <new>
+# include <stdexcept>
+# include "map.hpp"
+# include "vector.hpp"
+
+namespace ft
+{
+	///----------------///
+	/// WORKER THREADS ///
+	///----------------///
+
+	//Number of threads used by the parallel algorithms when none is given : the number of online processors
+	inline unsigned int hardware_threads()
+	{
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		return n > 0 ? static_cast<unsigned int>(n) : 1;
+	}
+
+	//Pieces [0, count) of a job handed out one at a time, so that the threads finishing early take more of them.
+	//The first exception thrown by a piece on a worker thread is kept for the calling thread, and no piece is handed out after it.
+	template <class Job>
+	struct parallel_worker
+	{
+		enum failure_kind
+		{
+			no_failure,
+			bad_alloc_failure,
+			exception_failure, //what holds the message
+			unknown_failure
+		};
+
+		Job * job;
+		std::size_t count;
+		std::size_t next;
+		pthread_mutex_t lock;
+		failure_kind failure;
+		char what[256];
+# if FT_MOVE_SEMANTICS
+		std::exception_ptr error;
+# endif
+
+		//Runs pieces until there are none left
+		static void work(parallel_worker * w)
+		{
+			while (true)
+			{
+				pthread_mutex_lock(&w->lock);
+				std::size_t i = w->next++;
+				pthread_mutex_unlock(&w->lock);
+				if (i >= w->count)
+					return;
+				w->job->run(i);
+			}
+		}
+
+		//Start routine of the worker threads
+		static void * run(void * arg)
+		{
+			parallel_worker * w = static_cast<parallel_worker *>(arg);
+			try
+			{
+				work(w);
+			}
+			catch (std::bad_alloc&)
+			{
+				w->fail(bad_alloc_failure, NULL);
+			}
+			catch (std::exception& e)
+			{
+				w->fail(exception_failure, e.what());
+			}
+			catch (...)
+			{
+				w->fail(unknown_failure, NULL);
+			}
+			return NULL;
+		}
+
+		//Stops handing out pieces, and keeps the first failure. Called from a catch block.
+		void fail(failure_kind kind, const char * message)
+		{
+			pthread_mutex_lock(&lock);
+			next = count;
+			if (failure == no_failure)
+			{
+				failure = kind;
+				if (message != NULL)
+				{
+					std::strncpy(what, message, sizeof(what) - 1);
+					what[sizeof(what) - 1] = '\0';
+				}
+# if FT_MOVE_SEMANTICS
+				error = std::current_exception();
+# endif
+			}
+			pthread_mutex_unlock(&lock);
+		}
+
+		//Throws the failure of a worker thread on the calling thread. Before C++11, an exception cannot be moved
+		//to another thread : it is thrown again as std::bad_alloc, or as a std::runtime_error with its message.
+		void rethrow() const
+		{
+# if FT_MOVE_SEMANTICS
+			std::rethrow_exception(error);
+# else
+			if (failure == bad_alloc_failure)
+				throw std::bad_alloc();
+			if (failure == exception_failure)
+				throw std::runtime_error(what);
+			throw std::runtime_error("ft::parallel_run: unknown exception in a worker thread");
+# endif
+		}
+	};
+
+	//Calls job.run(i) for each i in [0, count) on up to `threads` threads, the calling thread included.
+	//If a thread cannot be created, the threads already running do its share.
+	//If a piece throws, the pieces not started yet are skipped, and the exception is thrown again on the calling
+	//thread once all the threads stopped (see parallel_worker::rethrow).
+	template <class Job>
+	void parallel_run(Job& job, std::size_t count, unsigned int threads)
+	{
+		parallel_worker<Job> w;
+		w.job = &job;
+		w.count = count;
+		w.next = 0;
+		w.failure = parallel_worker<Job>::no_failure;
+		w.what[0] = '\0';
+		ft::vector<pthread_t> ids;
+		ids.reserve(std::min<std::size_t>(threads, count)); //so that no thread is left unjoined by a failed push_back
+		pthread_mutex_init(&w.lock, NULL);
+
+		try
+		{
+			for (unsigned int t = 1; t < threads && t < count; t++)
+			{
+				pthread_t id;
+				if (pthread_create(&id, NULL, &parallel_worker<Job>::run, &w) != 0)
+					break;
+				ids.push_back(id);
+			}
+			parallel_worker<Job>::work(&w);
+		}
+		catch (...)
+		{
+			pthread_mutex_lock(&w.lock);
+			w.next = count;
+			pthread_mutex_unlock(&w.lock);
+			for (std::size_t t = 0; t < ids.size(); t++)
+				pthread_join(ids[t], NULL);
+			pthread_mutex_destroy(&w.lock);
+			throw;
+		}
+		for (std::size_t t = 0; t < ids.size(); t++)
+			pthread_join(ids[t], NULL);
+		pthread_mutex_destroy(&w.lock);
+		if (w.failure != parallel_worker<Job>::no_failure)
+			w.rethrow();
+	}
+
+	///--------------///
+	/// MAP SUBTREES ///
+	///--------------///
+
+	//Cuts the tree of a map into disjoint pieces, in key order : the subtrees whose height is at most a cut height,
+	//and the single nodes above them. The cut height is chosen from the height of the root so that there are
+	//at least min_pieces subtrees when the map is large enough, and an AVL tree keeps their sizes close.
+	template <class Map, bool is_const>
+	class map_subtrees
+	{
+		public:
+			typedef typename choose<is_const, const Map, Map>::type map_type;
+			typedef typename choose<is_const, const typename Map::node_type, typename Map::node_type>::type node_type;
+
+			map_subtrees(map_type& m, std::size_t min_pieces) : _map(m)
+			{
+				node_type * root = m._tree.root;
+				if (root == NULL)
+					return;
+				int levels = 0;
+				while ((static_cast<std::size_t>(1) << levels) < min_pieces && levels < root->height)
+					levels++;
+				cut(root, root->height - levels);
+			}
+
+			std::size_t size() const
+			{
+				return _pieces.size();
+			}
+
+			//Applies f to the elements of piece i in key order and returns f
+			template <class Function>
+			Function apply(std::size_t i, Function f) const
+			{
+				const piece& p = _pieces[i];
+				if (!p.whole)
+				{
+					f(p.node->value);
+					return f;
+				}
+				return _map.template walk<node_type>(p.node, NULL, NULL, f);
+			}
+
+		private:
+			struct piece
+			{
+				node_type * node;
+				bool whole; //the subtree of node, or node alone
+			};
+
+			map_type& _map;
+			ft::vector<piece> _pieces;
+
+			void cut(node_type * r, int height)
+			{
+				if (r == NULL)
+					return;
+				piece p;
+				p.node = r;
+				p.whole = (r->height <= height);
+				if (p.whole)
+				{
+					_pieces.push_back(p);
+					return;
+				}
+				cut(r->left, height);
+				_pieces.push_back(p);
+				cut(r->right, height);
+			}
+	};
+
+	template <class Subtrees, class Function>
+	struct parallel_for_each_job
+	{
+		const Subtrees * subtrees;
+		Function f;
+
+		parallel_for_each_job(const Subtrees& s, Function fn) : subtrees(&s), f(fn) {}
+
+		void run(std::size_t i)
+		{
+			subtrees->apply(i, f);
+		}
+	};
+
+	//Folds op over the elements of a piece
+	template <class T, class BinaryOperation>
+	struct reduce_step
+	{
+		T result;
+		BinaryOperation op;
+
+		reduce_step(const T& init, BinaryOperation o) : result(init), op(o) {}
+
+		template <class V>
+		void operator()(V& v)
+		{
+			result = op(result, v);
+		}
+	};
+
+	template <class Subtrees, class T, class BinaryOperation>
+	struct parallel_reduce_job
+	{
+		const Subtrees * subtrees;
+		T init;
+		BinaryOperation op;
+		ft::vector<T> results; //one per piece
+
+		parallel_reduce_job(const Subtrees& s, const T& i, BinaryOperation o) : subtrees(&s), init(i), op(o), results(s.size(), i) {}
+
+		void run(std::size_t i)
+		{
+			results[i] = subtrees->apply(i, reduce_step<T, BinaryOperation>(init, op)).result;
+		}
+	};
+
+	template <class Subtrees, class Function>
+	void parallel_for_each_pieces(const Subtrees& subtrees, Function f, unsigned int threads)
+	{
+		parallel_for_each_job<Subtrees, Function> job(subtrees, f);
+		parallel_run(job, subtrees.size(), threads);
+	}
+
+	template <class Subtrees, class T, class BinaryOperation, class Combine>
+	T parallel_reduce_pieces(const Subtrees& subtrees, const T& init, BinaryOperation op, Combine combine, unsigned int threads)
+	{
+		parallel_reduce_job<Subtrees, T, BinaryOperation> job(subtrees, init, op);
+		parallel_run(job, subtrees.size(), threads);
+		if (job.results.empty())
+			return init;
+		T result = job.results[0];
+		for (std::size_t i = 1; i < job.results.size(); i++)
+			result = combine(result, job.results[i]);
+		return result;
+	}
+
+	///---------------------///
+	/// PARALLEL ALGORITHMS ///
+	///---------------------///
+
+	//Pieces per thread : threads finishing their pieces early take the remaining ones
+	static const std::size_t parallel_pieces_per_thread = 8;
+
+	//Applies f to every element of m on `threads` threads (all the processors if 0).
+	//The map is cut into subtrees, and each subtree is walked in key order by a single thread with its own copy of f.
+	//f must be safe to run concurrently on different elements, and must not insert or erase elements. If f throws,
+	//the subtrees not started yet are skipped and the exception is thrown again by the calling thread (see parallel_run).
+	template <class Key, class T, class Compare, class Alloc, class Augment, class Function>
+	void parallel_for_each(map<Key, T, Compare, Alloc, Augment>& m, Function f, unsigned int threads = 0)
+	{
+		typedef map<Key, T, Compare, Alloc, Augment> map_type;
+		if (threads == 0)
+			threads = hardware_threads();
+		map_subtrees<map_type, false> subtrees(m, threads * parallel_pieces_per_thread);
+		parallel_for_each_pieces(subtrees, f, threads);
+	}
+
+	template <class Key, class T, class Compare, class Alloc, class Augment, class Function>
+	void parallel_for_each(const map<Key, T, Compare, Alloc, Augment>& m, Function f, unsigned int threads = 0)
+	{
+		typedef map<Key, T, Compare, Alloc, Augment> map_type;
+		if (threads == 0)
+			threads = hardware_threads();
+		map_subtrees<map_type, true> subtrees(m, threads * parallel_pieces_per_thread);
+		parallel_for_each_pieces(subtrees, f, threads);
+	}
+
+	//Reduces the elements of m with result = op(result, element) on `threads` threads (all the processors if 0).
+	//Each subtree is folded in key order starting from init, then the results of the subtrees are folded in key order
+	//with combine(result, subtree_result). init must therefore be an identity of combine (0 for a sum), and combine
+	//must be associative. If op or combine throws, the exception is thrown again by the calling thread (see parallel_run).
+	template <class Key, class T, class Compare, class Alloc, class Augment, class Result, class BinaryOperation, class Combine>
+	Result parallel_reduce(const map<Key, T, Compare, Alloc, Augment>& m, Result init, BinaryOperation op, Combine combine, unsigned int threads = 0)
+	{
+		typedef map<Key, T, Compare, Alloc, Augment> map_type;
+		if (threads == 0)
+			threads = hardware_threads();
+		map_subtrees<map_type, true> subtrees(m, threads * parallel_pieces_per_thread);
+		return parallel_reduce_pieces(subtrees, init, op, combine, threads);
+	}
+
+	//Same, with op also combining the results of the subtrees : op(result, element) and op(result, result) must both be valid.
+	template <class Key, class T, class Compare, class Alloc, class Augment, class Result, class BinaryOperation>
+	Result parallel_reduce(const map<Key, T, Compare, Alloc, Augment>& m, Result init, BinaryOperation op)
+	{
+		return parallel_reduce(m, init, op, op);
+	}
+
+	///-----------------------///
+	/// PARALLEL CONSTRUCTION ///
+	///-----------------------///
+
+	//Which element build_map_parallel keeps among elements of equal keys : the first one in input order,
+	//as map::insert would, or the last one, as assignments through map::operator[] would
+	enum duplicate_policy
+	{
+		keep_first,
+		keep_last
+	};
+
+	//Orders elements by their key only
+	template <class Value, class Compare>
+	struct key_order
+	{
+		Compare comp;
+
+		key_order(const Compare& c) : comp(c) {}
+
+		bool operator()(const Value& x, const Value& y) const
+		{
+			return comp(x.first, y.first);
+		}
+	};
+
+	//Stable sort of each chunk [bounds[i], bounds[i + 1]) of an array
+	template <class Value, class Compare>
+	struct sort_chunks_job
+	{
+		Value * data;
+		const ft::vector<std::size_t> * bounds;
+		key_order<Value, Compare> order;
+
+		sort_chunks_job(Value * d, const ft::vector<std::size_t>& b, const Compare& c) : data(d), bounds(&b), order(c) {}
+
+		void run(std::size_t i)
+		{
+			std::stable_sort(data + (*bounds)[i], data + (*bounds)[i + 1], order);
+		}
+	};
+
+	//Merges pairs of consecutive sorted runs of `width` chunks from src to dst. On equal keys, the element of the
+	//first run comes first, so the merge keeps the input order of the duplicates.
+	template <class Value, class Compare>
+	struct merge_chunks_job
+	{
+		const Value * src;
+		Value * dst;
+		const ft::vector<std::size_t> * bounds;
+		std::size_t width;
+		key_order<Value, Compare> order;
+
+		merge_chunks_job(const Value * s, Value * d, const ft::vector<std::size_t>& b, std::size_t w, const Compare& c)
+			: src(s), dst(d), bounds(&b), width(w), order(c) {}
+
+		void run(std::size_t pair)
+		{
+			std::size_t chunks = bounds->size() - 1;
+			std::size_t first = pair * 2 * width;
+			std::size_t middle = std::min(first + width, chunks);
+			std::size_t last = std::min(first + 2 * width, chunks);
+			std::merge(src + (*bounds)[first], src + (*bounds)[middle], src + (*bounds)[middle], src + (*bounds)[last],
+				dst + (*bounds)[first], order);
+		}
+	};
+
+	//Sorts values by key on `threads` threads, keeping equal keys in their input order : the chunks are sorted
+	//on their own, then merged two by two until one run remains. buffer receives the temporary copies.
+	template <class Value, class Compare>
+	void parallel_stable_sort(ft::vector<Value>& values, ft::vector<Value>& buffer, const Compare& comp, unsigned int threads)
+	{
+		std::size_t n = values.size();
+		std::size_t chunks = std::max<std::size_t>(1, std::min<std::size_t>(threads, n / 1024));
+		ft::vector<std::size_t> bounds;
+		for (std::size_t i = 0; i <= chunks; i++)
+			bounds.push_back(n / chunks * i + std::min(i, n % chunks));
+		if (n == 0)
+			return;
+
+		sort_chunks_job<Value, Compare> sort_job(&values[0], bounds, comp);
+		parallel_run(sort_job, chunks, threads);
+		if (chunks == 1)
+			return;
+		buffer = values;
+		Value * src = &values[0];
+		Value * dst = &buffer[0];
+		for (std::size_t width = 1; width < chunks; width *= 2)
+		{
+			merge_chunks_job<Value, Compare> merge_job(src, dst, bounds, width, comp);
+			parallel_run(merge_job, (chunks + 2 * width - 1) / (2 * width), threads);
+			std::swap(src, dst);
+		}
+		if (src != &values[0])
+			values.swap(buffer);
+	}
+
+	//Builds the tree of a map from sorted unique values, without any comparison : the middle value becomes the root
+	//and each half a subtree, recursively. The subtrees below the top levels are built concurrently.
+	template <class Map>
+	class map_builder
+	{
+		public:
+			typedef typename Map::node_type node_type;
+
+			map_builder(Map& m) : _map(m) {}
+
+			//Replaces the content of the map by the n sorted unique values. If a copy or an allocation throws,
+			//the nodes already built are freed and the map is left empty.
+			template <class Value>
+			void build(const Value * values, std::size_t n, unsigned int threads)
+			{
+				_map.clear();
+				if (n == 0)
+					return;
+				_map._tree.reserve_past_end();
+				int levels = 0;
+				while ((static_cast<std::size_t>(1) << levels) < threads * parallel_pieces_per_thread && (static_cast<std::size_t>(1) << levels) < n / 1024)
+					levels++;
+
+				node_type * root;
+				if (levels == 0) //too small to be shared between threads
+					root = build_subtree(values, n, NULL);
+				else
+				{
+					build_job<Value> job(*this);
+					root = build_top(values, n, NULL, levels, job.pending);
+					try
+					{
+						parallel_run(job, job.pending.size(), threads);
+					}
+					catch (...)
+					{
+						_map._tree.clear(root); //with the subtrees which were built
+						throw;
+					}
+					update_top_heights(root, levels);
+				}
+				_map._tree.root = root;
+				_map._tree.update_past_end();
+			}
+
+		private:
+			//A subtree left to build below the top levels
+			template <class Value>
+			struct subtree
+			{
+				node_type ** slot; //link of the parent
+				node_type * parent;
+				const Value * values;
+				std::size_t count;
+			};
+
+			template <class Value>
+			struct build_job
+			{
+				map_builder * builder;
+				ft::vector<subtree<Value> > pending;
+
+				build_job(map_builder& b) : builder(&b) {}
+
+				void run(std::size_t i)
+				{
+					const subtree<Value>& s = pending[i];
+					*s.slot = builder->build_subtree(s.values, s.count, s.parent);
+				}
+			};
+
+			Map& _map;
+
+			template <class Value>
+			node_type * build_subtree(const Value * values, std::size_t n, node_type * parent)
+			{
+				if (n == 0)
+					return NULL;
+				std::size_t middle = n / 2;
+				node_type * node = _map._tree.create_node(values[middle]);
+				node->parent = parent;
+				try
+				{
+					node->left = build_subtree(values, middle, node);
+					node->right = build_subtree(values + middle + 1, n - middle - 1, node);
+				}
+				catch (...)
+				{
+					_map._tree.clear(node);
+					throw;
+				}
+				_map._tree.update_height(node);
+				return node;
+			}
+
+			//Builds the nodes of the top levels (at least one), and describes the subtrees below them in pending
+			template <class Value>
+			node_type * build_top(const Value * values, std::size_t n, node_type * parent, int levels, ft::vector<subtree<Value> >& pending)
+			{
+				if (n == 0)
+					return NULL;
+				std::size_t middle = n / 2;
+				node_type * node = _map._tree.create_node(values[middle]);
+				node->parent = parent;
+				try
+				{
+					if (levels == 1)
+					{
+						subtree<Value> left = {&node->left, node, values, middle};
+						subtree<Value> right = {&node->right, node, values + middle + 1, n - middle - 1};
+						pending.push_back(left);
+						pending.push_back(right);
+					}
+					else
+					{
+						node->left = build_top(values, middle, node, levels - 1, pending);
+						node->right = build_top(values + middle + 1, n - middle - 1, node, levels - 1, pending);
+					}
+				}
+				catch (...)
+				{
+					_map._tree.clear(node);
+					throw;
+				}
+				return node;
+			}
+
+			//The heights of the top levels are known once the subtrees below them are built
+			void update_top_heights(node_type * node, int levels)
+			{
+				if (node == NULL || levels == 0)
+					return;
+				update_top_heights(node->left, levels - 1);
+				update_top_heights(node->right, levels - 1);
+				_map._tree.update_height(node);
+			}
+	};
+
+	//Replaces the content of out by the elements of [first, last), whose keys need not be sorted nor unique,
+	//using `threads` threads (all the processors if 0). The elements are copied and sorted in parallel, the duplicates
+	//are removed according to keep, and the tree is built balanced from the sorted run with no comparison nor rotation.
+	//Nodes are allocated from several threads : the allocator of the map must be thread-safe. If a copy, a comparison
+	//or an allocation throws, the exception is thrown again by the calling thread (see parallel_run), and out is left
+	//unchanged if it happened while sorting, or empty if it happened while building the tree.
+	template <class InputIterator, class Key, class T, class Compare, class Alloc, class Augment>
+	void build_map_parallel(InputIterator first, InputIterator last, map<Key, T, Compare, Alloc, Augment>& out,
+		duplicate_policy keep = keep_first, unsigned int threads = 0)
+	{
+		typedef map<Key, T, Compare, Alloc, Augment> map_type;
+		typedef ft::pair<Key, T> value_type; //with an assignable key, to be sorted
+		if (threads == 0)
+			threads = hardware_threads();
+
+		ft::vector<value_type> values;
+		for (; first != last; ++first)
+			values.push_back(value_type(first->first, first->second));
+		ft::vector<value_type> buffer;
+		Compare comp = out.key_comp();
+		parallel_stable_sort(values, buffer, comp, threads);
+
+		//equal keys are adjacent, in input order
+		std::size_t unique = 0;
+		for (std::size_t i = 0; i < values.size(); i++)
+		{
+			if (unique != 0 && !comp(values[unique - 1].first, values[i].first))
+			{
+				if (keep == keep_last)
+					values[unique - 1] = values[i];
+			}
+			else
+			{
+				if (unique != i)
+					values[unique] = values[i];
+				unique++;
+			}
+		}
+		map_builder<map_type> builder(out);
+		builder.build(unique != 0 ? &values[0] : static_cast<value_type *>(NULL), unique, threads);
+	}
+}
+
+#endif
@@ -0,0 +1,461 @@
+#ifndef SIMD_HPP
+# define SIMD_HPP
+
+# include <cstddef>
+# include <cstring>
+
+//Vector kernels of the algorithms of utils.hpp on contiguous integers, written with the vector extensions of GCC
+//and Clang. On x86, each kernel is compiled for SSE2 and for AVX2, and the level is chosen when the program runs.
+//Other targets and compilers use the scalar loops.
+# if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define FT_SIMD 1
+#  define FT_SIMD_INLINE __attribute__((always_inline)) //so that the kernel is compiled for the target of its caller
+# else
+#  define FT_SIMD 0
+# endif
+
+namespace ft
+{
+	/// LEVEL ///
+
+	enum simd_level
+	{
+		simd_scalar,
+		simd_sse2,
+		simd_avx2
+	};
+
+	//Best level supported by the CPU running the program
+	inline simd_level detected_simd_level()
+	{
+# if FT_SIMD
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+			return simd_avx2;
+		if (__builtin_cpu_supports("sse2"))
+			return simd_sse2;
+# endif
+		return simd_scalar;
+	}
+
+	inline simd_level& current_simd_level()
+	{
+		static simd_level level = detected_simd_level();
+		return level;
+	}
+
+	//Level used by the algorithms : the detected one, unless set_simd_level lowered it
+	inline simd_level get_simd_level()
+	{
+		return current_simd_level();
+	}
+
+	//Sets the level used by the algorithms, within what the CPU supports (to compare the kernels with the scalar loops)
+	inline void set_simd_level(simd_level level)
+	{
+		simd_level detected = detected_simd_level();
+		current_simd_level() = level < detected ? level : detected;
+	}
+
+# if FT_SIMD
+	/// BLOCK KERNELS ///
+
+	//Bytes bytes of T, processed by one instruction of the target
+	template <class T, std::size_t Bytes>
+	struct simd_block
+	{
+		typedef T type __attribute__((vector_size(Bytes)));
+		static const std::size_t lanes = Bytes / sizeof(T);
+	};
+
+	template <class Block, class T>
+	inline FT_SIMD_INLINE void simd_load(Block& block, const T * p)
+	{
+		std::memcpy(&block, p, sizeof(Block));
+	}
+
+	//Whether any lane of a comparison result is set
+	template <class Mask>
+	inline FT_SIMD_INLINE bool simd_any(const Mask& mask)
+	{
+		typedef typename simd_block<unsigned long long, sizeof(Mask)>::type words;
+		words w = reinterpret_cast<words>(mask);
+		unsigned long long any = 0;
+		for (std::size_t i = 0; i < sizeof(Mask) / sizeof(unsigned long long); i++)
+			any |= w[i];
+		return any != 0;
+	}
+
+	//First element equal (Equal true) or not equal (Equal false) to val
+	template <class T, std::size_t Bytes, bool Equal>
+	inline FT_SIMD_INLINE const T * simd_find(const T * first, const T * last, T val)
+	{
+		typedef simd_block<T, Bytes> block;
+		typename block::type needle = typename block::type() + val;
+		typename block::type x;
+		typename block::type y;
+		//two blocks per iteration, tested together
+		while (static_cast<std::size_t>(last - first) >= 2 * block::lanes)
+		{
+			simd_load(x, first);
+			simd_load(y, first + block::lanes);
+			if (Equal ? simd_any((x == needle) | (y == needle)) : simd_any((x != needle) | (y != needle)))
+				break;
+			first += 2 * block::lanes;
+		}
+		for (; first != last; ++first)
+			if ((*first == val) == Equal)
+				return first;
+		return last;
+	}
+
+	template <class T, std::size_t Bytes>
+	inline FT_SIMD_INLINE std::size_t simd_count(const T * first, const T * last, T val)
+	{
+		typedef simd_block<T, Bytes> block;
+		typedef __typeof__(typename block::type() == typename block::type()) mask;
+		//matches are counted in lanes of the size of T, and added up before one of them can overflow
+		const std::size_t flush = (static_cast<std::size_t>(1) << (8 * sizeof(T) - 1)) - 1;
+		typename block::type needle = typename block::type() + val;
+		typename block::type x;
+		std::size_t total = 0;
+		while (static_cast<std::size_t>(last - first) >= block::lanes)
+		{
+			mask counts = mask();
+			for (std::size_t i = 0; i < flush && static_cast<std::size_t>(last - first) >= block::lanes; i++, first += block::lanes)
+			{
+				simd_load(x, first);
+				counts -= (x == needle);
+			}
+			for (std::size_t i = 0; i < block::lanes; i++)
+				total += static_cast<std::size_t>(counts[i]);
+		}
+		for (; first != last; ++first)
+			if (*first == val)
+				total++;
+		return total;
+	}
+
+	//Smallest (Max false) or largest (Max true) element of a non-empty range
+	template <class T, std::size_t Bytes, bool Max>
+	inline FT_SIMD_INLINE T simd_extremum(const T * first, const T * last)
+	{
+		typedef simd_block<T, Bytes> block;
+		typename block::type best = typename block::type() + *first;
+		typename block::type x;
+		for (; static_cast<std::size_t>(last - first) >= block::lanes; first += block::lanes)
+		{
+			simd_load(x, first);
+			best = (Max ? best < x : x < best) ? x : best;
+		}
+		T result = best[0];
+		for (std::size_t i = 1; i < block::lanes; i++)
+			if (Max ? result < best[i] : best[i] < result)
+				result = best[i];
+		for (; first != last; ++first)
+			if (Max ? result < *first : *first < result)
+				result = *first;
+		return result;
+	}
+
+	//Unsigned integer of Size bytes
+	template <std::size_t Size>
+	struct simd_unsigned;
+
+	template <>
+	struct simd_unsigned<1> { typedef unsigned char type; };
+
+	template <>
+	struct simd_unsigned<2> { typedef unsigned short type; };
+
+	template <>
+	struct simd_unsigned<4> { typedef unsigned int type; };
+
+	template <>
+	struct simd_unsigned<8> { typedef unsigned long long type; };
+
+	//Sum modulo the range of T, which is what the scalar loop gives when it accumulates in a T.
+	//It is computed on unsigned integers, whose overflow is defined.
+	template <class T, std::size_t Bytes>
+	inline FT_SIMD_INLINE T simd_sum(const T * first, const T * last, T init)
+	{
+		typedef typename simd_unsigned<sizeof(T)>::type word;
+		typedef simd_block<word, Bytes> block;
+		typename block::type sum = typename block::type();
+		typename block::type x;
+		for (; static_cast<std::size_t>(last - first) >= block::lanes; first += block::lanes)
+		{
+			simd_load(x, first);
+			sum += x;
+		}
+		word total = static_cast<word>(init);
+		for (std::size_t i = 0; i < block::lanes; i++)
+			total = static_cast<word>(total + sum[i]);
+		for (; first != last; ++first)
+			total = static_cast<word>(total + static_cast<word>(*first));
+		return static_cast<T>(total);
+	}
+
+	//Index of the first difference between a and b, or n
+	template <class T, std::size_t Bytes>
+	inline FT_SIMD_INLINE std::size_t simd_mismatch(const T * a, const T * b, std::size_t n)
+	{
+		typedef simd_block<T, Bytes> block;
+		typename block::type x;
+		typename block::type y;
+		std::size_t i = 0;
+		for (; n - i >= block::lanes; i += block::lanes)
+		{
+			simd_load(x, a + i);
+			simd_load(y, b + i);
+			if (simd_any(x != y))
+				break;
+		}
+		for (; i < n && a[i] == b[i]; i++)
+			;
+		return i;
+	}
+
+	//dst[i] = dst[i] Operation src[i], for the words of bitsets
+	enum simd_bitwise_operation
+	{
+		simd_and,
+		simd_or,
+		simd_xor
+	};
+
+	template <class T, std::size_t Bytes, int Operation>
+	inline FT_SIMD_INLINE void simd_bitwise(T * dst, const T * src, std::size_t n)
+	{
+		typedef simd_block<T, Bytes> block;
+		typename block::type x;
+		typename block::type y;
+		std::size_t i = 0;
+		for (; n - i >= block::lanes; i += block::lanes)
+		{
+			simd_load(x, dst + i);
+			simd_load(y, src + i);
+			x = Operation == simd_and ? (x & y) : Operation == simd_or ? (x | y) : (x ^ y);
+			std::memcpy(dst + i, &x, Bytes);
+		}
+		for (; i < n; i++)
+			dst[i] = Operation == simd_and ? (dst[i] & src[i]) : Operation == simd_or ? (dst[i] | src[i]) : (dst[i] ^ src[i]);
+	}
+
+	//Number of set bits of the words, with the POPCNT instruction when the caller is compiled for it
+	template <class T>
+	inline FT_SIMD_INLINE std::size_t simd_popcount(const T * first, const T * last)
+	{
+		std::size_t total = 0;
+		for (; first != last; ++first)
+			total += static_cast<std::size_t>(__builtin_popcountll(*first));
+		return total;
+	}
+# endif
+
+	/// DISPATCH ///
+
+	//The kernels for the integral type T (except bool), at the current level.
+	//The ranges may be empty, except for min and max.
+	template <class T>
+	struct simd_kernels
+	{
+		//SSE2 has no comparison of 64 bits integers, whose emulation is slower than the scalar loops
+		static simd_level level()
+		{
+			simd_level current = get_simd_level();
+			return current == simd_sse2 && sizeof(T) == 8 ? simd_scalar : current;
+		}
+
+		static const T * find(const T * first, const T * last, T val)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				return find_avx2(first, last, val);
+			if (level() == simd_sse2)
+				return simd_find<T, 16, true>(first, last, val);
+# endif
+			for (; first != last; ++first)
+				if (*first == val)
+					break;
+			return first;
+		}
+
+		static const T * find_not(const T * first, const T * last, T val)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				return find_not_avx2(first, last, val);
+			if (level() == simd_sse2)
+				return simd_find<T, 16, false>(first, last, val);
+# endif
+			for (; first != last; ++first)
+				if (!(*first == val))
+					break;
+			return first;
+		}
+
+		static std::size_t count(const T * first, const T * last, T val)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				return count_avx2(first, last, val);
+			if (level() == simd_sse2)
+				return simd_count<T, 16>(first, last, val);
+# endif
+			std::size_t total = 0;
+			for (; first != last; ++first)
+				if (*first == val)
+					total++;
+			return total;
+		}
+
+		static T min(const T * first, const T * last)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				return min_avx2(first, last);
+			if (level() == simd_sse2)
+				return simd_extremum<T, 16, false>(first, last);
+# endif
+			T result = *first;
+			for (++first; first != last; ++first)
+				if (*first < result)
+					result = *first;
+			return result;
+		}
+
+		static T max(const T * first, const T * last)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				return max_avx2(first, last);
+			if (level() == simd_sse2)
+				return simd_extremum<T, 16, true>(first, last);
+# endif
+			T result = *first;
+			for (++first; first != last; ++first)
+				if (result < *first)
+					result = *first;
+			return result;
+		}
+
+		static T sum(const T * first, const T * last, T init)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				return sum_avx2(first, last, init);
+			if (level() == simd_sse2)
+				return simd_sum<T, 16>(first, last, init);
+# endif
+			for (; first != last; ++first)
+				init = init + *first;
+			return init;
+		}
+
+		static std::size_t mismatch(const T * a, const T * b, std::size_t n)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				return mismatch_avx2(a, b, n);
+			if (level() == simd_sse2)
+				return simd_mismatch<T, 16>(a, b, n);
+# endif
+			std::size_t i = 0;
+			for (; i < n && a[i] == b[i]; i++)
+				;
+			return i;
+		}
+
+		//For unsigned T : number of set bits
+		static std::size_t popcount(const T * first, const T * last)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				return popcount_avx2(first, last);
+			if (level() == simd_sse2)
+				return simd_popcount(first, last);
+# endif
+			std::size_t total = 0;
+			for (; first != last; ++first)
+				for (T word = *first; word != 0; word &= word - 1)
+					total++;
+			return total;
+		}
+
+		//For unsigned T : dst[i] = dst[i] Operation src[i] (simd_and, simd_or or simd_xor)
+		template <int Operation>
+		static void bitwise(T * dst, const T * src, std::size_t n)
+		{
+# if FT_SIMD
+			if (level() == simd_avx2)
+				bitwise_avx2<Operation>(dst, src, n);
+			else if (level() == simd_sse2)
+				simd_bitwise<T, 16, Operation>(dst, src, n);
+			if (level() != simd_scalar)
+				return;
+# endif
+			for (std::size_t i = 0; i < n; i++)
+				dst[i] = Operation == simd_and ? (dst[i] & src[i]) : Operation == simd_or ? (dst[i] | src[i]) : (dst[i] ^ src[i]);
+		}
+
+		//memcmp, which the C library vectorizes, is exact for integers
+		static bool equal(const T * a, const T * b, std::size_t n)
+		{
+			if (level() == simd_scalar)
+				return mismatch(a, b, n) == n;
+			return n == 0 || std::memcmp(a, b, n * sizeof(T)) == 0;
+		}
+
+# if FT_SIMD
+		private:
+			__attribute__((target("avx2"))) static const T * find_avx2(const T * first, const T * last, T val)
+			{
+				return simd_find<T, 32, true>(first, last, val);
+			}
+
+			__attribute__((target("avx2"))) static const T * find_not_avx2(const T * first, const T * last, T val)
+			{
+				return simd_find<T, 32, false>(first, last, val);
+			}
+
+			__attribute__((target("avx2"))) static std::size_t count_avx2(const T * first, const T * last, T val)
+			{
+				return simd_count<T, 32>(first, last, val);
+			}
+
+			__attribute__((target("avx2"))) static T min_avx2(const T * first, const T * last)
+			{
+				return simd_extremum<T, 32, false>(first, last);
+			}
+
+			__attribute__((target("avx2"))) static T max_avx2(const T * first, const T * last)
+			{
+				return simd_extremum<T, 32, true>(first, last);
+			}
+
+			__attribute__((target("avx2"))) static T sum_avx2(const T * first, const T * last, T init)
+			{
+				return simd_sum<T, 32>(first, last, init);
+			}
+
+			__attribute__((target("avx2"))) static std::size_t mismatch_avx2(const T * a, const T * b, std::size_t n)
+			{
+				return simd_mismatch<T, 32>(a, b, n);
+			}
+
+			__attribute__((target("avx2,popcnt"))) static std::size_t popcount_avx2(const T * first, const T * last)
+			{
+				return simd_popcount(first, last);
+			}
+
+			template <int Operation>
+			__attribute__((target("avx2"))) static void bitwise_avx2(T * dst, const T * src, std::size_t n)
+			{
+				simd_bitwise<T, 32, Operation>(dst, src, n);
+			}
+# endif
+	};
+}
+
+#endif
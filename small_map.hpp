@@ -0,0 +1,586 @@
+#ifndef SMALL_MAP_HPP
+# define SMALL_MAP_HPP
+
+# include <memory>
+# include <new>
+# include <functional>
+# include <stdexcept>
+# include "utils.hpp"
+# include "avl_tree.hpp"
+# include "iterator.hpp"
+# include "map.hpp"
+
+namespace ft
+{
+	//Map which stores up to N elements inside the object itself, without any allocation.
+	//The insertion of element N + 1 moves all the elements to an ft::map, and clear() goes back to the inline storage.
+	//The inline elements are tree nodes chained in key order (each one is the right child of the previous one),
+	//so the ft::map iterators walk them unchanged, and inserting or erasing an inline element does not move the others.
+	//Inline lookups are linear, which is faster than a tree descent for a few elements.
+	//Moving the elements to or from the ft::map invalidates all the iterators.
+	template < class Key, class T, std::size_t N = 8, class Compare = std::less<Key>, class Alloc = std::allocator<ft::TreeNode<pair<const Key,T> > > >
+	class small_map
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef ft::map<Key, T, Compare, Alloc> map_type; //storage used above N elements
+			typedef Key key_type;
+			typedef T mapped_type;
+			typedef typename map_type::value_type value_type;
+			typedef Compare key_compare;
+			typedef typename map_type::value_compare value_compare;
+			typedef Alloc allocator_type;
+			typedef typename allocator_type::reference reference;
+			typedef typename allocator_type::const_reference const_reference;
+			typedef typename allocator_type::pointer pointer;
+			typedef typename allocator_type::const_pointer const_pointer;
+			typedef typename map_type::iterator iterator;
+			typedef typename map_type::const_iterator const_iterator;
+			typedef typename map_type::reverse_iterator reverse_iterator;
+			typedef typename map_type::const_reverse_iterator const_reverse_iterator;
+			typedef typename map_type::difference_type difference_type;
+			typedef typename map_type::size_type size_type;
+
+		private:
+			typedef TreeNode<value_type> node_type;
+			typedef typename node_type::links_type links_type;
+			typedef typename Alloc::template rebind<node_type>::other node_allocator;
+			typedef typename Alloc::template rebind<map_type>::other map_allocator;
+			typedef char inline_capacity_fits_in_used_mask[(N > 0 && N <= sizeof(unsigned long) * 8) ? 1 : -1];
+
+			//value_compare can only be constructed by ft::map
+			struct make_value_compare : public value_compare
+			{
+				make_value_compare(const Compare& c) : value_compare(c) {}
+			};
+
+		public:
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			//Empty constructor, which does not allocate
+			explicit small_map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+				: _comp(comp), _alloc(alloc), _map(NULL)
+			{
+				init_inline();
+			}
+
+			//Range constructor
+			template <class InputIterator>
+			small_map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+				: _comp(comp), _alloc(alloc), _map(NULL)
+			{
+				init_inline();
+				insert(first, last);
+			}
+
+			//Copy constructor
+			small_map (const small_map& x) : _comp(x._comp), _alloc(x._alloc), _map(NULL)
+			{
+				init_inline();
+				insert(x.begin(), x.end());
+			}
+
+			~small_map()
+			{
+				clear();
+			}
+
+			small_map& operator= (const small_map& x)
+			{
+				if (&x == this)
+					return (*this);
+				clear();
+				insert(x.begin(), x.end());
+				return *this;
+			}
+
+			/// ITERATORS ///
+
+			iterator begin()
+			{
+				if (_map != NULL)
+					return _map->begin();
+				if (_first == NULL)
+					return iterator(sentinel());
+				return iterator(_first, sentinel());
+			}
+
+			const_iterator begin() const
+			{
+				if (_map != NULL)
+					return static_cast<const map_type *>(_map)->begin();
+				if (_first == NULL)
+					return const_iterator(sentinel());
+				return const_iterator(_first, sentinel());
+			}
+
+			iterator end()
+			{
+				if (_map != NULL)
+					return _map->end();
+				return iterator(sentinel(), sentinel());
+			}
+
+			const_iterator end() const
+			{
+				if (_map != NULL)
+					return static_cast<const map_type *>(_map)->end();
+				return const_iterator(sentinel(), sentinel());
+			}
+
+			reverse_iterator rbegin()
+			{
+				return reverse_iterator(end());
+			}
+
+			const_reverse_iterator rbegin() const
+			{
+				return const_reverse_iterator(end());
+			}
+
+			reverse_iterator rend()
+			{
+				return reverse_iterator(begin());
+			}
+
+			const_reverse_iterator rend() const
+			{
+				return const_reverse_iterator(begin());
+			}
+
+			/// CAPACITY ///
+
+			bool empty() const
+			{
+				return size() == 0;
+			}
+
+			size_type size() const
+			{
+				if (_map != NULL)
+					return _map->size();
+				return _size;
+			}
+
+			size_type max_size() const
+			{
+				return node_allocator(_alloc).max_size();
+			}
+
+			//Whether the elements are stored inside the object
+			bool is_inline() const
+			{
+				return _map == NULL;
+			}
+
+			/// ELEMENT ACCESS ///
+
+			mapped_type& operator[] (const key_type& k)
+			{
+				return (*((insert(ft::make_pair(k, mapped_type()))).first)).second;
+			}
+
+			mapped_type& at (const key_type& k)
+			{
+				iterator it_found = find(k);
+				if (it_found == end())
+					throw std::out_of_range("small_map::at");
+				return it_found->second;
+			}
+
+			const mapped_type& at (const key_type& k) const
+			{
+				const_iterator it_found = find(k);
+				if (it_found == end())
+					throw std::out_of_range("small_map::at");
+				return it_found->second;
+			}
+
+			/// MODIFIERS ///
+
+			pair<iterator,bool> insert (const value_type& val)
+			{
+				if (_map != NULL)
+					return _map->insert(val);
+
+				//the new node goes between the last node with a smaller key and the next one
+				node_type * prev = NULL;
+				node_type * next = _first;
+				while (next != NULL && _comp(next->value.first, val.first))
+				{
+					prev = next;
+					next = next->right;
+				}
+				if (next != NULL && !_comp(val.first, next->value.first))
+					return ft::make_pair<iterator, bool>(iterator(next, sentinel()), false);
+				if (_size == N)
+				{
+					promote();
+					return _map->insert(val);
+				}
+
+				node_type * node = new_slot(val);
+				node->parent = prev;
+				node->right = next;
+				if (prev != NULL)
+					prev->right = node;
+				else
+					_first = node;
+				if (next != NULL)
+					next->parent = node;
+				else
+					sentinel()->left = node;
+				_size++;
+				return ft::make_pair<iterator, bool>(iterator(node, sentinel()), true);
+			}
+
+			//The position hint is not used
+			iterator insert (iterator position, const value_type& val)
+			{
+				(void)position;
+				return insert(val).first;
+			}
+
+			template <class InputIterator>
+			void insert (InputIterator first, InputIterator last, typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+			{
+				while (first != last)
+					insert(*(first++));
+			}
+
+			void erase (iterator position)
+			{
+				if (_map != NULL)
+					_map->erase(position);
+				else
+					erase(position->first);
+			}
+
+			size_type erase (const key_type& k)
+			{
+				if (_map != NULL)
+					return _map->erase(k);
+				node_type * node = find_node(k);
+				if (node == NULL)
+					return 0;
+				if (node->parent != NULL)
+					node->parent->right = node->right;
+				else
+					_first = node->right;
+				if (node->right != NULL)
+					node->right->parent = node->parent;
+				else
+					sentinel()->left = node->parent;
+				delete_slot(node);
+				_size--;
+				return 1;
+			}
+
+			void erase (iterator first, iterator last)
+			{
+				while (first != last)
+					erase(first++);
+			}
+
+			//Exchanges the elements, the comparison objects and the allocators. The ft::map of a map which moved to one
+			//changes hands, and the inline elements (at most N per map) are copied to the slots of the other map.
+			//If one of these copies throws, both maps stay valid, and each keeps the order of its elements.
+			void swap (small_map& x)
+			{
+				if (_map == NULL || x._map == NULL)
+				{
+					small_map tmp(x._comp, x._alloc);
+					tmp.take(x);
+					try
+					{
+						x.take(*this);
+					}
+					catch (...)
+					{
+						x.take(tmp);
+						throw;
+					}
+					try
+					{
+						take(tmp);
+					}
+					catch (...)
+					{
+						std::swap(_comp, x._comp);
+						std::swap(_alloc, x._alloc);
+						throw;
+					}
+				}
+				else
+					std::swap(_map, x._map);
+				std::swap(_comp, x._comp);
+				std::swap(_alloc, x._alloc);
+			}
+
+			//Destroys all the elements, and goes back to the inline storage
+			void clear()
+			{
+				if (_map != NULL)
+				{
+					map_allocator a(_alloc);
+					a.destroy(_map);
+					a.deallocate(_map, 1);
+					_map = NULL;
+				}
+				else
+				{
+					node_type * next;
+					for (node_type * node = _first; node != NULL; node = next)
+					{
+						next = node->right;
+						delete_slot(node);
+					}
+				}
+				init_inline();
+			}
+
+			/// OBSERVERS ///
+
+			key_compare key_comp() const
+			{
+				return _comp;
+			}
+
+			value_compare value_comp() const
+			{
+				return make_value_compare(_comp);
+			}
+
+			/// LOOKUP ///
+
+			iterator find (const key_type& k)
+			{
+				if (_map != NULL)
+					return _map->find(k);
+				node_type * node = find_node(k);
+				if (node == NULL)
+					return end();
+				return iterator(node, sentinel());
+			}
+
+			const_iterator find (const key_type& k) const
+			{
+				if (_map != NULL)
+					return static_cast<const map_type *>(_map)->find(k);
+				node_type * node = find_node(k);
+				if (node == NULL)
+					return end();
+				return const_iterator(node, sentinel());
+			}
+
+			size_type count (const key_type& k) const
+			{
+				if (_map != NULL)
+					return _map->count(k);
+				return find_node(k) != NULL ? 1 : 0;
+			}
+
+			iterator lower_bound (const key_type& k)
+			{
+				if (_map != NULL)
+					return _map->lower_bound(k);
+				node_type * node = _first;
+				while (node != NULL && _comp(node->value.first, k))
+					node = node->right;
+				return node != NULL ? iterator(node, sentinel()) : end();
+			}
+
+			const_iterator lower_bound (const key_type& k) const
+			{
+				return const_cast<small_map *>(this)->lower_bound(k);
+			}
+
+			iterator upper_bound (const key_type& k)
+			{
+				if (_map != NULL)
+					return _map->upper_bound(k);
+				node_type * node = _first;
+				while (node != NULL && !_comp(k, node->value.first))
+					node = node->right;
+				return node != NULL ? iterator(node, sentinel()) : end();
+			}
+
+			const_iterator upper_bound (const key_type& k) const
+			{
+				return const_cast<small_map *>(this)->upper_bound(k);
+			}
+
+			pair<iterator,iterator> equal_range (const key_type& k)
+			{
+				return ft::make_pair(lower_bound(k), upper_bound(k));
+			}
+
+			pair<const_iterator,const_iterator> equal_range (const key_type& k) const
+			{
+				return ft::make_pair(lower_bound(k), upper_bound(k));
+			}
+
+			allocator_type get_allocator() const
+			{
+				return allocator_type(_alloc);
+			}
+
+		private:
+			key_compare _comp;
+			allocator_type _alloc;
+			map_type * _map; //NULL while the elements are inline
+			node_type * _first; //smallest inline element
+			size_type _size; //number of inline elements
+			unsigned long _used; //bit i is set when the inline slot i holds an element
+			links_type _sentinel; //past-the-end of the inline elements
+			union
+			{
+				char bytes[N * sizeof(node_type)];
+				void * align_pointer;
+				long double align_float;
+				unsigned long long align_integer;
+			} _storage;
+
+			node_type * slots() const
+			{
+				return reinterpret_cast<node_type *>(const_cast<char *>(_storage.bytes));
+			}
+
+			links_type * sentinel() const
+			{
+				return const_cast<links_type *>(&_sentinel);
+			}
+
+			void init_inline()
+			{
+				_first = NULL;
+				_size = 0;
+				_used = 0;
+				sentinel()->left = NULL;
+				sentinel()->right = NULL;
+				sentinel()->parent = NULL;
+			}
+
+			//Copies val to a free slot, which is marked used only once the copy succeeded
+			node_type * new_slot(const value_type& val)
+			{
+				std::size_t i = 0;
+				while (_used & (1UL << i))
+					i++;
+				node_allocator(_alloc).construct(slots() + i, node_type(val));
+				_used |= 1UL << i;
+				return slots() + i;
+			}
+
+			void delete_slot(node_type * node)
+			{
+				node_allocator(_alloc).destroy(node);
+				_used &= ~(1UL << (node - slots()));
+			}
+
+			node_type * find_node(const key_type& k) const
+			{
+				node_type * node = _first;
+				while (node != NULL && _comp(node->value.first, k))
+					node = node->right;
+				if (node == NULL || _comp(k, node->value.first))
+					return NULL;
+				return node;
+			}
+
+			//Moves the inline elements to a new ft::map. If a copy throws, the new map is freed and the elements stay inline.
+			void promote()
+			{
+				map_allocator a(_alloc);
+				map_type * m = a.allocate(1);
+				try
+				{
+					::new (static_cast<void *>(m)) map_type(_comp, _alloc);
+				}
+				catch (...)
+				{
+					a.deallocate(m, 1);
+					throw;
+				}
+				try
+				{
+					for (node_type * node = _first; node != NULL; node = node->right)
+						m->insert(node->value);
+				}
+				catch (...)
+				{
+					a.destroy(m);
+					a.deallocate(m, 1);
+					throw;
+				}
+				clear();
+				_map = m;
+			}
+
+			//Takes the elements of from, which is left empty and inline. The map must be empty and inline.
+			//An ft::map changes hands, inline elements are copied in order to the slots of this map : if a copy throws,
+			//from keeps its elements and this map stays empty.
+			void take(small_map& from)
+			{
+				if (from._map != NULL)
+				{
+					_map = from._map;
+					from._map = NULL;
+					return;
+				}
+				try
+				{
+					for (node_type * node = from._first; node != NULL; node = node->right)
+					{
+						node_type * copy = new_slot(node->value);
+						copy->parent = sentinel()->left;
+						copy->right = NULL;
+						if (_first == NULL)
+							_first = copy;
+						else
+							sentinel()->left->right = copy;
+						sentinel()->left = copy;
+						_size++;
+					}
+				}
+				catch (...)
+				{
+					clear();
+					throw;
+				}
+				from.clear();
+			}
+	};
+
+	///-------------------------------///
+	/// NON-MEMBER FUNCTION OVERLOADS ///
+	///-------------------------------///
+
+	template < class Key, class T, std::size_t N, class Compare, class Alloc >
+	bool operator== (const small_map<Key, T, N, Compare, Alloc>& lhs, const small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		if (lhs.size() != rhs.size())
+			return false;
+		return ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template < class Key, class T, std::size_t N, class Compare, class Alloc >
+	bool operator!= (const small_map<Key, T, N, Compare, Alloc>& lhs, const small_map<Key, T, N, Compare, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template < class Key, class T, std::size_t N, class Compare, class Alloc >
+	void swap (small_map<Key, T, N, Compare, Alloc>& x, small_map<Key, T, N, Compare, Alloc>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
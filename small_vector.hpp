@@ -0,0 +1,577 @@
+#ifndef SMALL_VECTOR_HPP
+# define SMALL_VECTOR_HPP
+
+# include <memory>
+# include <algorithm>
+# include <stdexcept>
+# include "utils.hpp"
+# include "iterator.hpp"
+# include "vector.hpp"
+
+namespace ft
+{
+	//Vector which stores up to N elements inside the object itself, without any allocation.
+	//Outgrowing N moves the elements to the heap, where the vector grows like an ft::vector, and it keeps its heap block
+	//until it is destroyed. It has the interface and the iterators of ft::vector, and can be the container of an ft::stack.
+	//Inline elements cannot be handed over : swapping or moving a vector whose elements are inline moves them one by one,
+	//which invalidates their iterators.
+	template < class T, std::size_t N = 8, class Alloc = std::allocator<T>, class Growth = ft::grow_double >
+	class small_vector
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef T value_type;
+			typedef Alloc allocator_type;
+			typedef Growth growth_policy;
+			typedef typename allocator_type::reference reference;
+			typedef typename allocator_type::const_reference const_reference;
+			typedef typename allocator_type::pointer pointer;
+			typedef typename allocator_type::const_pointer const_pointer;
+			typedef ft::random_access_iterator<value_type> iterator;
+			typedef ft::random_access_iterator<const value_type> const_iterator;
+			typedef ft::reverse_iterator<iterator> reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+			typedef std::ptrdiff_t difference_type;
+			typedef std::size_t size_type;
+
+			static const size_type inline_capacity = N;
+
+		private:
+			typedef char inline_capacity_must_not_be_zero[N != 0 ? 1 : -1];
+
+		public:
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			explicit small_vector (const allocator_type& alloc = allocator_type())
+				: _alloc(alloc), _start(inline_storage()), _size(0), _capacity(N) {}
+
+			explicit small_vector (size_type n, const value_type& val = value_type(), const allocator_type& alloc = allocator_type())
+				: _alloc(alloc), _start(inline_storage()), _size(0), _capacity(N)
+			{
+				insert(end(), n, val);
+			}
+
+			template <class InputIterator>
+			small_vector (InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+				: _alloc(alloc), _start(inline_storage()), _size(0), _capacity(N)
+			{
+				insert(end(), first, last);
+			}
+
+			small_vector (const small_vector& x)
+				: _alloc(x._alloc), _start(inline_storage()), _size(0), _capacity(N)
+			{
+				*this = x;
+			}
+
+			small_vector& operator= (const small_vector& x)
+			{
+				if (&x == this)
+					return *this;
+				clear();
+				if (x._size > _capacity)
+					reallocate(x._size);
+				ft::copy_elements(_alloc, _start, x._start, x._size);
+				_size = x._size;
+				return *this;
+			}
+
+# if FT_MOVE_SEMANTICS
+			//Takes the heap block of x, or moves its inline elements. x is left empty.
+			small_vector (small_vector&& x)
+				: _alloc(x._alloc), _start(inline_storage()), _size(0), _capacity(N)
+			{
+				take(x);
+			}
+
+			small_vector& operator= (small_vector&& x)
+			{
+				if (&x != this)
+				{
+					clear();
+					release_storage();
+					take(x);
+				}
+				return *this;
+			}
+# endif
+
+			~small_vector()
+			{
+				clear();
+				release_storage();
+			}
+
+			/// ITERATORS ///
+
+			iterator begin()
+			{
+				return iterator(_start);
+			}
+
+			const_iterator begin() const
+			{
+				return const_iterator(_start);
+			}
+
+			iterator end()
+			{
+				return iterator(_start + _size);
+			}
+
+			const_iterator end() const
+			{
+				return const_iterator(_start + _size);
+			}
+
+			reverse_iterator rbegin()
+			{
+				return reverse_iterator(end());
+			}
+
+			const_reverse_iterator rbegin() const
+			{
+				return const_reverse_iterator(end());
+			}
+
+			reverse_iterator rend()
+			{
+				return reverse_iterator(begin());
+			}
+
+			const_reverse_iterator rend() const
+			{
+				return const_reverse_iterator(begin());
+			}
+
+			/// CAPACITY ///
+
+			size_type size() const
+			{
+				return _size;
+			}
+
+			size_type max_size() const
+			{
+				return _alloc.max_size();
+			}
+
+			void resize (size_type n, value_type val = value_type())
+			{
+				if (n < _size)
+				{
+					ft::destroy_elements(_alloc, _start + n, _start + _size);
+					_size = n;
+				}
+				else if (n > _size)
+					insert(end(), n - _size, val);
+			}
+
+			//N while the elements are inline
+			size_type capacity() const
+			{
+				return _capacity;
+			}
+
+			bool empty() const
+			{
+				return _size == 0;
+			}
+
+			void reserve (size_type n)
+			{
+				if (n > max_size())
+					throw (std::length_error("small_vector::reserve"));
+				if (n > _capacity)
+					reallocate(n);
+			}
+
+			//Whether the elements are stored inside the object
+			bool is_inline() const
+			{
+				return _start == inline_storage();
+			}
+
+			/// ELEMENT ACCESS ///
+
+			reference operator[] (size_type n)
+			{
+				return _start[n];
+			}
+
+			const_reference operator[] (size_type n) const
+			{
+				return _start[n];
+			}
+
+			reference at (size_type n)
+			{
+				if (n >= _size)
+					throw std::out_of_range("small_vector::at index out of range");
+				return _start[n];
+			}
+
+			const_reference at (size_type n) const
+			{
+				if (n >= _size)
+					throw std::out_of_range("small_vector::at index out of range");
+				return _start[n];
+			}
+
+			reference front()
+			{
+				return *_start;
+			}
+
+			const_reference front() const
+			{
+				return *_start;
+			}
+
+			reference back()
+			{
+				return _start[_size - 1];
+			}
+
+			const_reference back() const
+			{
+				return _start[_size - 1];
+			}
+
+			/// MODIFIERS ///
+
+			template <class InputIterator>
+			void assign (InputIterator first, InputIterator last,
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+			{
+				clear();
+				insert(end(), first, last);
+			}
+
+			void assign (size_type n, const value_type& val)
+			{
+				const value_type copy(val); //val may be an element, which clear() is going to destroy
+				clear();
+				insert(end(), n, copy);
+			}
+
+			void push_back (const value_type& val)
+			{
+				if (_size == _capacity)
+				{
+					value_type copy(val); //val may be an element, which the reallocation is going to move
+					reallocate(grown_capacity(_size + 1));
+					_alloc.construct(_start + _size, FT_MOVE(copy));
+				}
+				else
+					_alloc.construct(_start + _size, val);
+				_size++;
+			}
+
+# if FT_MOVE_SEMANTICS
+			void push_back (value_type&& val)
+			{
+				emplace_back(std::move(val));
+			}
+
+			template <class... Args>
+			void emplace_back (Args&&... args)
+			{
+				if (_size == _capacity)
+				{
+					value_type element(std::forward<Args>(args)...); //args may refer to elements, which the reallocation is going to move
+					reallocate(grown_capacity(_size + 1));
+					_alloc.construct(_start + _size, std::move(element));
+				}
+				else
+					std::allocator_traits<allocator_type>::construct(_alloc, _start + _size, std::forward<Args>(args)...);
+				_size++;
+			}
+
+			template <class... Args>
+			iterator emplace (const_iterator position, Args&&... args)
+			{
+				size_type insert_index = static_cast<size_type>(position - const_iterator(_start));
+				if (insert_index > _size)
+					throw std::length_error("small_vector::emplace");
+				if (insert_index == _size)
+					emplace_back(std::forward<Args>(args)...);
+				else
+				{
+					value_type element(std::forward<Args>(args)...); //args may refer to elements which are going to move
+					open_gap(insert_index, 1);
+					try
+					{
+						_alloc.construct(_start + insert_index, std::move(element));
+					}
+					catch (...)
+					{
+						close_gap(insert_index, 1, 0);
+						throw;
+					}
+					_size++;
+				}
+				return iterator(_start + insert_index);
+			}
+
+			iterator insert (iterator position, value_type&& val)
+			{
+				return emplace(position, std::move(val));
+			}
+# endif
+
+			void pop_back()
+			{
+				_alloc.destroy(_start + _size - 1);
+				_size--;
+			}
+
+			iterator insert (iterator position, const value_type& val)
+			{
+				size_type insert_index = static_cast<size_type>(position - begin());
+				insert(position, 1, val);
+				return iterator(_start + insert_index);
+			}
+
+			void insert (iterator position, size_type n, const value_type& val)
+			{
+				if (n > max_size() - _size || position < begin() || position > end())
+					throw std::length_error("small_vector::insert");
+
+				size_type insert_index = static_cast<size_type>(position - begin());
+				const value_type copy(val); //val may be an element which is going to move
+				open_gap(insert_index, n);
+				size_type i = insert_index;
+				try
+				{
+					for (; i < insert_index + n; i++)
+						_alloc.construct(_start + i, copy);
+				}
+				catch (...)
+				{
+					close_gap(insert_index, n, i - insert_index);
+					throw;
+				}
+				_size += n;
+			}
+
+			template <class InputIterator>
+			void insert (iterator position, InputIterator first, InputIterator last,
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+			{
+				difference_type diff = std::distance(first, last);
+				if (diff < 0 || position < begin() || position > end())
+					throw std::length_error("small_vector::insert");
+
+				size_type n = static_cast<size_type>(diff);
+				size_type insert_index = static_cast<size_type>(position - begin());
+				open_gap(insert_index, n);
+				size_type i = insert_index;
+				try
+				{
+					for (; i < insert_index + n; i++, first++)
+						_alloc.construct(_start + i, *first);
+				}
+				catch (...)
+				{
+					close_gap(insert_index, n, i - insert_index);
+					throw;
+				}
+				_size += n;
+			}
+
+			iterator erase (iterator position)
+			{
+				return erase(position, position + 1);
+			}
+
+			iterator erase (iterator first, iterator last)
+			{
+				size_type n = static_cast<size_type>(last - first);
+				size_type erase_index = static_cast<size_type>(first - begin());
+				ft::destroy_elements(_alloc, _start + erase_index, _start + erase_index + n);
+				ft::relocate_elements(_alloc, _start + erase_index, _start + erase_index + n, _size - erase_index - n);
+				_size -= n;
+				return iterator(_start + erase_index);
+			}
+
+			//Exchanges the heap blocks when both vectors have one, and moves the elements otherwise
+			void swap (small_vector& x)
+			{
+				if (&x == this)
+					return;
+				if (!is_inline() && !x.is_inline())
+				{
+					std::swap(_alloc, x._alloc);
+					std::swap(_start, x._start);
+					std::swap(_size, x._size);
+					std::swap(_capacity, x._capacity);
+					return;
+				}
+				small_vector tmp(_alloc);
+				tmp.take(*this);
+				take(x);
+				x.take(tmp);
+			}
+
+			void clear()
+			{
+				ft::destroy_elements(_alloc, _start, _start + _size);
+				_size = 0;
+			}
+
+			/// ALLOCATOR ///
+
+			allocator_type get_allocator() const
+			{
+				return allocator_type(_alloc);
+			}
+
+		private:
+			allocator_type _alloc;
+			pointer _start; //inline storage or heap block
+			size_type _size;
+			size_type _capacity;
+			union
+			{
+				char bytes[N * sizeof(value_type)];
+				void * align_pointer;
+				long double align_float;
+				unsigned long long align_integer;
+			} _storage;
+
+			pointer inline_storage() const
+			{
+				return reinterpret_cast<pointer>(const_cast<char *>(_storage.bytes));
+			}
+
+			//Capacity to allocate for n elements, n being more than the current capacity, chosen by the growth policy
+			size_type grown_capacity(size_type n) const
+			{
+				if (n > max_size())
+					throw std::length_error("small_vector");
+				return Growth::next_capacity(_capacity, n, max_size(), sizeof(value_type));
+			}
+
+			//Moves the elements to a heap block of n elements
+			void reallocate(size_type n)
+			{
+				pointer new_start = _alloc.allocate(n);
+				ft::relocate_elements(_alloc, new_start, _start, _size);
+				release_storage();
+				_start = new_start;
+				_capacity = n;
+			}
+
+			//Frees the heap block, if any, and goes back to the inline storage. The elements must have been moved or destroyed.
+			void release_storage()
+			{
+				if (is_inline())
+					return;
+				_alloc.deallocate(_start, _capacity);
+				_start = inline_storage();
+				_capacity = N;
+			}
+
+			//Takes the elements of x, which is left empty and inline. The vector must be empty and inline.
+			void take(small_vector& x)
+			{
+				if (x.is_inline())
+					ft::relocate_elements(_alloc, _start, x._start, x._size);
+				else
+				{
+					_start = x._start;
+					_capacity = x._capacity;
+					x._start = x.inline_storage();
+					x._capacity = N;
+				}
+				_size = x._size;
+				x._size = 0;
+			}
+
+			//Makes room for n elements at index, moving the elements after it. The n elements are left uninitialized,
+			//and the caller adds them to the size once they are all constructed.
+			void open_gap(size_type index, size_type n)
+			{
+				if (n == 0)
+					return;
+				if (_size + n > _capacity)
+				{
+					size_type new_capacity = grown_capacity(_size + n);
+					pointer new_start = _alloc.allocate(new_capacity);
+					ft::relocate_elements(_alloc, new_start, _start, index);
+					ft::relocate_elements(_alloc, new_start + index + n, _start + index, _size - index);
+					release_storage();
+					_start = new_start;
+					_capacity = new_capacity;
+				}
+				else
+					ft::relocate_elements(_alloc, _start + index + n, _start + index, _size - index);
+			}
+
+			//Undoes open_gap(index, n) after the construction of an element threw : destroys the first built elements
+			//of the gap, and moves the elements after the gap back to index
+			void close_gap(size_type index, size_type n, size_type built)
+			{
+				ft::destroy_elements(_alloc, _start + index, _start + index + built);
+				ft::relocate_elements(_alloc, _start + index, _start + index + n, _size - index);
+			}
+	};
+
+	template < class T, std::size_t N, class Alloc, class Growth >
+	const std::size_t small_vector<T, N, Alloc, Growth>::inline_capacity;
+
+	///-------------------------------///
+	/// NON-MEMBER FUNCTION OVERLOADS ///
+	///-------------------------------///
+
+	template < class T, std::size_t N, class Alloc, class Growth >
+	bool operator== (const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template < class T, std::size_t N, class Alloc, class Growth >
+	bool operator!= (const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template < class T, std::size_t N, class Alloc, class Growth >
+	bool operator<  (const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+	{
+		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template < class T, std::size_t N, class Alloc, class Growth >
+	bool operator<= (const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template < class T, std::size_t N, class Alloc, class Growth >
+	bool operator>  (const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template < class T, std::size_t N, class Alloc, class Growth >
+	bool operator>= (const small_vector<T, N, Alloc, Growth>& lhs, const small_vector<T, N, Alloc, Growth>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	template < class T, std::size_t N, class Alloc, class Growth >
+	void swap (small_vector<T, N, Alloc, Growth>& x, small_vector<T, N, Alloc, Growth>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
@@ -20,6 +20,8 @@ main()
 	execute_speed_test ./bench_with_std $seed
 	echo "Running with ft..."
 	execute_speed_test ./bench_with_ft $seed
+	echo "Running ft extensions benchmarks..."
+	./bench_extensions
 }
 
 main "$@"
\ No newline at end of file
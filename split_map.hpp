@@ -0,0 +1,613 @@
+#ifndef SPLIT_MAP_HPP
+# define SPLIT_MAP_HPP
+
+# include <memory>
+# include <functional>
+# include <stdexcept>
+# include "utils.hpp"
+# include "avl_tree.hpp"
+# include "iterator.hpp"
+
+namespace ft
+{
+	///-------------///
+	/// VALUE ARENA ///
+	///-------------///
+
+	//Pool of T objects allocated by blocks of block_size, which recycles the slots of the destroyed objects.
+	//The objects are not tracked : they must all be destroyed before release() or the destruction of the arena.
+	template <class T, class Alloc = std::allocator<T> >
+	class value_arena
+	{
+		public:
+			static const std::size_t block_size = 64;
+
+			explicit value_arena(const Alloc& alloc = Alloc()) : _alloc(alloc), _blocks(NULL), _free(NULL), _used(block_size) {}
+
+			~value_arena()
+			{
+				release();
+			}
+
+			T * create(const T& value)
+			{
+				slot * s = _free;
+				if (s != NULL)
+					_free = s->next;
+				else
+				{
+					if (_used == block_size)
+						add_block();
+					s = &_blocks->slots[_used++];
+				}
+				T * p = reinterpret_cast<T *>(s->storage);
+				_alloc.construct(p, value);
+				return p;
+			}
+
+			void destroy(T * p)
+			{
+				_alloc.destroy(p);
+				slot * s = reinterpret_cast<slot *>(p);
+				s->next = _free;
+				_free = s;
+			}
+
+			//Frees all the blocks
+			void release()
+			{
+				typename Alloc::template rebind<block>::other a(_alloc);
+				while (_blocks != NULL)
+				{
+					block * next = _blocks->next;
+					a.deallocate(_blocks, 1);
+					_blocks = next;
+				}
+				_free = NULL;
+				_used = block_size;
+			}
+
+			void swap(value_arena& x)
+			{
+				std::swap(_alloc, x._alloc);
+				std::swap(_blocks, x._blocks);
+				std::swap(_free, x._free);
+				std::swap(_used, x._used);
+			}
+
+		private:
+			union slot
+			{
+				slot * next; //next free slot
+				char storage[sizeof(T)];
+				long double align_float;
+				unsigned long long align_integer;
+			};
+
+			struct block
+			{
+				block * next;
+				slot slots[block_size];
+			};
+
+			Alloc _alloc;
+			block * _blocks; //the first block is the one being filled
+			slot * _free;
+			std::size_t _used; //slots taken in the first block
+
+			value_arena(const value_arena&);
+			value_arena& operator=(const value_arena&);
+
+			void add_block()
+			{
+				typename Alloc::template rebind<block>::other a(_alloc);
+				block * b = a.allocate(1);
+				b->next = _blocks;
+				_blocks = b;
+				_used = 0;
+			}
+	};
+
+	///--------------------///
+	/// SPLIT MAP ITERATOR ///
+	///--------------------///
+
+	//Bidirectional iterator of split_map : walks the tree of keys and dereferences to the value in the arena
+	template <class TreeIterator, class Value>
+	class split_map_iterator
+	{
+		public:
+			typedef Value value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef ft::bidirectional_iterator_tag iterator_category;
+			typedef Value & reference;
+			typedef Value * pointer;
+
+			split_map_iterator() {}
+
+			explicit split_map_iterator(const TreeIterator& it) : _it(it) {}
+
+			reference operator*() const
+			{
+				return *(_it->second);
+			}
+
+			pointer operator->() const
+			{
+				return _it->second;
+			}
+
+			split_map_iterator& operator++()
+			{
+				++_it;
+				return *this;
+			}
+
+			split_map_iterator operator++(int)
+			{
+				split_map_iterator cpy(*this);
+				++_it;
+				return cpy;
+			}
+
+			split_map_iterator& operator--()
+			{
+				--_it;
+				return *this;
+			}
+
+			split_map_iterator operator--(int)
+			{
+				split_map_iterator cpy(*this);
+				--_it;
+				return cpy;
+			}
+
+			//Convert to constant iterator
+			template <class OtherIterator, class OtherValue>
+			operator split_map_iterator<OtherIterator, OtherValue> () const
+			{
+				return split_map_iterator<OtherIterator, OtherValue>(_it);
+			}
+
+			const TreeIterator& base() const
+			{
+				return _it;
+			}
+
+		private:
+			TreeIterator _it;
+	};
+
+	template <class L, class VL, class R, class VR>
+	bool operator==(const split_map_iterator<L, VL>& lhs, const split_map_iterator<R, VR>& rhs)
+	{
+		return lhs.base() == rhs.base();
+	}
+
+	template <class L, class VL, class R, class VR>
+	bool operator!=(const split_map_iterator<L, VL>& lhs, const split_map_iterator<R, VR>& rhs)
+	{
+		return lhs.base() != rhs.base();
+	}
+
+	///-----------///
+	/// SPLIT MAP ///
+	///-----------///
+
+	//Map for large mapped types : the tree nodes only hold the key, the links and a pointer to the element,
+	//which lives in a separate arena. Searches only bring the compact nodes to the cache, and the element
+	//is reached once found. The key is stored twice, in the node and in the element.
+	template < class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<ft::pair<const Key, T> > >
+	class split_map
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef Key key_type;
+			typedef T mapped_type;
+			typedef ft::pair<const key_type, mapped_type> value_type;
+			typedef Compare key_compare;
+			typedef Alloc allocator_type;
+			typedef std::size_t size_type;
+			typedef std::ptrdiff_t difference_type;
+
+		private:
+			typedef ft::pair<const key_type, value_type *> entry_type; //content of a tree node
+
+			class entry_compare
+			{
+				public:
+					typedef void is_three_way;
+					entry_compare(const Compare& c) : comp(c) {}
+					bool operator() (const entry_type& x, const entry_type& y) const
+					{
+						return comp(x.first, y.first);
+					}
+					int three_way (const entry_type& x, const entry_type& y) const
+					{
+						return key_three_way<key_type, Compare>::compare(comp, x.first, y.first);
+					}
+				private:
+					Compare comp;
+			};
+
+			typedef AVLTree<entry_type, entry_compare, Alloc> tree_type;
+			typedef typename tree_type::node_type node_type;
+			typedef ft::avl_tree_iterator<node_type, false> tree_iterator;
+			typedef ft::avl_tree_iterator<const node_type, true> const_tree_iterator;
+
+		public:
+			typedef split_map_iterator<tree_iterator, value_type> iterator;
+			typedef split_map_iterator<const_tree_iterator, const value_type> const_iterator;
+			typedef ft::reverse_iterator<iterator> reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			explicit split_map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+				: _comp(comp), _alloc(alloc), _tree(entry_compare(comp), alloc), _values(alloc) {}
+
+			template <class InputIterator>
+			split_map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+				: _comp(comp), _alloc(alloc), _tree(entry_compare(comp), alloc), _values(alloc)
+			{
+				insert(first, last);
+			}
+
+			split_map (const split_map& x) : _comp(x._comp), _alloc(x._alloc), _tree(entry_compare(x._comp), x._alloc), _values(x._alloc)
+			{
+				insert(x.begin(), x.end());
+			}
+
+			~split_map()
+			{
+				clear();
+			}
+
+			split_map& operator= (const split_map& x)
+			{
+				if (&x == this)
+					return (*this);
+				clear();
+				insert(x.begin(), x.end());
+				return *this;
+			}
+
+			/// ITERATORS ///
+
+			iterator begin()
+			{
+				if (_tree.root == NULL)
+					return end();
+				return iterator(tree_iterator(_tree.min_value_node(_tree.root), _tree.dummy_past_end));
+			}
+
+			const_iterator begin() const
+			{
+				if (_tree.root == NULL)
+					return end();
+				return const_iterator(const_tree_iterator(_tree.min_value_node(_tree.root), _tree.dummy_past_end));
+			}
+
+			iterator end()
+			{
+				return iterator(tree_iterator(_tree.dummy_past_end, _tree.dummy_past_end));
+			}
+
+			const_iterator end() const
+			{
+				return const_iterator(const_tree_iterator(_tree.dummy_past_end, _tree.dummy_past_end));
+			}
+
+			reverse_iterator rbegin()
+			{
+				return reverse_iterator(end());
+			}
+
+			const_reverse_iterator rbegin() const
+			{
+				return const_reverse_iterator(end());
+			}
+
+			reverse_iterator rend()
+			{
+				return reverse_iterator(begin());
+			}
+
+			const_reverse_iterator rend() const
+			{
+				return const_reverse_iterator(begin());
+			}
+
+			/// CAPACITY ///
+
+			bool empty() const
+			{
+				return _tree.tree_is_empty();
+			}
+
+			size_type size() const
+			{
+				return _tree.size(_tree.root);
+			}
+
+			size_type max_size() const
+			{
+				return _tree.max_size();
+			}
+
+			/// ELEMENT ACCESS ///
+
+			mapped_type& operator[] (const key_type& k)
+			{
+				node_type * node = find_node(k);
+				if (node != NULL)
+					return node->value.second->second;
+				return (*((insert(ft::make_pair(k, mapped_type()))).first)).second;
+			}
+
+			mapped_type& at (const key_type& k)
+			{
+				node_type * node = find_node(k);
+				if (node == NULL)
+					throw std::out_of_range("split_map::at");
+				return node->value.second->second;
+			}
+
+			const mapped_type& at (const key_type& k) const
+			{
+				node_type * node = find_node(k);
+				if (node == NULL)
+					throw std::out_of_range("split_map::at");
+				return node->value.second->second;
+			}
+
+			/// MODIFIERS ///
+
+			//The key is searched first : nothing is allocated nor copied when it is already present. The element is copied
+			//to the arena before its node is created and linked, so that a throwing copy leaves the map unchanged.
+			pair<iterator,bool> insert (const value_type& val)
+			{
+				node_type * parent;
+				bool left;
+				node_type * found = find_slot(val.first, &parent, &left);
+				if (found != NULL)
+					return ft::make_pair<iterator, bool>(iterator(tree_iterator(found, _tree.dummy_past_end)), false);
+				_tree.reserve_past_end();
+				value_type * value = _values.create(val);
+				node_type * node;
+				try
+				{
+					node = _tree.create_node(entry_type(val.first, value));
+				}
+				catch (...)
+				{
+					_values.destroy(value);
+					throw;
+				}
+				_tree.link_node(parent, left, node);
+				return ft::make_pair<iterator, bool>(iterator(tree_iterator(node, _tree.dummy_past_end)), true);
+			}
+
+			//The position hint is not used
+			iterator insert (iterator position, const value_type& val)
+			{
+				(void)position;
+				return insert(val).first;
+			}
+
+			template <class InputIterator>
+			void insert (InputIterator first, InputIterator last, typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0) //disable this overload if enable_if condition not statisfied
+			{
+				while (first != last)
+					insert(*(first++));
+			}
+
+			void erase (iterator position)
+			{
+				erase(position->first);
+			}
+
+			size_type erase (const key_type& k)
+			{
+				node_type * node = find_node(k);
+				if (node == NULL)
+					return 0;
+				_values.destroy(node->value.second);
+				_tree.root = _tree.delete_node(_tree.root, node->value);
+				_tree.update_past_end();
+				return 1;
+			}
+
+			void erase (iterator first, iterator last)
+			{
+				while (first != last)
+					erase(first++);
+			}
+
+			void swap (split_map& x)
+			{
+				_tree.swap(x._tree);
+				_values.swap(x._values);
+				std::swap(_comp, x._comp);
+				std::swap(_alloc, x._alloc);
+			}
+
+			void clear()
+			{
+				destroy_values(_tree.root);
+				_tree.clear(_tree.root);
+				_tree.root = NULL;
+				_tree.update_past_end();
+				_values.release();
+			}
+
+			/// OBSERVERS ///
+
+			key_compare key_comp() const
+			{
+				return _comp;
+			}
+
+			/// LOOKUP ///
+
+			iterator find (const key_type& k)
+			{
+				node_type * node = find_node(k);
+				if (node == NULL)
+					return end();
+				return iterator(tree_iterator(node, _tree.dummy_past_end));
+			}
+
+			const_iterator find (const key_type& k) const
+			{
+				node_type * node = find_node(k);
+				if (node == NULL)
+					return end();
+				return const_iterator(const_tree_iterator(node, _tree.dummy_past_end));
+			}
+
+			size_type count (const key_type& k) const
+			{
+				return find_node(k) != NULL ? 1 : 0;
+			}
+
+			iterator lower_bound (const key_type& k)
+			{
+				node_type * node = bound_node(k, false);
+				if (node == NULL)
+					return end();
+				return iterator(tree_iterator(node, _tree.dummy_past_end));
+			}
+
+			const_iterator lower_bound (const key_type& k) const
+			{
+				node_type * node = bound_node(k, false);
+				if (node == NULL)
+					return end();
+				return const_iterator(const_tree_iterator(node, _tree.dummy_past_end));
+			}
+
+			iterator upper_bound (const key_type& k)
+			{
+				node_type * node = bound_node(k, true);
+				if (node == NULL)
+					return end();
+				return iterator(tree_iterator(node, _tree.dummy_past_end));
+			}
+
+			const_iterator upper_bound (const key_type& k) const
+			{
+				node_type * node = bound_node(k, true);
+				if (node == NULL)
+					return end();
+				return const_iterator(const_tree_iterator(node, _tree.dummy_past_end));
+			}
+
+			pair<iterator,iterator> equal_range (const key_type& k)
+			{
+				return ft::make_pair(lower_bound(k), upper_bound(k));
+			}
+
+			pair<const_iterator,const_iterator> equal_range (const key_type& k) const
+			{
+				return ft::make_pair(lower_bound(k), upper_bound(k));
+			}
+
+			allocator_type get_allocator() const
+			{
+				return allocator_type(_alloc);
+			}
+
+		private:
+			key_compare _comp;
+			allocator_type _alloc;
+			tree_type _tree;
+			value_arena<value_type, Alloc> _values;
+
+			node_type * find_node(const key_type& k) const
+			{
+				node_type * parent;
+				bool left;
+				return find_slot(k, &parent, &left);
+			}
+
+			//Node of key k, or NULL if there is none. In the latter case, a node of key k is to be linked
+			//as the left (*left is true) or right child of *parent, or as the root if *parent is NULL.
+			node_type * find_slot(const key_type& k, node_type ** parent, bool * left) const
+			{
+				node_type * r = _tree.root;
+				*parent = NULL;
+				*left = false;
+				while (r != NULL)
+				{
+					int c = key_three_way<key_type, key_compare>::compare(_comp, k, r->value.first);
+					if (c == 0)
+						return r;
+					*parent = r;
+					*left = c < 0;
+					r = *left ? r->left : r->right;
+				}
+				return NULL;
+			}
+
+			//First node whose key is not less than k (greater than k if strict), NULL if there is none
+			node_type * bound_node(const key_type& k, bool strict) const
+			{
+				node_type * r = _tree.root;
+				node_type * bound = NULL;
+				while (r != NULL)
+				{
+					if (strict ? _comp(k, r->value.first) : !_comp(r->value.first, k))
+					{
+						bound = r;
+						r = r->left;
+					}
+					else
+						r = r->right;
+				}
+				return bound;
+			}
+
+			void destroy_values(node_type * r)
+			{
+				if (r == NULL)
+					return;
+				destroy_values(r->left);
+				destroy_values(r->right);
+				_values.destroy(r->value.second);
+			}
+	};
+
+	template < class Key, class T, class Compare, class Alloc >
+	bool operator==(const split_map<Key, T, Compare, Alloc>& lhs, const split_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template < class Key, class T, class Compare, class Alloc >
+	bool operator!=(const split_map<Key, T, Compare, Alloc>& lhs, const split_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template < class Key, class T, class Compare, class Alloc >
+	bool operator<(const split_map<Key, T, Compare, Alloc>& lhs, const split_map<Key, T, Compare, Alloc>& rhs)
+	{
+		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template < class Key, class T, class Compare, class Alloc >
+	void swap (split_map<Key, T, Compare, Alloc>& x, split_map<Key, T, Compare, Alloc>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
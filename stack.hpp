@@ -43,6 +43,18 @@ namespace ft
 				return (*this);
 			}
 
+# if FT_MOVE_SEMANTICS
+			//Move constructor
+			stack(stack&& s): c(std::move(s.c)) {}
+
+			//Move assignment operator
+			stack& operator=(stack&& s)
+			{
+				c = std::move(s.c);
+				return (*this);
+			}
+# endif
+
 			//Destructor
 			~stack() {}
 
@@ -76,6 +88,21 @@ namespace ft
 				c.push_back(val);
 			}
 
+# if FT_MOVE_SEMANTICS
+			//Insert element, moving it
+			void push (value_type&& val)
+			{
+				c.push_back(std::move(val));
+			}
+
+			//Insert element constructed in place from args
+			template <class... Args>
+			void emplace (Args&&... args)
+			{
+				c.emplace_back(std::forward<Args>(args)...);
+			}
+# endif
+
 			//Remove top element
 			void pop()
 			{
@@ -0,0 +1,553 @@
+#ifndef STATIC_VECTOR_HPP
+# define STATIC_VECTOR_HPP
+
+# include <memory>
+# include <new>
+# include <algorithm>
+# include <stdexcept>
+# include "utils.hpp"
+# include "iterator.hpp"
+# include "vector.hpp"
+
+namespace ft
+{
+	//Inline buffer of a static_vector and its number of elements. This version is for trivially copyable elements :
+	//it declares no copy nor destructor, so that a static_vector of them is trivially copyable itself.
+	template < class T, std::size_t Capacity, bool Trivial = ft::is_trivially_copyable<T>::value >
+	class static_vector_storage
+	{
+		protected:
+			std::size_t _size;
+			union
+			{
+				char bytes[Capacity * sizeof(T)];
+				void * align_pointer;
+				long double align_float;
+				unsigned long long align_integer;
+			} _storage;
+
+			static_vector_storage() : _size(0) {}
+
+			T * elements() const
+			{
+				return reinterpret_cast<T *>(const_cast<char *>(_storage.bytes));
+			}
+	};
+
+	//Version for the other elements, which are copied, moved and destroyed one by one
+	template < class T, std::size_t Capacity >
+	class static_vector_storage<T, Capacity, false> : public static_vector_storage<T, Capacity, true>
+	{
+		protected:
+			static_vector_storage() {}
+
+			static_vector_storage(const static_vector_storage& x)
+			{
+				copy(x);
+			}
+
+			static_vector_storage& operator= (const static_vector_storage& x)
+			{
+				if (&x != this)
+				{
+					clear();
+					copy(x);
+				}
+				return *this;
+			}
+
+# if FT_MOVE_SEMANTICS
+			static_vector_storage(static_vector_storage&& x)
+			{
+				take(x);
+			}
+
+			static_vector_storage& operator= (static_vector_storage&& x)
+			{
+				if (&x != this)
+				{
+					clear();
+					take(x);
+				}
+				return *this;
+			}
+# endif
+
+			~static_vector_storage()
+			{
+				clear();
+			}
+
+		private:
+			void clear()
+			{
+				std::allocator<T> alloc;
+				ft::destroy_elements(alloc, this->elements(), this->elements() + this->_size);
+				this->_size = 0;
+			}
+
+			void copy(const static_vector_storage& x)
+			{
+				std::allocator<T> alloc;
+				ft::copy_elements(alloc, this->elements(), x.elements(), x._size);
+				this->_size = x._size;
+			}
+
+			//Moves the elements of x, which is left empty
+			void take(static_vector_storage& x)
+			{
+				std::allocator<T> alloc;
+				ft::relocate_elements(alloc, this->elements(), x.elements(), x._size);
+				this->_size = x._size;
+				x._size = 0;
+			}
+	};
+
+	//Vector of at most Capacity elements, stored inside the object : it never allocates.
+	//It has the interface and the iterators of ft::vector, and can be the container of an ft::stack.
+	//Growing beyond Capacity throws std::length_error, except through the unchecked variants of push_back,
+	//for which the caller guarantees the room.
+	//It is trivially copyable when T is, so copying it copies the whole buffer with memcpy.
+	template < class T, std::size_t Capacity >
+	class static_vector : public static_vector_storage<T, Capacity>
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef T value_type;
+			typedef std::allocator<T> allocator_type; //only used to construct and destroy the elements
+			typedef value_type& reference;
+			typedef const value_type& const_reference;
+			typedef value_type * pointer;
+			typedef const value_type * const_pointer;
+			typedef ft::random_access_iterator<value_type> iterator;
+			typedef ft::random_access_iterator<const value_type> const_iterator;
+			typedef ft::reverse_iterator<iterator> reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+			typedef std::ptrdiff_t difference_type;
+			typedef std::size_t size_type;
+
+			static const size_type static_capacity = Capacity;
+
+		private:
+			typedef char capacity_must_not_be_zero[Capacity != 0 ? 1 : -1];
+
+		public:
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			//Copies, assignments and the destructor are those of the storage
+
+			static_vector() {}
+
+			explicit static_vector (size_type n, const value_type& val = value_type())
+			{
+				insert(end(), n, val);
+			}
+
+			template <class InputIterator>
+			static_vector (InputIterator first, InputIterator last,
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+			{
+				insert(end(), first, last);
+			}
+
+			/// ITERATORS ///
+
+			iterator begin()
+			{
+				return iterator(this->elements());
+			}
+
+			const_iterator begin() const
+			{
+				return const_iterator(this->elements());
+			}
+
+			iterator end()
+			{
+				return iterator(this->elements() + this->_size);
+			}
+
+			const_iterator end() const
+			{
+				return const_iterator(this->elements() + this->_size);
+			}
+
+			reverse_iterator rbegin()
+			{
+				return reverse_iterator(end());
+			}
+
+			const_reverse_iterator rbegin() const
+			{
+				return const_reverse_iterator(end());
+			}
+
+			reverse_iterator rend()
+			{
+				return reverse_iterator(begin());
+			}
+
+			const_reverse_iterator rend() const
+			{
+				return const_reverse_iterator(begin());
+			}
+
+			/// CAPACITY ///
+
+			size_type size() const
+			{
+				return this->_size;
+			}
+
+			size_type max_size() const
+			{
+				return Capacity;
+			}
+
+			size_type capacity() const
+			{
+				return Capacity;
+			}
+
+			bool empty() const
+			{
+				return this->_size == 0;
+			}
+
+			bool full() const
+			{
+				return this->_size == Capacity;
+			}
+
+			void resize (size_type n, value_type val = value_type())
+			{
+				if (n < this->_size)
+				{
+					allocator_type alloc;
+					ft::destroy_elements(alloc, this->elements() + n, this->elements() + this->_size);
+					this->_size = n;
+				}
+				else if (n > this->_size)
+					insert(end(), n - this->_size, val);
+			}
+
+			//Does nothing, but throws std::length_error when n is more than Capacity
+			void reserve (size_type n)
+			{
+				if (n > Capacity)
+					throw std::length_error("static_vector::reserve");
+			}
+
+			/// ELEMENT ACCESS ///
+
+			reference operator[] (size_type n)
+			{
+				return this->elements()[n];
+			}
+
+			const_reference operator[] (size_type n) const
+			{
+				return this->elements()[n];
+			}
+
+			reference at (size_type n)
+			{
+				if (n >= this->_size)
+					throw std::out_of_range("static_vector::at index out of range");
+				return this->elements()[n];
+			}
+
+			const_reference at (size_type n) const
+			{
+				if (n >= this->_size)
+					throw std::out_of_range("static_vector::at index out of range");
+				return this->elements()[n];
+			}
+
+			reference front()
+			{
+				return *this->elements();
+			}
+
+			const_reference front() const
+			{
+				return *this->elements();
+			}
+
+			reference back()
+			{
+				return this->elements()[this->_size - 1];
+			}
+
+			const_reference back() const
+			{
+				return this->elements()[this->_size - 1];
+			}
+
+			/// MODIFIERS ///
+
+			template <class InputIterator>
+			void assign (InputIterator first, InputIterator last,
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+			{
+				clear();
+				insert(end(), first, last);
+			}
+
+			void assign (size_type n, const value_type& val)
+			{
+				const value_type copy(val); //val may be an element, which clear() is going to destroy
+				clear();
+				insert(end(), n, copy);
+			}
+
+			void push_back (const value_type& val)
+			{
+				if (full())
+					throw std::length_error("static_vector::push_back");
+				push_back_unchecked(val);
+			}
+
+			//push_back without the capacity check : the vector must not be full
+			void push_back_unchecked (const value_type& val)
+			{
+				::new (static_cast<void *>(this->elements() + this->_size)) value_type(val);
+				this->_size++;
+			}
+
+# if FT_MOVE_SEMANTICS
+			void push_back (value_type&& val)
+			{
+				emplace_back(std::move(val));
+			}
+
+			void push_back_unchecked (value_type&& val)
+			{
+				emplace_back_unchecked(std::move(val));
+			}
+
+			template <class... Args>
+			void emplace_back (Args&&... args)
+			{
+				if (full())
+					throw std::length_error("static_vector::emplace_back");
+				emplace_back_unchecked(std::forward<Args>(args)...);
+			}
+
+			//emplace_back without the capacity check : the vector must not be full
+			template <class... Args>
+			void emplace_back_unchecked (Args&&... args)
+			{
+				::new (static_cast<void *>(this->elements() + this->_size)) value_type(std::forward<Args>(args)...);
+				this->_size++;
+			}
+
+			template <class... Args>
+			iterator emplace (const_iterator position, Args&&... args)
+			{
+				size_type insert_index = static_cast<size_type>(position - const_iterator(this->elements()));
+				if (insert_index > this->_size)
+					throw std::length_error("static_vector::emplace");
+				value_type element(std::forward<Args>(args)...); //args may refer to elements which are going to move
+				open_gap(insert_index, 1);
+				try
+				{
+					::new (static_cast<void *>(this->elements() + insert_index)) value_type(std::move(element));
+				}
+				catch (...)
+				{
+					close_gap(insert_index, 1, 0);
+					throw;
+				}
+				this->_size++;
+				return iterator(this->elements() + insert_index);
+			}
+
+			iterator insert (iterator position, value_type&& val)
+			{
+				return emplace(position, std::move(val));
+			}
+# endif
+
+			void pop_back()
+			{
+				this->elements()[this->_size - 1].~value_type();
+				this->_size--;
+			}
+
+			iterator insert (iterator position, const value_type& val)
+			{
+				size_type insert_index = static_cast<size_type>(position - begin());
+				insert(position, 1, val);
+				return iterator(this->elements() + insert_index);
+			}
+
+			void insert (iterator position, size_type n, const value_type& val)
+			{
+				if (position < begin() || position > end())
+					throw std::length_error("static_vector::insert");
+
+				size_type insert_index = static_cast<size_type>(position - begin());
+				const value_type copy(val); //val may be an element which is going to move
+				open_gap(insert_index, n);
+				size_type i = insert_index;
+				try
+				{
+					for (; i < insert_index + n; i++)
+						::new (static_cast<void *>(this->elements() + i)) value_type(copy);
+				}
+				catch (...)
+				{
+					close_gap(insert_index, n, i - insert_index);
+					throw;
+				}
+				this->_size += n;
+			}
+
+			template <class InputIterator>
+			void insert (iterator position, InputIterator first, InputIterator last,
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+			{
+				difference_type diff = std::distance(first, last);
+				if (diff < 0 || position < begin() || position > end())
+					throw std::length_error("static_vector::insert");
+
+				size_type n = static_cast<size_type>(diff);
+				size_type insert_index = static_cast<size_type>(position - begin());
+				open_gap(insert_index, n);
+				size_type i = insert_index;
+				try
+				{
+					for (; i < insert_index + n; i++, first++)
+						::new (static_cast<void *>(this->elements() + i)) value_type(*first);
+				}
+				catch (...)
+				{
+					close_gap(insert_index, n, i - insert_index);
+					throw;
+				}
+				this->_size += n;
+			}
+
+			iterator erase (iterator position)
+			{
+				return erase(position, position + 1);
+			}
+
+			iterator erase (iterator first, iterator last)
+			{
+				allocator_type alloc;
+				pointer elements = this->elements();
+				size_type n = static_cast<size_type>(last - first);
+				size_type erase_index = static_cast<size_type>(first - begin());
+				ft::destroy_elements(alloc, elements + erase_index, elements + erase_index + n);
+				ft::relocate_elements(alloc, elements + erase_index, elements + erase_index + n, this->_size - erase_index - n);
+				this->_size -= n;
+				return iterator(elements + erase_index);
+			}
+
+			//Swaps the common elements, and moves the remaining ones of the longer vector
+			void swap (static_vector& x)
+			{
+				static_vector& shorter = this->_size < x._size ? *this : x;
+				static_vector& longer = this->_size < x._size ? x : *this;
+				for (size_type i = 0; i < shorter._size; i++)
+					std::swap(shorter[i], longer[i]);
+				allocator_type alloc;
+				ft::relocate_elements(alloc, shorter.elements() + shorter._size, longer.elements() + shorter._size, longer._size - shorter._size);
+				std::swap(this->_size, x._size);
+			}
+
+			void clear()
+			{
+				allocator_type alloc;
+				ft::destroy_elements(alloc, this->elements(), this->elements() + this->_size);
+				this->_size = 0;
+			}
+
+			allocator_type get_allocator() const
+			{
+				return allocator_type();
+			}
+
+		private:
+			//Makes room for n elements at index, moving the elements after it. The n elements are left uninitialized,
+			//and the caller adds them to the size once they are all constructed.
+			void open_gap(size_type index, size_type n)
+			{
+				if (n > Capacity - this->_size)
+					throw std::length_error("static_vector::insert");
+				allocator_type alloc;
+				ft::relocate_elements(alloc, this->elements() + index + n, this->elements() + index, this->_size - index);
+			}
+
+			//Undoes open_gap(index, n) after the construction of an element threw : destroys the first built elements
+			//of the gap, and moves the elements after the gap back to index
+			void close_gap(size_type index, size_type n, size_type built)
+			{
+				allocator_type alloc;
+				ft::destroy_elements(alloc, this->elements() + index, this->elements() + index + built);
+				ft::relocate_elements(alloc, this->elements() + index, this->elements() + index + n, this->_size - index);
+			}
+	};
+
+	template < class T, std::size_t Capacity >
+	const std::size_t static_vector<T, Capacity>::static_capacity;
+
+	//The elements are inside the object : it can be moved by copying its bytes when they can
+	template < class T, std::size_t Capacity >
+	struct is_trivially_relocatable<static_vector<T, Capacity> > : public ft::integral_constant<bool, ft::is_trivially_relocatable<T>::value> {};
+
+	///-------------------------------///
+	/// NON-MEMBER FUNCTION OVERLOADS ///
+	///-------------------------------///
+
+	template < class T, std::size_t Capacity >
+	bool operator== (const static_vector<T, Capacity>& lhs, const static_vector<T, Capacity>& rhs)
+	{
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+	template < class T, std::size_t Capacity >
+	bool operator!= (const static_vector<T, Capacity>& lhs, const static_vector<T, Capacity>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template < class T, std::size_t Capacity >
+	bool operator<  (const static_vector<T, Capacity>& lhs, const static_vector<T, Capacity>& rhs)
+	{
+		return ft::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+
+	template < class T, std::size_t Capacity >
+	bool operator<= (const static_vector<T, Capacity>& lhs, const static_vector<T, Capacity>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template < class T, std::size_t Capacity >
+	bool operator>  (const static_vector<T, Capacity>& lhs, const static_vector<T, Capacity>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template < class T, std::size_t Capacity >
+	bool operator>= (const static_vector<T, Capacity>& lhs, const static_vector<T, Capacity>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	template < class T, std::size_t Capacity >
+	void swap (static_vector<T, Capacity>& x, static_vector<T, Capacity>& y)
+	{
+		x.swap(y);
+	}
+}
+
+#endif
@@ -13,6 +13,23 @@
 #ifndef UTILS_HPP
 # define UTILS_HPP
 
+# include <string>
+# include <functional>
+# include <cstddef>
+# include "simd.hpp"
+
+//C++11 and later builds (make STD=c++11) get move semantics and emplacement.
+//FT_MOVE(x) moves x when they are available, and copies it otherwise.
+# if __cplusplus >= 201103L
+#  include <utility>
+#  include <type_traits>
+#  define FT_MOVE_SEMANTICS 1
+#  define FT_MOVE(x) std::move(x)
+# else
+#  define FT_MOVE_SEMANTICS 0
+#  define FT_MOVE(x) (x)
+# endif
+
 namespace ft
 {
 	/// ENABLE_IF ///
@@ -78,24 +95,354 @@ namespace ft
 	template <>
 	struct is_integral<unsigned long long> : public ft::integral_constant<bool, true> {};
 
+	/// IS_ARITHMETIC ///
+
+	//Integral and floating point types
+	template <typename T>
+	struct is_arithmetic : public ft::integral_constant<bool, ft::is_integral<T>::value> {};
+
+	template <>
+	struct is_arithmetic<float> : public ft::integral_constant<bool, true> {};
+
+	template <>
+	struct is_arithmetic<double> : public ft::integral_constant<bool, true> {};
+
+	template <>
+	struct is_arithmetic<long double> : public ft::integral_constant<bool, true> {};
+
+	/// TRIVIALITY ///
+
+	//Whether copying a T amounts to copying its bytes, as the compiler reports it
+	template <typename T>
+	struct is_trivially_copyable : public ft::integral_constant<bool, __is_trivially_copyable(T)> {};
+
+	//Whether destroying a T does nothing
+	template <typename T>
+	struct is_trivially_destructible : public ft::integral_constant<bool, __has_trivial_destructor(T)> {};
+
+	//Whether a T can be moved to another address by copying its bytes and forgetting the original one, instead of
+	//copy constructing it there and destroying the original. Trivially copyable types are; other types may opt in
+	//with a specialization when they hold no pointer to themselves. The std::string of libstdc++ points to its own
+	//inline buffer, so it must not.
+	template <typename T>
+	struct is_trivially_relocatable : public ft::integral_constant<bool, ft::is_trivially_copyable<T>::value> {};
+
+	/// THREE-WAY COMPARISON ///
+
+	//Three-way comparison deduced from a strict weak ordering, at the cost of two calls to comp
+	template <class Key, class Compare>
+	struct two_calls_three_way
+	{
+		static int compare(const Compare& comp, const Key& a, const Key& b)
+		{
+			if (comp(a, b))
+				return -1;
+			return comp(b, a) ? 1 : 0;
+		}
+	};
+
+	//Three-way comparison of two keys ordered by comp : negative if a goes before b, positive if a goes after b, 0 if they are equivalent.
+	//The default implementation calls comp twice. It can be specialized for a comparator which gets the three results at the cost of one comparison.
+	template <class Key, class Compare>
+	struct key_three_way : public two_calls_three_way<Key, Compare> {};
+
+	//std::less and std::greater on arithmetic types compare the values directly, without branches
+	template <class Key, bool is_arithmetic>
+	struct arithmetic_three_way : public two_calls_three_way<Key, std::less<Key> > {};
+
+	template <class Key>
+	struct arithmetic_three_way<Key, true>
+	{
+		static int compare(const std::less<Key>&, const Key& a, const Key& b)
+		{
+			return (b < a) - (a < b);
+		}
+	};
+
+	template <class Key>
+	struct key_three_way<Key, std::less<Key> > : public arithmetic_three_way<Key, ft::is_arithmetic<Key>::value> {};
+
+	template <class Key>
+	struct key_three_way<Key, std::greater<Key> >
+	{
+		static int compare(const std::greater<Key>&, const Key& a, const Key& b)
+		{
+			return key_three_way<Key, std::less<Key> >::compare(std::less<Key>(), b, a);
+		}
+	};
+
+	//std::string::compare already is a three-way comparison, consistent with operator<
+	template <>
+	struct key_three_way<std::string, std::less<std::string> >
+	{
+		static int compare(const std::less<std::string>&, const std::string& a, const std::string& b)
+		{
+			return a.compare(b);
+		}
+	};
+
+	//Detects a comparator declaring the typedef is_three_way, which provides int three_way(a, b) const
+	template <class Compare>
+	struct has_three_way
+	{
+		template <class U>
+		static char test(typename U::is_three_way *);
+		template <class U>
+		static long test(...);
+
+		static const bool value = sizeof(test<Compare>(0)) == sizeof(char);
+	};
+
+	//Three-way comparison with comp, through its three_way member if it has one, or by calling it twice otherwise
+	template <class T, class Compare, bool = has_three_way<Compare>::value>
+	struct three_way
+	{
+		static int compare(const Compare& comp, const T& a, const T& b)
+		{
+			return key_three_way<T, Compare>::compare(comp, a, b);
+		}
+	};
+
+	template <class T, class Compare>
+	struct three_way<T, Compare, true>
+	{
+		static int compare(const Compare& comp, const T& a, const T& b)
+		{
+			return comp.three_way(a, b);
+		}
+	};
+
+
+	/// CONTIGUOUS RANGES ///
+
+	template <typename T>
+	class random_access_iterator;
+
+	//Iterators over elements contiguous in memory : pointers and the iterators of the vectors.
+	//address gives the element an iterator points to, even a past-the-end one.
+	template <class Iterator>
+	struct contiguous_iterator : public ft::integral_constant<bool, false>
+	{
+		typedef void element_type;
+	};
+
+	template <class T>
+	struct contiguous_iterator<T *> : public ft::integral_constant<bool, true>
+	{
+		typedef T element_type;
+		static const T * address(T * it) { return it; }
+	};
+
+	template <class T>
+	struct contiguous_iterator<const T *> : public ft::integral_constant<bool, true>
+	{
+		typedef T element_type;
+		static const T * address(const T * it) { return it; }
+	};
+
+	template <class T>
+	struct contiguous_iterator<ft::random_access_iterator<T> > : public ft::integral_constant<bool, true>
+	{
+		typedef T element_type;
+		static const T * address(const ft::random_access_iterator<T>& it) { return it.operator->(); }
+	};
+
+	template <class T>
+	struct contiguous_iterator<ft::random_access_iterator<const T> > : public ft::integral_constant<bool, true>
+	{
+		typedef T element_type;
+		static const T * address(const ft::random_access_iterator<const T>& it) { return it.operator->(); }
+	};
+
+	template <class T, class U>
+	struct is_same : public ft::integral_constant<bool, false> {};
+
+	template <class T>
+	struct is_same<T, T> : public ft::integral_constant<bool, true> {};
+
+	//Whether the algorithms on a range of Iterator use the kernels of simd.hpp : integers other than bool,
+	//whose equality and order are those of their bytes. Floating point ranges keep the scalar loops,
+	//which give NaN, -0.0 and the rounding of sums their exact meaning.
+	template <class Iterator, class Element = typename ft::contiguous_iterator<Iterator>::element_type>
+	struct vectorizable : public ft::integral_constant<bool, ft::contiguous_iterator<Iterator>::value
+		&& ft::is_integral<Element>::value && !ft::is_same<Element, bool>::value> {};
+
+	//Same for two ranges compared with each other, which must hold the same type
+	template <class Iterator1, class Iterator2>
+	struct vectorizable_pair : public ft::integral_constant<bool, ft::vectorizable<Iterator1>::value
+		&& ft::is_same<typename ft::contiguous_iterator<Iterator1>::element_type, typename ft::contiguous_iterator<Iterator2>::element_type>::value> {};
+
+	//Comparisons of two ranges, element by element
+	template <class InputIterator1, class InputIterator2, bool Vectorized = ft::vectorizable_pair<InputIterator1, InputIterator2>::value>
+	struct range_comparison
+	{
+		static bool equal (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2)
+		{
+			while (first1 != last1) 
+			{
+				if (!(*first1 == *first2)) 
+					return false;
+				++first1;
+				++first2;
+			}
+			return true;
+		}
+
+		static bool lexicographical_compare (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2)
+		{
+			while (first1 != last1)
+			{
+				if (first2 == last2 || *first2 < *first1)
+					return false;
+				else if (*first1 < *first2)
+					return true;
+				++first1;
+				++first2;
+			}
+			return (first2 != last2);
+		}
+	};
+
+	//Comparisons of contiguous integers, by the kernels
+	template <class InputIterator1, class InputIterator2>
+	struct range_comparison<InputIterator1, InputIterator2, true>
+	{
+		typedef typename ft::contiguous_iterator<InputIterator1>::element_type element_type;
+		typedef ft::contiguous_iterator<InputIterator1> iterator1;
+		typedef ft::contiguous_iterator<InputIterator2> iterator2;
+
+		static bool equal (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2)
+		{
+			return ft::simd_kernels<element_type>::equal(iterator1::address(first1), iterator2::address(first2),
+				static_cast<std::size_t>(last1 - first1));
+		}
+
+		static bool lexicographical_compare (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2)
+		{
+			std::size_t n1 = static_cast<std::size_t>(last1 - first1);
+			std::size_t n2 = static_cast<std::size_t>(last2 - first2);
+			std::size_t n = n1 < n2 ? n1 : n2;
+			const element_type * a = iterator1::address(first1);
+			const element_type * b = iterator2::address(first2);
+			std::size_t i = ft::simd_kernels<element_type>::mismatch(a, b, n);
+			return i < n ? a[i] < b[i] : n1 < n2;
+		}
+	};
+
+	//Searches and reductions of a range
+	template <class InputIterator, bool Vectorized = ft::vectorizable<InputIterator>::value>
+	struct range_search
+	{
+		template <class T>
+		static InputIterator find (InputIterator first, InputIterator last, const T& val)
+		{
+			for (; first != last; ++first)
+				if (*first == val)
+					break;
+			return first;
+		}
+
+		template <class T>
+		static std::size_t count (InputIterator first, InputIterator last, const T& val)
+		{
+			std::size_t n = 0;
+			for (; first != last; ++first)
+				if (*first == val)
+					n++;
+			return n;
+		}
+
+		static InputIterator min_element (InputIterator first, InputIterator last)
+		{
+			InputIterator smallest = first;
+			if (first == last)
+				return last;
+			while (++first != last)
+				if (*first < *smallest)
+					smallest = first;
+			return smallest;
+		}
+
+		static InputIterator max_element (InputIterator first, InputIterator last)
+		{
+			InputIterator largest = first;
+			if (first == last)
+				return last;
+			while (++first != last)
+				if (*largest < *first)
+					largest = first;
+			return largest;
+		}
+
+		template <class T>
+		static T accumulate (InputIterator first, InputIterator last, T init)
+		{
+			for (; first != last; ++first)
+				init = init + *first;
+			return init;
+		}
+	};
+
+	//Searches and reductions of contiguous integers : the kernels take the values of the element type,
+	//the other ones (find(chars, 300), accumulate(chars, 0L)...) keep the generic loops
+	template <class InputIterator>
+	struct range_search<InputIterator, true> : public range_search<InputIterator, false>
+	{
+		typedef range_search<InputIterator, false> generic;
+		typedef typename ft::contiguous_iterator<InputIterator>::element_type element_type;
+		typedef ft::contiguous_iterator<InputIterator> iterator;
+		typedef ft::simd_kernels<element_type> kernels;
+
+		using generic::find;
+		using generic::count;
+		using generic::accumulate;
+
+		static InputIterator find (InputIterator first, InputIterator last, const element_type& val)
+		{
+			const element_type * start = iterator::address(first);
+			return first + (kernels::find(start, start + (last - first), val) - start);
+		}
+
+		static std::size_t count (InputIterator first, InputIterator last, const element_type& val)
+		{
+			const element_type * start = iterator::address(first);
+			return kernels::count(start, start + (last - first), val);
+		}
+
+		static InputIterator min_element (InputIterator first, InputIterator last)
+		{
+			if (first == last)
+				return last;
+			const element_type * start = iterator::address(first);
+			const element_type * end = start + (last - first);
+			return first + (kernels::find(start, end, kernels::min(start, end)) - start);
+		}
+
+		static InputIterator max_element (InputIterator first, InputIterator last)
+		{
+			if (first == last)
+				return last;
+			const element_type * start = iterator::address(first);
+			const element_type * end = start + (last - first);
+			return first + (kernels::find(start, end, kernels::max(start, end)) - start);
+		}
+
+		static element_type accumulate (InputIterator first, InputIterator last, element_type init)
+		{
+			const element_type * start = iterator::address(first);
+			return kernels::sum(start, start + (last - first), init);
+		}
+	};
 
 	/// LEXICOGRAPHICAL_COMPARE ///
 
 	//Default implementation
 	//Returns true if the range [first1,last1) compares lexicographically less than the range [first2,last2).
+	//Contiguous integers are compared by the kernels of simd.hpp.
 	template <class InputIterator1, class InputIterator2>
   	bool lexicographical_compare (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator2 last2)
 	{
-		while (first1 != last1)
-		{
-			if (first2 == last2 || *first2 < *first1)
-				return false;
-			else if (*first1 < *first2)
-				return true;
-			++first1;
-			++first2;
-		}
-		return (first2 != last2);
+		return ft::range_comparison<InputIterator1, InputIterator2>::lexicographical_compare(first1, last1, first2, last2);
 	}
 
 	//Custom implementation : the comparison operator used is the comp function instead of <
@@ -120,17 +467,11 @@ namespace ft
 	//Equality implementation
 	//Compares the elements in the range [first1,last1) with those in the range beginning at first2,
 	//and returns true if all of the elements in both ranges match.
+	//Contiguous integers are compared by the kernels of simd.hpp.
 	template <class InputIterator1, class InputIterator2>
   	bool equal ( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2 )
 	{
-		while (first1 != last1) 
-		{
-			if (!(*first1 == *first2)) 
-				return false;
-			++first1;
-			++first2;
-		}
-		return true;
+		return ft::range_comparison<InputIterator1, InputIterator2>::equal(first1, last1, first2);
 	}
 
 	//Predicate implementation : the elements are compared using the pred function instead of the == operator
@@ -149,6 +490,41 @@ namespace ft
 		return true;
 	}
 
+	/// FIND, COUNT, MIN_ELEMENT, MAX_ELEMENT, ACCUMULATE ///
+
+	//As their std counterparts. The ranges of contiguous integers are processed by the kernels of simd.hpp
+	//when val or init has the element type.
+
+	template <class InputIterator, class T>
+	InputIterator find (InputIterator first, InputIterator last, const T& val)
+	{
+		return ft::range_search<InputIterator>::find(first, last, val);
+	}
+
+	template <class InputIterator, class T>
+	std::size_t count (InputIterator first, InputIterator last, const T& val)
+	{
+		return ft::range_search<InputIterator>::count(first, last, val);
+	}
+
+	template <class ForwardIterator>
+	ForwardIterator min_element (ForwardIterator first, ForwardIterator last)
+	{
+		return ft::range_search<ForwardIterator>::min_element(first, last);
+	}
+
+	template <class ForwardIterator>
+	ForwardIterator max_element (ForwardIterator first, ForwardIterator last)
+	{
+		return ft::range_search<ForwardIterator>::max_element(first, last);
+	}
+
+	template <class InputIterator, class T>
+	T accumulate (InputIterator first, InputIterator last, T init)
+	{
+		return ft::range_search<InputIterator>::accumulate(first, last, init);
+	}
+
 	/// PAIR ///
 
 	template <class T1, class T2>
@@ -180,15 +556,36 @@ namespace ft
 		//Initialization constructor
 		pair (const first_type& a, const second_type& b) : first(a), second(b) {}
 
+# if FT_MOVE_SEMANTICS
+		//Move constructors : the members are moved, except const ones which are copied
+		pair (pair&& pr) : first(std::forward<T1>(pr.first)), second(std::forward<T2>(pr.second)) {}
+
+		template<class U, class V>
+		pair (pair<U,V>&& pr) : first(std::forward<U>(pr.first)), second(std::forward<V>(pr.second)) {}
+
+		//Initialization constructor forwarding its arguments to the members (NULL still goes to the one above)
+		template<class U, class V, class = typename ft::enable_if<std::is_convertible<U, T1>::value && std::is_convertible<V, T2>::value>::type>
+		pair (U&& a, V&& b) : first(std::forward<U>(a)), second(std::forward<V>(b)) {}
+# endif
+
 		//Assignment operator overload
 		pair& operator= (const pair& pr)
 		{
-			if (*this == pr)
+			if (this == &pr)
 				return (*this);
 			first = pr.first;
 			second = pr.second;
 			return *this;
 		}
+
+# if FT_MOVE_SEMANTICS
+		pair& operator= (pair&& pr)
+		{
+			first = std::forward<T1>(pr.first);
+			second = std::forward<T2>(pr.second);
+			return *this;
+		}
+# endif
 	};
 
 	// RELATIONAL OPERATORS 
@@ -233,7 +630,7 @@ namespace ft
 	pair<T1,T2> make_pair (T1 x, T2 y)
 	{
 		
-		return pair<T1,T2>(x,y);
+		return pair<T1,T2>(FT_MOVE(x), FT_MOVE(y));
   	}
 
 	//Choose template mechanism to choose between const and non-const version of a typedef
@@ -251,6 +648,18 @@ namespace ft
 	{
 		typedef IsFalse type;
 	};
+
+	/// PREFETCH ///
+
+	//Asks the processor to start loading the cache line at p, which is going to be read soon
+	inline void prefetch(const void * p)
+	{
+# ifdef __GNUC__
+		__builtin_prefetch(p);
+# else
+		(void)p;
+# endif
+	}
 	
 }
 
@@ -14,13 +14,154 @@
 # define VECTOR_HPP
 
 # include <memory>
+# include <new>
 # include <stdexcept>
+# include <cstring>
 # include "iterator.hpp"
 # include "utils.hpp"
 
 namespace ft
 {
-	template < class T, class Alloc = std::allocator<T> >
+	///-----------------///
+	/// ELEMENT STORAGE ///
+	///-----------------///
+
+	//Management of the elements of the vectors (ft::vector, ft::small_vector) in raw storage, through their allocator
+
+	//Destroys the elements of [first, last), unless their destructor does nothing
+	template <class Alloc>
+	void destroy_elements(Alloc& alloc, typename Alloc::pointer first, typename Alloc::pointer last)
+	{
+		if (ft::is_trivially_destructible<typename Alloc::value_type>::value)
+			return;
+		for (; first != last; ++first)
+			alloc.destroy(first);
+	}
+
+	//Copy constructs n elements from src into the uninitialized memory at dst, with memcpy when it is the same
+	template <class Alloc>
+	void copy_elements(Alloc& alloc, typename Alloc::pointer dst, typename Alloc::const_pointer src, std::size_t n)
+	{
+		typedef typename Alloc::value_type value_type;
+		if (ft::is_trivially_copyable<value_type>::value)
+		{
+			if (n != 0)
+				std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(value_type));
+			return;
+		}
+		for (std::size_t i = 0; i < n; i++)
+			alloc.construct(dst + i, src[i]);
+	}
+
+	//Moves n elements from src to the uninitialized memory at dst, leaving src uninitialized. The ranges may overlap.
+	//Relocatable elements are moved with memmove, the others are moved (copied before C++11) then destroyed one at a time,
+	//in the direction which does not overwrite the elements left to move.
+	template <class Alloc>
+	void relocate_elements(Alloc& alloc, typename Alloc::pointer dst, typename Alloc::pointer src, std::size_t n)
+	{
+		typedef typename Alloc::value_type value_type;
+		if (n == 0 || dst == src)
+			return;
+		if (ft::is_trivially_relocatable<value_type>::value)
+			std::memmove(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(value_type));
+		else if (dst < src)
+		{
+			for (std::size_t i = 0; i < n; i++)
+			{
+				alloc.construct(dst + i, FT_MOVE(src[i]));
+				alloc.destroy(src + i);
+			}
+		}
+		else
+		{
+			for (std::size_t i = n; i-- > 0; )
+			{
+				alloc.construct(dst + i, FT_MOVE(src[i]));
+				alloc.destroy(src + i);
+			}
+		}
+	}
+
+	///------------------///
+	/// BLOCK ALLOCATION ///
+	///------------------///
+
+	//How a vector obtains and grows its blocks. By default, it asks its allocator for exactly the capacity it wants,
+	//and grows a block by allocating another one and relocating the elements. Allocators which know the real size of
+	//the blocks they serve, or which can grow a block without copying it, specialize this struct (see mmap_allocator.hpp).
+	//The vector deallocates a block with the capacity these functions gave it.
+	template <class Alloc>
+	struct allocation_traits
+	{
+		typedef typename Alloc::pointer pointer;
+
+		static const bool can_reallocate = false;
+
+		//Allocates a block of at least n elements, and sets n to the number of elements it holds
+		static pointer allocate_at_least(Alloc& alloc, std::size_t& n)
+		{
+			return alloc.allocate(n);
+		}
+
+		//Grows the block p of capacity elements to at least n elements (n > capacity), keeping its bytes, and sets n to
+		//the number of elements it holds. Only called when can_reallocate is true, on relocatable elements.
+		static pointer reallocate(Alloc&, pointer p, std::size_t, std::size_t&)
+		{
+			return p;
+		}
+	};
+
+	template <class Alloc>
+	const bool allocation_traits<Alloc>::can_reallocate;
+
+	///-----------------///
+	/// GROWTH POLICIES ///
+	///-----------------///
+
+	//The growth policy of a vector chooses the capacity to allocate when required elements do not fit in the
+	//current capacity. The result must be at least required and at most max (required <= max).
+
+	//Doubles the capacity
+	struct grow_double
+	{
+		static std::size_t next_capacity (std::size_t capacity, std::size_t required, std::size_t max, std::size_t)
+		{
+			std::size_t grown = capacity > max / 2 ? max : capacity * 2;
+			return grown > required ? grown : required;
+		}
+	};
+
+	//Grows the capacity by half : more reallocations than grow_double, but less unused memory, and the blocks
+	//freed by successive reallocations can eventually be reused for a larger one
+	struct grow_one_and_half
+	{
+		static std::size_t next_capacity (std::size_t capacity, std::size_t required, std::size_t max, std::size_t)
+		{
+			std::size_t grown = capacity > max - capacity / 2 ? max : capacity + capacity / 2;
+			return grown > required ? grown : required;
+		}
+	};
+
+	//Grows the capacity by half, then rounds the block up to the size class the allocator will serve it from.
+	//Allocators like jemalloc or tcmalloc space their classes by a quarter of a power of two (16 bytes for
+	//the smallest), and the end of the class would be wasted otherwise.
+	struct grow_size_class
+	{
+		static std::size_t next_capacity (std::size_t capacity, std::size_t required, std::size_t max, std::size_t element_size)
+		{
+			std::size_t wanted = grow_one_and_half::next_capacity(capacity, required, max, element_size);
+			std::size_t bytes = wanted * element_size;
+			std::size_t spacing = 16;
+			while (spacing * 8 < bytes)
+				spacing *= 2;
+			std::size_t rounded = (bytes + spacing - 1) & ~(spacing - 1);
+			if (rounded < bytes || rounded / element_size > max)
+				return wanted;
+			return rounded / element_size;
+		}
+	};
+
+	template < class T, class Alloc = std::allocator<T>, class Growth = ft::grow_double >
 	class vector
 	{
 		public:
@@ -29,6 +170,7 @@ namespace ft
 			///---------------///
 			typedef T value_type;
 			typedef Alloc allocator_type;
+			typedef Growth growth_policy;
 			typedef typename allocator_type::reference reference;
 			typedef typename allocator_type::const_reference const_reference;
 			typedef typename allocator_type::pointer pointer;
@@ -55,7 +197,7 @@ namespace ft
 				_size = n;
 				_capacity = n;
 				_alloc = alloc;
-				_start = _alloc.allocate(n); //allocates a block of storage with a size large enough to contain n elements of type value_type
+				_start = n != 0 ? _alloc.allocate(n) : 0; //allocates a block of storage with a size large enough to contain n elements of type value_type
 				for (size_type i = 0; i < n; i++)
 					_alloc.construct(_start + i, val); //constructs (by calling the constructor of value_type with argument val) an element object on the location pointed by _start + i
 			}
@@ -72,7 +214,7 @@ namespace ft
 				_size = static_cast<size_type>(diff);
 				_alloc = alloc;
 				_capacity = _size;
-				_start = _alloc.allocate(_size); //allocates a block of storage with a size large enough to contain _size elements of type value_type
+				_start = _size != 0 ? _alloc.allocate(_size) : 0; //allocates a block of storage with a size large enough to contain _size elements of type value_type
 				for (size_type i = 0; i < _size; i++, first++)
 					_alloc.construct(_start + i, *first); //constructs (by calling the constructor of value_type with the corresponding range element as argument) an element object on the location pointed by _start + i
 			}
@@ -82,6 +224,7 @@ namespace ft
 			//The copy constructor creates a container that keeps and uses a copy of x's allocator.
 			vector (const vector& x)
 			{
+				_start = 0;
 				_size = 0;
 				_capacity = 0;
 				_alloc = x._alloc;
@@ -93,12 +236,11 @@ namespace ft
 			//The container preserves its current allocator, which is used to allocate storage in case of reallocation.
 			vector& operator= (const vector& x)
 			{
-				if (x == *this)
+				if (&x == this)
 					return (*this);
 
 				//Destroy existing objects
-				for (size_type i = 0; i < _size; i++)
-					_alloc.destroy(_start + i);
+				destroy_range(_start, _start + _size);
 
 				//Modify size and reallocate more capacity if necessary
 				this->_size = x._size;
@@ -107,22 +249,43 @@ namespace ft
 					if (_capacity != 0)
 						_alloc.deallocate(_start, _capacity);
 					_capacity = _size;
-					_start = _alloc.allocate(_capacity);
+					_start = block_traits::allocate_at_least(_alloc, _capacity);
 				}
 
 				//Constructs the elements by copying those from x
-				for (size_type i = 0; i < _size; i++)
-					_alloc.construct(_start + i, x[i]);
+				construct_copies(_start, x._start, _size);
+
+				return *this;
+			}
+
+# if FT_MOVE_SEMANTICS
+			//Move constructor
+			//Takes the storage of x, which is left empty.
+			vector (vector&& x) : _alloc(x._alloc), _start(x._start), _size(x._size), _capacity(x._capacity)
+			{
+				x._start = 0;
+				x._size = 0;
+				x._capacity = 0;
+			}
 
+			//Move assignment operator
+			//Destroys the elements of the container and takes the storage of x, which is left with the former storage.
+			vector& operator= (vector&& x)
+			{
+				if (&x != this)
+				{
+					clear();
+					swap(x);
+				}
 				return *this;
 			}
+# endif
 			
 			//Destructor
 			~vector()
 			{
 				//Destroy existing objects
-				for (size_type i = 0; i < _size; i++)
-					_alloc.destroy(_start + i);
+				destroy_range(_start, _start + _size);
 
 				//Deallocate memory block
 				if (_capacity != 0)
@@ -206,8 +369,7 @@ namespace ft
 				if (n < _size)
 				{
 					//Destroy objects beyond n
-					for (size_type i = n; i < _size; i++)
-						_alloc.destroy(_start + i);
+					destroy_range(_start + n, _start + _size);
 					
 					_size = n;
 				}
@@ -217,7 +379,7 @@ namespace ft
 				{
 					//If n is also greater than the current container capacity, an automatic reallocation of the allocated storage space takes place.
 					if (n > _capacity)
-						reserve(n);
+						reserve(grown_capacity(n));
 
 					for (size_type i = _size; i < n; i++)
 						_alloc.construct(_start + i, val); //constructs (by calling the constructor of value_type with argument val) an element object on the location pointed by _start + i
@@ -226,6 +388,43 @@ namespace ft
 				}
 			}
 
+			//Resizes the container so that it contains n elements, the new ones default-initialized : a trivial type
+			//(char, a struct of integers and arrays) is left uninitialized, for instance to be overwritten by read()
+			void resize_default_init (size_type n)
+			{
+				if (n <= _size)
+				{
+					destroy_range(_start + n, _start + _size);
+					_size = n;
+					return;
+				}
+				if (n > _capacity)
+					reserve(grown_capacity(n));
+				for (; _size < n; _size++)
+					::new (static_cast<void *>(_start + _size)) value_type;
+			}
+
+			//Makes room for n more elements after the last one and returns a pointer to that uninitialized storage,
+			//without changing the size. The caller writes (or constructs) elements there, then counts them with commit.
+			//Any later reallocation, including another append_uninitialized, invalidates the pointer.
+			pointer append_uninitialized (size_type n)
+			{
+				if (n > max_size() - _size)
+					throw std::length_error("vector::append_uninitialized");
+				if (_size + n > _capacity)
+					reserve(grown_capacity(_size + n));
+				return _start + _size;
+			}
+
+			//Adds to the size the n elements the caller initialized after the last one, in storage obtained from
+			//append_uninitialized
+			void commit (size_type n)
+			{
+				if (n > _capacity - _size)
+					throw std::length_error("vector::commit");
+				_size += n;
+			}
+
 			//Returns the size of the storage space currently allocated for the vector
 			size_type capacity() const
 			{
@@ -248,14 +447,18 @@ namespace ft
 				if (n <= _capacity)
 					return;
 
-				//Allocate a new block of memory and copy the old container into the new one
-				pointer new_start = _alloc.allocate(n); //allocates a block of storage with a size large enough to contain n elements of type value_type
-				for (size_type i = 0; i < _size; i++)
-					_alloc.construct(new_start + i, *(_start + i)); //constructs (by calling the constructor of value_type with argument val) an element object on the location pointed by _start + i
+				//Grow the block without moving the elements when the allocator can
+				if (grows_in_place())
+				{
+					_start = block_traits::reallocate(_alloc, _start, _capacity, n);
+					_capacity = n;
+					return;
+				}
+
+				//Allocate a new block of memory and move the old container into the new one
+				pointer new_start = block_traits::allocate_at_least(_alloc, n); //allocates a block of storage with a size large enough to contain n elements of type value_type
+				relocate(new_start, _start, _size);
 
-				//Destroy objects in the old container
-				for (size_type i = 0; i < _size; i++)
-					_alloc.destroy(_start + i);
 				//Deallocate the old memory block
 				if (_capacity != 0)
 					_alloc.deallocate(_start, _capacity);
@@ -345,12 +548,7 @@ namespace ft
 				//Reallocate storage space if necessary
 				size_type nb_elements = static_cast<size_type>(diff);
 				if (nb_elements > _capacity)
-				{
-					//Deallocate existing storage space
-					_alloc.deallocate(_start, _capacity);
-					_start = _alloc.allocate(nb_elements);
-					_capacity = nb_elements;
-				}
+					reallocate_empty(grown_capacity(nb_elements));
 				//Construct with new elements
 				for (size_type i = 0; first != last; i++, first++)
 					_alloc.construct(_start + i, *first);
@@ -367,12 +565,7 @@ namespace ft
 
 				//Reallocate storage space if necessary
 				if (n > _capacity)
-				{
-					//Deallocate existing storage space
-					_alloc.deallocate(_start, _capacity);
-					_start = _alloc.allocate(n);
-					_capacity = n;
-				}
+					reallocate_empty(grown_capacity(n));
 				//Construct with new elements
 				for (size_type i = 0; i < n; i++)
 					_alloc.construct(_start + i, val);
@@ -386,17 +579,71 @@ namespace ft
 				//Reallocation if new vector size surpasses the current vector capacity
 				if (_size == _capacity)
 				{
-					if (_capacity == 0)
-						reserve(1);
-					else
-						reserve(_capacity * 2); //double the current capacity to prevent frequent reallocation
+					value_type copy(val); //val may be an element, which the reallocation is going to move
+					reserve(grown_capacity(_size + 1)); //grow geometrically to prevent frequent reallocation
+					_alloc.construct(_start + _size, FT_MOVE(copy));
 				}
+				else
+					_alloc.construct(_start + _size, val); //construct the new element
+				_size++;
+			}
 
-				//Construct the new element
-				_alloc.construct(_start + _size, val);
+# if FT_MOVE_SEMANTICS
+			//Adds val at the end of the vector, moving it
+			void push_back (value_type&& val)
+			{
+				emplace_back(std::move(val));
+			}
+
+			//Adds at the end of the vector an element constructed in place from args
+			template <class... Args>
+			void emplace_back (Args&&... args)
+			{
+				if (_size == _capacity)
+				{
+					value_type element(std::forward<Args>(args)...); //args may refer to elements, which the reallocation is going to move
+					reserve(grown_capacity(_size + 1));
+					_alloc.construct(_start + _size, std::move(element));
+				}
+				else
+					std::allocator_traits<allocator_type>::construct(_alloc, _start + _size, std::forward<Args>(args)...);
 				_size++;
 			}
 
+			//Inserts before position an element constructed from args
+			template <class... Args>
+			iterator emplace (const_iterator position, Args&&... args)
+			{
+				size_type insert_index = static_cast<size_type>(position - const_iterator(_start));
+				if (insert_index > _size)
+					throw std::length_error("vector::emplace");
+				if (insert_index == _size)
+					emplace_back(std::forward<Args>(args)...);
+				else
+				{
+					value_type element(std::forward<Args>(args)...); //args may refer to elements which are going to move
+					open_gap(insert_index, 1);
+					try
+					{
+						_alloc.construct(_start + insert_index, std::move(element));
+					}
+					catch (...)
+					{
+						close_gap(insert_index, 1, 0);
+						throw;
+					}
+					_size++;
+				}
+				return iterator(_start + insert_index);
+			}
+
+			//Inserts val before position, moving it
+			iterator insert (iterator position, value_type&& val)
+			{
+				return emplace(position, std::move(val));
+			}
+# endif
+
 			//Removes the last element in the vector, effectively reducing the container size by one.
 			void pop_back()
 			{
@@ -424,53 +671,22 @@ namespace ft
 					throw std::length_error("vector::insert");
 
 				size_type insert_index =  static_cast<size_type>(position - begin());
+				const value_type copy(val); //val may be an element which is going to move
+				open_gap(insert_index, n);
 
-				//Reallocation if new vector size surpasses the current vector capacity
-				if (_size + n > _capacity)
+				//Insert the n new elements copied from val starting at insert_index
+				size_type i = insert_index;
+				try
 				{
-					pointer new_start = _alloc.allocate(_size + n);
-					
-					//Reconstruct elements in new array up until the insert_index
-					for (size_type i = 0; i < insert_index; i++)
-					{
-						_alloc.construct(new_start + i, *(_start + i));
-						_alloc.destroy(_start + i);
-					}
-
-					//Move all elements after insert_index + n to their old position + n
-					size_type end_of_insert_index = insert_index + n; //where the insertion stops, which is the new beginning index for the displaced elements
-					for (size_type i = end_of_insert_index; i < (_size + n) && _start != 0; i++)
-					{
-							_alloc.construct(new_start + i, *(_start + i - n));
-							_alloc.destroy(_start + i - n);
-					}
-					
-					//Insert the n new elements copied from val starting at insert_index
-					for (size_type i = insert_index; i < end_of_insert_index; i++)
-						_alloc.construct(new_start + i, val);
-
-					_alloc.deallocate(_start, _capacity);
-					_start = new_start;
-					_capacity = _size + n;
-					_size += n;
+					for (; i < insert_index + n; i++)
+						_alloc.construct(_start + i, copy);
 				}
-				//If no reallocation necessary, directly displace elements and insert n copies of val
-				else
+				catch (...)
 				{
-					//Move all elements after insert_index + n to their old position + n
-					size_type end_of_insert_index = insert_index + n; //where the insertion stops, which is the new beginning index for the displaced elements
-					for (size_type i = end_of_insert_index; i < (_size + n) && _start != 0; i++)
-					{
-							_alloc.construct(_start + i, *(_start + i - n));
-							_alloc.destroy(_start + i - n);
-					}
-					
-					//Insert the n new elements copied from val starting at insert_index
-					for (size_type i = insert_index; i < end_of_insert_index; i++)
-						_alloc.construct(_start + i, val);
-
-					_size += n;
+					close_gap(insert_index, n, i - insert_index);
+					throw;
 				}
+				_size += n;
 			}
 
 			//The vector is extended by inserting new elements before the element at the specified position,
@@ -486,53 +702,21 @@ namespace ft
 
 				size_type n = static_cast<size_type>(diff);
 				size_type insert_index =  static_cast<size_type>(position - begin());
+				open_gap(insert_index, n);
 
-				//Reallocation if new vector size surpasses the current vector capacity
-				if (_size + n > _capacity)
+				//Insert the n new elements copied from the range starting at insert_index
+				size_type i = insert_index;
+				try
 				{
-					pointer new_start = _alloc.allocate(_size + n);
-					
-					//Reconstruct elements in new array up until the insert_index
-					for (size_type i = 0; i < insert_index; i++)
-					{
-						_alloc.construct(new_start + i, *(_start + i));
-						_alloc.destroy(_start + i);
-					}
-
-					//Move all elements after insert_index + n to their old position + n
-					size_type end_of_insert_index = insert_index + n; //where the insertion stops, which is the new beginning index for the displaced elements
-					for (size_type i = end_of_insert_index; i < (_size + n); i++)
-					{
-							_alloc.construct(new_start + i, *(_start + i - n));
-							_alloc.destroy(_start + i - n);
-					}
-					
-					//Insert the n new elements copied from the range starting at insert_index
-					for (size_type i = insert_index; i < end_of_insert_index; i++, first++)
-						_alloc.construct(new_start + i, *first);
-
-					_alloc.deallocate(_start, _capacity);
-					_start = new_start;
-					_capacity = _size + n;
-					_size += n;
+					for (; i < insert_index + n; i++, first++)
+						_alloc.construct(_start + i, *first);
 				}
-				//If no reallocation necessary, directly displace elements and insert n copies of val
-				else
+				catch (...)
 				{
-					//Move all elements after insert_index + n to their old position + n
-					size_type end_of_insert_index = insert_index + n; //where the insertion stops, which is the new beginning index for the displaced elements
-					for (size_type i = end_of_insert_index; i < (_size + n); i++)
-					{
-							_alloc.construct(_start + i, *(_start + i - n));
-							_alloc.destroy(_start + i - n);
-					}
-					
-					//Insert the n new elements copied from the range starting at insert_index
-					for (size_type i = insert_index; i < end_of_insert_index; i++, first++)
-						_alloc.construct(_start + i, *first);
-
-					_size += n;
+					close_gap(insert_index, n, i - insert_index);
+					throw;
 				}
+				_size += n;
 			}
 
 			//Removes from the vector a single element
@@ -540,12 +724,9 @@ namespace ft
 			{
 				size_type erase_index =  static_cast<size_type>(std::distance(begin(), position));
 
-				//Move all elements one index to the left
-				for (size_type i = erase_index; i < _size - 1; i++)
-				{
-					_alloc.construct(_start + i, *(_start + i + 1));
-					_alloc.destroy(_start + i + 1);
-				}
+				//Destroy the element, then move all the following elements one index to the left
+				_alloc.destroy(_start + erase_index);
+				relocate(_start + erase_index, _start + erase_index + 1, _size - erase_index - 1);
 
 				_size--;
 				return iterator(_start + erase_index);
@@ -559,16 +740,10 @@ namespace ft
 				size_type erase_index =  static_cast<size_type>(std::distance(begin(), first));
 
 				//Destroy elements in range
-				for (size_type i = erase_index; i < erase_index + n; i++)
-					_alloc.destroy(_start + i);
+				destroy_range(_start + erase_index, _start + erase_index + n);
 
 				//Move all elements n indices to the left, starting from the element at the end of the range
-				for (size_type i = erase_index + n; i < _size; i++)
-				{
-					// value_type test =  *(_start + i);
-					_alloc.construct(_start + i - n, *(_start + i));
-					_alloc.destroy(_start + i);
-				}
+				relocate(_start + erase_index, _start + erase_index + n, _size - erase_index - n);
 
 				_size -= n;
 				return iterator(_start + erase_index);
@@ -586,8 +761,7 @@ namespace ft
 			//Removes all elements from the vector (which are destroyed), leaving the container with a size of 0.
 			void clear()
 			{
-				for (size_type i = 0; i < _size; i++)
-					_alloc.destroy(_start + i);
+				destroy_range(_start, _start + _size);
 
 				_size = 0;
 			}
@@ -606,6 +780,82 @@ namespace ft
 				pointer _start; //pointer to the beginning of the array
 				size_type _size; //current number of elements in the array
 				size_type _capacity; //full capacity of the allocated array
+
+				typedef ft::allocation_traits<allocator_type> block_traits;
+
+				//Whether reserve grows the block with the allocator instead of relocating the elements to a new one
+				bool grows_in_place() const
+				{
+					return block_traits::can_reallocate && ft::is_trivially_relocatable<value_type>::value && _capacity != 0;
+				}
+
+				//Capacity to allocate for n elements, n being more than the current capacity, chosen by the growth policy
+				size_type grown_capacity(size_type n) const
+				{
+					if (n > max_size())
+						throw std::length_error("vector");
+					return Growth::next_capacity(_capacity, n, max_size(), sizeof(value_type));
+				}
+
+				//Replaces the storage of an empty vector by a block of n elements
+				void reallocate_empty(size_type n)
+				{
+					pointer new_start = block_traits::allocate_at_least(_alloc, n);
+					if (_capacity != 0)
+						_alloc.deallocate(_start, _capacity);
+					_start = new_start;
+					_capacity = n;
+				}
+
+				void destroy_range(pointer first, pointer last)
+				{
+					ft::destroy_elements(_alloc, first, last);
+				}
+
+				void construct_copies(pointer dst, const_pointer src, size_type n)
+				{
+					ft::copy_elements(_alloc, dst, src, n);
+				}
+
+				void relocate(pointer dst, pointer src, size_type n)
+				{
+					ft::relocate_elements(_alloc, dst, src, n);
+				}
+
+				//Makes room for n elements at index, moving the elements after it. The n elements are left uninitialized,
+				//and the caller adds them to the size once they are all constructed.
+				void open_gap(size_type index, size_type n)
+				{
+					if (n == 0)
+						return;
+					//Reallocation if new vector size surpasses the current vector capacity
+					if (_size + n > _capacity && !grows_in_place())
+					{
+						size_type new_capacity = grown_capacity(_size + n);
+						pointer new_start = block_traits::allocate_at_least(_alloc, new_capacity);
+						relocate(new_start, _start, index);
+						relocate(new_start + index + n, _start + index, _size - index);
+						if (_capacity != 0)
+							_alloc.deallocate(_start, _capacity);
+						_start = new_start;
+						_capacity = new_capacity;
+					}
+					//If no reallocation necessary, or the block grows in place, directly displace elements
+					else
+					{
+						if (_size + n > _capacity)
+							reserve(grown_capacity(_size + n));
+						relocate(_start + index + n, _start + index, _size - index);
+					}
+				}
+
+				//Undoes open_gap(index, n) after the construction of an element threw : destroys the first built elements
+				//of the gap, and moves the elements after the gap back to index
+				void close_gap(size_type index, size_type n, size_type built)
+				{
+					destroy_range(_start + index, _start + index + built);
+					relocate(_start + index, _start + index + n, _size - index);
+				}
 	};
 
 	///-------------------------------///
@@ -614,44 +864,38 @@ namespace ft
 
 	/// RELATIONAL OPERATORS ///
 
-	template <class T, class Alloc>
-	bool operator== (const vector<T, Alloc>& lhs, const vector<T, Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool operator== (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 	{
-		if (lhs.size() != rhs.size())
-			return false;
-		
-		for (size_t i = 0; i < lhs.size(); i++)
-			if ( !(lhs[i] == rhs[i]) )
-				return false;
-		return true;
+		return lhs.size() == rhs.size() && ft::equal(lhs.begin(), lhs.end(), rhs.begin());
 	}
 
-	template <class T, class Alloc>
-	bool operator!= (const vector<T,Alloc>& lhs, const vector<T,Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool operator!= (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 	{
 		return !(lhs == rhs);
 	}
 
-	template <class T, class Alloc>
-	bool operator<  (const vector<T,Alloc>& lhs, const vector<T,Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool operator<  (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 	{
 		return ft::lexicographical_compare( lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
 	}
 
-	template <class T, class Alloc>
-	bool operator<= (const vector<T,Alloc>& lhs, const vector<T,Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool operator<= (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 	{
 		return !(rhs < lhs);
 	}
 
-	template <class T, class Alloc>
-	bool operator>  (const vector<T,Alloc>& lhs, const vector<T,Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool operator>  (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 	{
 		return rhs < lhs;
 	}
 
-	template <class T, class Alloc>
-	bool operator>= (const vector<T,Alloc>& lhs, const vector<T,Alloc>& rhs)
+	template <class T, class Alloc, class Growth>
+	bool operator>= (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 	{
 		return !(lhs < rhs);
 	}
@@ -659,12 +903,14 @@ namespace ft
 	/// SWAP ///
 
 	//Overload of the swap function
-	template <class T, class Alloc>
-	void swap (vector<T,Alloc>& x, vector<T,Alloc>& y)
+	template <class T, class Alloc, class Growth>
+	void swap (vector<T, Alloc, Growth>& x, vector<T, Alloc, Growth>& y)
 	{
 		x.swap(y);
 	}
 }
 
 
+# include "vector_bool.hpp"
+
 #endif
\ No newline at end of file
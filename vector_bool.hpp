@@ -0,0 +1,763 @@
+#ifndef VECTOR_BOOL_HPP
+# define VECTOR_BOOL_HPP
+
+# include <memory>
+# include <cstring>
+# include <iterator>
+# include <stdexcept>
+# include "utils.hpp"
+# include "iterator.hpp"
+# include "vector.hpp"
+
+namespace ft
+{
+	///------------///
+	/// BIT ACCESS ///
+	///------------///
+
+	//The bits of a vector<bool> are packed 64 per word, the first one in the least significant bit
+	typedef unsigned long long bit_word;
+
+	//Index of the lowest set bit of a non-zero word
+	inline std::size_t lowest_bit(bit_word word)
+	{
+# if defined(__GNUC__)
+		return static_cast<std::size_t>(__builtin_ctzll(word));
+# else
+		std::size_t index = 0;
+		for (; (word & 1) == 0; word >>= 1)
+			index++;
+		return index;
+# endif
+	}
+
+	//Proxy for a bit of a vector<bool>, which is converted to bool and assigned from it
+	class bit_reference
+	{
+		public:
+			bit_reference(bit_word * word, bit_word mask) : _word(word), _mask(mask) {}
+
+			operator bool() const
+			{
+				return (*_word & _mask) != 0;
+			}
+
+			bit_reference& operator= (bool x)
+			{
+				if (x)
+					*_word |= _mask;
+				else
+					*_word &= ~_mask;
+				return *this;
+			}
+
+			bit_reference& operator= (const bit_reference& x)
+			{
+				return *this = static_cast<bool>(x);
+			}
+
+			bool operator~ () const
+			{
+				return !static_cast<bool>(*this);
+			}
+
+			void flip()
+			{
+				*_word ^= _mask;
+			}
+
+		private:
+			bit_word * _word;
+			bit_word _mask;
+	};
+
+	//Random access iterator over the bits of a vector<bool> : a word and a bit offset in it.
+	//Dereferencing gives a bit_reference, or a bool for the const version.
+	template <bool Const>
+	class bit_iterator
+	{
+		public:
+			typedef bool value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef void pointer;
+			typedef typename ft::choose<Const, bool, ft::bit_reference>::type reference;
+			typedef std::random_access_iterator_tag iterator_category; //needed for std::distance
+			typedef typename ft::choose<Const, const bit_word *, bit_word *>::type word_pointer;
+
+			bit_iterator() : _word(0), _offset(0) {}
+
+			bit_iterator(word_pointer word, std::size_t offset) : _word(word), _offset(offset) {}
+
+			//Copy constructor, and conversion of an iterator to a const_iterator
+			bit_iterator(const bit_iterator<false>& x) : _word(x.word()), _offset(x.offset()) {}
+
+			word_pointer word() const
+			{
+				return _word;
+			}
+
+			std::size_t offset() const
+			{
+				return _offset;
+			}
+
+			reference operator*() const
+			{
+				return bit_at(_word, _offset);
+			}
+
+			reference operator[] (difference_type n) const
+			{
+				return *(*this + n);
+			}
+
+			bit_iterator& operator++()
+			{
+				if (++_offset == 64)
+				{
+					_offset = 0;
+					++_word;
+				}
+				return *this;
+			}
+
+			bit_iterator operator++(int)
+			{
+				bit_iterator cpy = *this;
+				++(*this);
+				return cpy;
+			}
+
+			bit_iterator& operator--()
+			{
+				if (_offset-- == 0)
+				{
+					_offset = 63;
+					--_word;
+				}
+				return *this;
+			}
+
+			bit_iterator operator--(int)
+			{
+				bit_iterator cpy = *this;
+				--(*this);
+				return cpy;
+			}
+
+			bit_iterator& operator+= (difference_type n)
+			{
+				difference_type position = static_cast<difference_type>(_offset) + n;
+				difference_type words = position >= 0 ? position / 64 : -((63 - position) / 64);
+				_word += words;
+				_offset = static_cast<std::size_t>(position - words * 64);
+				return *this;
+			}
+
+			bit_iterator& operator-= (difference_type n)
+			{
+				return *this += -n;
+			}
+
+			bit_iterator operator+ (difference_type n) const
+			{
+				bit_iterator cpy = *this;
+				return cpy += n;
+			}
+
+			bit_iterator operator- (difference_type n) const
+			{
+				bit_iterator cpy = *this;
+				return cpy -= n;
+			}
+
+		private:
+			word_pointer _word;
+			std::size_t _offset;
+
+			static bool bit_at(const bit_word * word, std::size_t offset)
+			{
+				return (*word >> offset) & 1;
+			}
+
+			static ft::bit_reference bit_at(bit_word * word, std::size_t offset)
+			{
+				return ft::bit_reference(word, static_cast<bit_word>(1) << offset);
+			}
+	};
+
+	template <bool L, bool R>
+	std::ptrdiff_t operator- (const bit_iterator<L>& lhs, const bit_iterator<R>& rhs)
+	{
+		return (lhs.word() - rhs.word()) * 64 + static_cast<std::ptrdiff_t>(lhs.offset()) - static_cast<std::ptrdiff_t>(rhs.offset());
+	}
+
+	template <bool Const>
+	bit_iterator<Const> operator+ (std::ptrdiff_t n, const bit_iterator<Const>& it)
+	{
+		return it + n;
+	}
+
+	template <bool L, bool R>
+	bool operator== (const bit_iterator<L>& lhs, const bit_iterator<R>& rhs)
+	{
+		return lhs.word() == rhs.word() && lhs.offset() == rhs.offset();
+	}
+
+	template <bool L, bool R>
+	bool operator!= (const bit_iterator<L>& lhs, const bit_iterator<R>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template <bool L, bool R>
+	bool operator< (const bit_iterator<L>& lhs, const bit_iterator<R>& rhs)
+	{
+		return lhs - rhs < 0;
+	}
+
+	template <bool L, bool R>
+	bool operator> (const bit_iterator<L>& lhs, const bit_iterator<R>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template <bool L, bool R>
+	bool operator<= (const bit_iterator<L>& lhs, const bit_iterator<R>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template <bool L, bool R>
+	bool operator>= (const bit_iterator<L>& lhs, const bit_iterator<R>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	///--------------///
+	/// VECTOR<BOOL> ///
+	///--------------///
+
+	//Bit-packed vector of bool : one bit per element, 64 to a word. The elements are bit_reference proxies, as with
+	//std::vector<bool>. The bits past size() are kept at 0, so that count(), find_first(), find_next() and the bitwise
+	//operators work a word at a time (with the kernels of simd.hpp), and that equality compares words.
+	//Insertions and erasures which are not at the end move the following bits one at a time.
+	template <class Alloc, class Growth>
+	class vector<bool, Alloc, Growth>
+	{
+		public:
+			///--------------///
+			/// MEMBER TYPES ///
+			///--------------///
+
+			typedef bool value_type;
+			typedef Alloc allocator_type;
+			typedef Growth growth_policy;
+			typedef ft::bit_reference reference;
+			typedef bool const_reference;
+			typedef ft::bit_iterator<false> iterator;
+			typedef ft::bit_iterator<true> const_iterator;
+			typedef ft::reverse_iterator<iterator> reverse_iterator;
+			typedef ft::reverse_iterator<const_iterator> const_reverse_iterator;
+			typedef std::ptrdiff_t difference_type;
+			typedef std::size_t size_type;
+			typedef ft::bit_word word_type;
+
+			static const size_type word_bits = 64;
+
+		private:
+			typedef typename allocator_type::template rebind<word_type>::other word_allocator;
+
+		public:
+			///------------------///
+			/// MEMBER FUNCTIONS ///
+			///------------------///
+
+			explicit vector (const allocator_type& alloc = allocator_type())
+				: _alloc(alloc), _words(0), _size(0), _capacity(0) {}
+
+			explicit vector (size_type n, const value_type& val = value_type(), const allocator_type& alloc = allocator_type())
+				: _alloc(alloc), _words(0), _size(0), _capacity(0)
+			{
+				reserve(n);
+				fill_bits(0, n, val);
+				_size = n;
+			}
+
+			template <class InputIterator>
+			vector (InputIterator first, InputIterator last, const allocator_type& alloc = allocator_type(),
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+				: _alloc(alloc), _words(0), _size(0), _capacity(0)
+			{
+				insert(end(), first, last);
+			}
+
+			vector (const vector& x) : _alloc(x._alloc), _words(0), _size(0), _capacity(0)
+			{
+				*this = x;
+			}
+
+			vector& operator= (const vector& x)
+			{
+				if (&x == this)
+					return *this;
+				if (words_for(x._size) > _capacity)
+				{
+					release();
+					reallocate(words_for(x._size));
+				}
+				else
+					fill_bits(0, _size, false);
+				if (x._size != 0)
+					std::memcpy(_words, x._words, words_for(x._size) * sizeof(word_type));
+				_size = x._size;
+				return *this;
+			}
+
+# if FT_MOVE_SEMANTICS
+			vector (vector&& x) : _alloc(x._alloc), _words(x._words), _size(x._size), _capacity(x._capacity)
+			{
+				x._words = 0;
+				x._size = 0;
+				x._capacity = 0;
+			}
+
+			vector& operator= (vector&& x)
+			{
+				if (&x != this)
+				{
+					clear();
+					swap(x);
+				}
+				return *this;
+			}
+# endif
+
+			~vector()
+			{
+				release();
+			}
+
+			/// ITERATORS ///
+
+			iterator begin()
+			{
+				return iterator(_words, 0);
+			}
+
+			const_iterator begin() const
+			{
+				return const_iterator(_words, 0);
+			}
+
+			iterator end()
+			{
+				return iterator(_words + _size / word_bits, _size % word_bits);
+			}
+
+			const_iterator end() const
+			{
+				return const_iterator(_words + _size / word_bits, _size % word_bits);
+			}
+
+			reverse_iterator rbegin()
+			{
+				return reverse_iterator(end());
+			}
+
+			const_reverse_iterator rbegin() const
+			{
+				return const_reverse_iterator(end());
+			}
+
+			reverse_iterator rend()
+			{
+				return reverse_iterator(begin());
+			}
+
+			const_reverse_iterator rend() const
+			{
+				return const_reverse_iterator(begin());
+			}
+
+			/// CAPACITY ///
+
+			size_type size() const
+			{
+				return _size;
+			}
+
+			size_type max_size() const
+			{
+				size_type words = _alloc.max_size();
+				return words > static_cast<size_type>(-1) / word_bits ? static_cast<size_type>(-1) : words * word_bits;
+			}
+
+			void resize (size_type n, value_type val = value_type())
+			{
+				if (n < _size)
+				{
+					fill_bits(n, _size, false);
+					_size = n;
+				}
+				else if (n > _size)
+					insert(end(), n - _size, val);
+			}
+
+			//In bits, a multiple of 64
+			size_type capacity() const
+			{
+				return _capacity * word_bits;
+			}
+
+			bool empty() const
+			{
+				return _size == 0;
+			}
+
+			void reserve (size_type n)
+			{
+				if (n > max_size())
+					throw (std::length_error("vector<bool>::reserve"));
+				if (words_for(n) > _capacity)
+					reallocate(words_for(n));
+			}
+
+			/// ELEMENT ACCESS ///
+
+			reference operator[] (size_type n)
+			{
+				return reference(_words + n / word_bits, static_cast<word_type>(1) << (n % word_bits));
+			}
+
+			const_reference operator[] (size_type n) const
+			{
+				return bit(n);
+			}
+
+			reference at (size_type n)
+			{
+				if (n >= _size)
+					throw std::out_of_range("vector<bool>::at index out of range");
+				return (*this)[n];
+			}
+
+			const_reference at (size_type n) const
+			{
+				if (n >= _size)
+					throw std::out_of_range("vector<bool>::at index out of range");
+				return bit(n);
+			}
+
+			reference front()
+			{
+				return (*this)[0];
+			}
+
+			const_reference front() const
+			{
+				return bit(0);
+			}
+
+			reference back()
+			{
+				return (*this)[_size - 1];
+			}
+
+			const_reference back() const
+			{
+				return bit(_size - 1);
+			}
+
+			/// MODIFIERS ///
+
+			template <class InputIterator>
+			void assign (InputIterator first, InputIterator last,
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+			{
+				clear();
+				insert(end(), first, last);
+			}
+
+			void assign (size_type n, const value_type& val)
+			{
+				bool copy = val;
+				clear();
+				insert(end(), n, copy);
+			}
+
+			void push_back (const value_type& val)
+			{
+				if (_size == capacity())
+					reallocate(grown_capacity(words_for(_size + 1)));
+				if (val)
+					set_bit(_size, true);
+				_size++;
+			}
+
+			void pop_back()
+			{
+				_size--;
+				set_bit(_size, false);
+			}
+
+			iterator insert (iterator position, const value_type& val)
+			{
+				size_type index = static_cast<size_type>(position - begin());
+				insert(position, 1, val);
+				return begin() + index;
+			}
+
+			void insert (iterator position, size_type n, const value_type& val)
+			{
+				if (n > max_size() - _size || position < begin() || position > end())
+					throw std::length_error("vector<bool>::insert");
+				bool copy = val; //val may be a bit which is going to move
+				size_type index = static_cast<size_type>(position - begin());
+				open_gap(index, n);
+				fill_bits(index, index + n, copy);
+			}
+
+			template <class InputIterator>
+			void insert (iterator position, InputIterator first, InputIterator last,
+				typename ft::enable_if< ! ft::is_integral<InputIterator>::value >::type* = 0)
+			{
+				difference_type diff = std::distance(first, last);
+				if (diff < 0 || position < begin() || position > end())
+					throw std::length_error("vector<bool>::insert");
+				size_type index = static_cast<size_type>(position - begin());
+				open_gap(index, static_cast<size_type>(diff));
+				for (size_type i = index; first != last; i++, first++)
+					set_bit(i, *first);
+			}
+
+			iterator erase (iterator position)
+			{
+				return erase(position, position + 1);
+			}
+
+			iterator erase (iterator first, iterator last)
+			{
+				size_type index = static_cast<size_type>(first - begin());
+				size_type n = static_cast<size_type>(last - first);
+				for (size_type i = index + n; i < _size; i++)
+					set_bit(i - n, bit(i));
+				fill_bits(_size - n, _size, false);
+				_size -= n;
+				return begin() + index;
+			}
+
+			void swap (vector& x)
+			{
+				std::swap(_alloc, x._alloc);
+				std::swap(_words, x._words);
+				std::swap(_size, x._size);
+				std::swap(_capacity, x._capacity);
+			}
+
+			//Exchanges the values of two bits
+			static void swap (reference x, reference y)
+			{
+				bool tmp = x;
+				x = y;
+				y = tmp;
+			}
+
+			void clear()
+			{
+				if (_size != 0)
+					std::memset(_words, 0, words_for(_size) * sizeof(word_type));
+				_size = 0;
+			}
+
+			//Flips every bit
+			void flip()
+			{
+				size_type words = words_for(_size);
+				for (size_type i = 0; i < words; i++)
+					_words[i] = ~_words[i];
+				clear_tail();
+			}
+
+			allocator_type get_allocator() const
+			{
+				return allocator_type(_alloc);
+			}
+
+			/// BITS ///
+
+			//Number of true elements
+			size_type count() const
+			{
+				return ft::simd_kernels<word_type>::popcount(_words, _words + words_for(_size));
+			}
+
+			//Index of the first true element, or size() if there is none
+			size_type find_first() const
+			{
+				return find_from(0);
+			}
+
+			//Index of the first true element after pos, or size() if there is none
+			size_type find_next(size_type pos) const
+			{
+				return pos + 1 >= _size ? _size : find_from(pos + 1);
+			}
+
+			//Element-wise and, or, xor with a vector of the same size
+			vector& operator&= (const vector& x)
+			{
+				return bitwise<ft::simd_and>(x);
+			}
+
+			vector& operator|= (const vector& x)
+			{
+				return bitwise<ft::simd_or>(x);
+			}
+
+			vector& operator^= (const vector& x)
+			{
+				return bitwise<ft::simd_xor>(x);
+			}
+
+			//The words holding the bits, the first one in the least significant bit of the first word
+			const word_type * words() const
+			{
+				return _words;
+			}
+
+		private:
+			word_allocator _alloc;
+			word_type * _words;
+			size_type _size; //in bits
+			size_type _capacity; //in words, all of them initialized, and 0 past _size
+
+			static size_type words_for(size_type bits)
+			{
+				return bits / word_bits + (bits % word_bits != 0);
+			}
+
+			bool bit(size_type n) const
+			{
+				return (_words[n / word_bits] >> (n % word_bits)) & 1;
+			}
+
+			void set_bit(size_type n, bool val)
+			{
+				word_type mask = static_cast<word_type>(1) << (n % word_bits);
+				if (val)
+					_words[n / word_bits] |= mask;
+				else
+					_words[n / word_bits] &= ~mask;
+			}
+
+			//Sets the bits of [first, last) to val, whole words at once between the first and the last ones
+			void fill_bits(size_type first, size_type last, bool val)
+			{
+				for (; first < last && first % word_bits != 0; first++)
+					set_bit(first, val);
+				if (last - first >= word_bits)
+				{
+					std::memset(_words + first / word_bits, val ? 0xFF : 0, (last - first) / word_bits * sizeof(word_type));
+					first += (last - first) / word_bits * word_bits;
+				}
+				for (; first < last; first++)
+					set_bit(first, val);
+			}
+
+			//Clears the bits of the last word past _size
+			void clear_tail()
+			{
+				if (_size % word_bits != 0)
+					_words[_size / word_bits] &= (static_cast<word_type>(1) << (_size % word_bits)) - 1;
+			}
+
+			//Capacity in words to allocate for n words, n being more than the current capacity, chosen by the growth policy
+			size_type grown_capacity(size_type n) const
+			{
+				size_type max_words = words_for(max_size());
+				if (n > max_words)
+					throw std::length_error("vector<bool>");
+				return Growth::next_capacity(_capacity, n, max_words, sizeof(word_type));
+			}
+
+			//Moves the words to a block of n words, the new ones set to 0
+			void reallocate(size_type n)
+			{
+				word_type * words = _alloc.allocate(n);
+				if (_capacity != 0)
+					std::memcpy(words, _words, _capacity * sizeof(word_type));
+				std::memset(words + _capacity, 0, (n - _capacity) * sizeof(word_type));
+				release();
+				_words = words;
+				_capacity = n;
+			}
+
+			void release()
+			{
+				if (_capacity != 0)
+					_alloc.deallocate(_words, _capacity);
+				_words = 0;
+				_capacity = 0;
+			}
+
+			//Makes room for n bits at index, moving the bits after it, and counts them in the size.
+			//The n bits are left with any value.
+			void open_gap(size_type index, size_type n)
+			{
+				if (n == 0)
+					return;
+				if (words_for(_size + n) > _capacity)
+					reallocate(grown_capacity(words_for(_size + n)));
+				for (size_type i = _size; i-- > index; )
+					set_bit(i + n, bit(i));
+				_size += n;
+			}
+
+			size_type find_from(size_type pos) const
+			{
+				if (pos >= _size)
+					return _size;
+				size_type index = pos / word_bits;
+				word_type word = _words[index] & (~static_cast<word_type>(0) << (pos % word_bits));
+				if (word == 0)
+				{
+					const word_type * end = _words + words_for(_size);
+					const word_type * found = ft::simd_kernels<word_type>::find_not(_words + index + 1, end, 0);
+					if (found == end)
+						return _size;
+					index = static_cast<size_type>(found - _words);
+					word = *found;
+				}
+				return index * word_bits + ft::lowest_bit(word);
+			}
+
+			template <int Operation>
+			vector& bitwise(const vector& x)
+			{
+				if (x._size != _size)
+					throw std::invalid_argument("vector<bool>: bitwise operation on vectors of different sizes");
+				ft::simd_kernels<word_type>::template bitwise<Operation>(_words, x._words, words_for(_size));
+				return *this;
+			}
+	};
+
+	template <class Alloc, class Growth>
+	const std::size_t vector<bool, Alloc, Growth>::word_bits;
+
+	//Compares the words, whose bits past the size are 0
+	template <class Alloc, class Growth>
+	bool operator== (const vector<bool, Alloc, Growth>& lhs, const vector<bool, Alloc, Growth>& rhs)
+	{
+		std::size_t words = lhs.size() / 64 + (lhs.size() % 64 != 0);
+		return lhs.size() == rhs.size() && ft::equal(lhs.words(), lhs.words() + words, rhs.words());
+	}
+
+	template <class Alloc, class Growth>
+	bool operator!= (const vector<bool, Alloc, Growth>& lhs, const vector<bool, Alloc, Growth>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+}
+
+#endif